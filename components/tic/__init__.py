@@ -0,0 +1,470 @@
+import logging
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor, switch, text_sensor, uart
+from esphome.const import (
+    CONF_BAUD_RATE,
+    CONF_ID,
+    CONF_MODE,
+    CONF_PORT,
+    CONF_RX_BUFFER_SIZE,
+    CONF_UART_ID,
+    CONF_UPDATE_INTERVAL,
+    DEVICE_CLASS_APPARENT_POWER,
+    DEVICE_CLASS_CURRENT,
+    DEVICE_CLASS_ENERGY,
+    DEVICE_CLASS_VOLTAGE,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_AMPERE,
+    UNIT_KILOVOLT_AMPS,
+    UNIT_KILOWATT_HOURS,
+    UNIT_MINUTE,
+    UNIT_VOLT,
+    UNIT_VOLT_AMPS,
+)
+from esphome.core import CORE, TimePeriod
+import esphome.final_validate as fv
+
+_LOGGER = logging.getLogger(__name__)
+
+AUTO_LOAD = ["sensor", "text_sensor", "switch"]
+MULTI_CONF = True
+
+CONF_TIC_ID = "tic_id"
+CONF_PHASES = "phases"
+CONF_RECEIVE = "receive"
+CONF_RAM_REPORT = "ram_report"
+
+teleinfo_ns = cg.global_ns.namespace("teleinfo")
+tic_ns = cg.esphome_ns.namespace("tic")
+TicMeter = tic_ns.class_("TicMeter", cg.PollingComponent, uart.UARTDevice)
+MyTicComponent = tic_ns.class_("MyTicComponent", TicMeter)
+TicReceiveSwitch = tic_ns.class_("TicReceiveSwitch", switch.Switch)
+TicLabel = tic_ns.enum("TicLabel", is_class=True)
+
+# traits du décodeur (tic_parser.h) et vitesse de la liaison pour chaque mode
+MODES = {
+    "historic": (teleinfo_ns.class_("Historique"), 1200),
+    "standard": (teleinfo_ns.class_("Standard"), 9600),
+    "auto": (teleinfo_ns.class_("Auto"), None),
+}
+
+
+def _texte(icon):
+    return text_sensor.text_sensor_schema(icon=icon)
+
+
+def _courant():
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_AMPERE,
+        icon="mdi:power-plug",
+        accuracy_decimals=0,
+        device_class=DEVICE_CLASS_CURRENT,
+        state_class=STATE_CLASS_MEASUREMENT,
+    )
+
+
+def _tension():
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_VOLT,
+        accuracy_decimals=0,
+        device_class=DEVICE_CLASS_VOLTAGE,
+        state_class=STATE_CLASS_MEASUREMENT,
+    )
+
+
+def _puissance(unit=UNIT_VOLT_AMPS):
+    return sensor.sensor_schema(
+        unit_of_measurement=unit,
+        icon="mdi:power-plug",
+        accuracy_decimals=0,
+        device_class=DEVICE_CLASS_APPARENT_POWER,
+        state_class=STATE_CLASS_MEASUREMENT,
+    )
+
+
+def _index():
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        icon="mdi:home-analytics",
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    )
+
+
+def _nombre(icon, unit=None):
+    if unit is None:
+        return sensor.sensor_schema(icon=icon, accuracy_decimals=0)
+    return sensor.sensor_schema(unit_of_measurement=unit, icon=icon, accuracy_decimals=0)
+
+
+# étiquettes connues, dans le même ordre que l'enum teleinfo::Label de tic_parser.h
+TIC_LABELS = {
+    # mode historique
+    "ADCO": _texte("mdi:card-account-details"),
+    "OPTARIF": _texte("mdi:tag"),
+    "ISOUSC": _courant(),
+    "BASE": _index(),
+    "HCHC": _index(),
+    "HCHP": _index(),
+    "EJPHN": _index(),
+    "EJPHPM": _index(),
+    "BBRHCJB": _index(),
+    "BBRHPJB": _index(),
+    "BBRHCJW": _index(),
+    "BBRHPJW": _index(),
+    "BBRHCJR": _index(),
+    "BBRHPJR": _index(),
+    "PEJP": _nombre("mdi:timer-sand", UNIT_MINUTE),
+    "PTEC": _texte("mdi:clock-outline"),
+    "DEMAIN": _texte("mdi:calendar"),
+    "IINST": _courant(),
+    "IINST1": _courant(),
+    "IINST2": _courant(),
+    "IINST3": _courant(),
+    "ADPS": _courant(),
+    "ADIR1": _courant(),
+    "ADIR2": _courant(),
+    "ADIR3": _courant(),
+    "IMAX": _courant(),
+    "IMAX1": _courant(),
+    "IMAX2": _courant(),
+    "IMAX3": _courant(),
+    "PMAX": _puissance(),
+    "PAPP": _puissance(),
+    "HHPHC": _texte("mdi:clock-outline"),
+    "MOTDETAT": _texte("mdi:information-outline"),
+    "PPOT": _texte("mdi:sine-wave"),
+    # mode standard
+    "ADSC": _texte("mdi:card-account-details"),
+    "NGTF": _texte("mdi:tag"),
+    "LTARF": _texte("mdi:clock-outline"),
+    "EAST": _index(),
+    "EASF01": _index(),
+    "EASF02": _index(),
+    "EASF03": _index(),
+    "EASF04": _index(),
+    "EASF05": _index(),
+    "EASF06": _index(),
+    "EAIT": _index(),
+    "IRMS1": _courant(),
+    "IRMS2": _courant(),
+    "IRMS3": _courant(),
+    "URMS1": _tension(),
+    "URMS2": _tension(),
+    "URMS3": _tension(),
+    "PREF": _puissance(UNIT_KILOVOLT_AMPS),
+    "PCOUP": _puissance(UNIT_KILOVOLT_AMPS),
+    "SINSTS": _puissance(),
+    "SINSTS1": _puissance(),
+    "SINSTS2": _puissance(),
+    "SINSTS3": _puissance(),
+    "SINSTI": _puissance(),
+    "NTARF": _nombre("mdi:numeric"),
+    "STGE": _texte("mdi:list-status"),
+    # ajoutées après STGE : les numéros d'étiquette sont enregistrés
+    "EASF07": _index(),
+    "EASF08": _index(),
+    "EASF09": _index(),
+    "EASF10": _index(),
+}
+TIC_TEXT_LABELS = {
+    "ADCO", "OPTARIF", "PTEC", "DEMAIN", "HHPHC", "MOTDETAT", "PPOT",
+    "ADSC", "NGTF", "LTARF", "STGE",
+}  # fmt: skip
+
+INDEX_HISTORIQUE = {
+    "BASE", "HCHC", "HCHP", "EJPHN", "EJPHPM",
+    "BBRHCJB", "BBRHPJB", "BBRHCJW", "BBRHPJW", "BBRHCJR", "BBRHPJR",
+}  # fmt: skip
+
+# tables des étiquettes de chaque mode, cf. Historique<>/Standard<> de tic_parser.h
+HISTORIQUE = INDEX_HISTORIQUE | {
+    "ADCO", "OPTARIF", "ISOUSC", "PEJP", "PTEC", "DEMAIN", "PAPP", "HHPHC", "MOTDETAT",
+}  # fmt: skip
+HISTORIQUE_MONO = {"IINST", "ADPS", "IMAX"}
+HISTORIQUE_TRI = {
+    "IINST1", "IINST2", "IINST3", "ADIR1", "ADIR2", "ADIR3",
+    "IMAX1", "IMAX2", "IMAX3", "PMAX", "PPOT",
+}  # fmt: skip
+STANDARD = {
+    "ADSC", "NGTF", "LTARF", "EAST", "EASF01", "EASF02", "EASF03", "EASF04",
+    "EASF05", "EASF06", "EASF07", "EASF08", "EASF09", "EASF10", "EAIT",
+    "IRMS1", "URMS1", "PREF", "PCOUP",
+    "SINSTS", "SINSTI", "NTARF", "STGE",
+}  # fmt: skip
+STANDARD_TRI = {"IRMS2", "IRMS3", "URMS2", "URMS3", "SINSTS1", "SINSTS2", "SINSTS3"}
+# intensité par phase, cf. Trame::intensite()
+INTENSITES = {"IINST", "IINST1", "IINST2", "IINST3", "IRMS1", "IRMS2", "IRMS3"}
+
+
+def mode_labels(mode, phases):
+    """Étiquettes émises par un compteur dans ce mode."""
+    historique = HISTORIQUE | (HISTORIQUE_MONO if phases == 1 else HISTORIQUE_TRI)
+    standard = STANDARD | (set() if phases == 1 else STANDARD_TRI)
+    if mode == "historic":
+        return historique
+    if mode == "standard":
+        return standard
+    return historique | standard
+
+
+def label_mask(labels):
+    mask = 0
+    for label in labels:
+        mask |= 1 << list(TIC_LABELS).index(label)
+    return mask
+
+
+def static_variable(id_, type_):
+    """Déclare l'objet en mémoire statique plutôt que sur le tas et retourne son pointeur."""
+    storage = f"{id_.id}__storage"
+    cg.add_global(cg.RawStatement(f"static {type_} {storage};"))
+    return cg.Pvariable(id_, cg.RawExpression(f"&{storage}"), type_)
+
+
+def _net_labels(hub_id):
+    """Étiquettes à décoder pour les agrégations tic_net qui utilisent ce compteur."""
+    labels = set()
+    for conf in CORE.config.get("tic_net", []):
+        if conf["consumer_id"].id == hub_id.id:
+            labels |= {"PAPP", "SINSTS", "EAST"} | INDEX_HISTORIQUE
+        if conf["producer_id"].id == hub_id.id:
+            labels |= {"SINSTI", "EAIT"}
+    return labels
+
+
+def _history_labels(hub_id):
+    """Étiquettes à décoder pour les historiques tic_history, tic_series, tic_log et tic_load_curve de ce compteur."""
+    labels = set()
+    for conf in CORE.config.get("tic_history", []):
+        if conf[CONF_TIC_ID].id == hub_id.id:
+            labels |= {"PAPP", "SINSTS"} | INTENSITES
+    for conf in CORE.config.get("tic_load_curve", []):
+        if conf[CONF_TIC_ID].id == hub_id.id:
+            labels |= {"EAST"} | INDEX_HISTORIQUE
+    for domain in ("tic_series", "tic_log"):
+        for conf in CORE.config.get(domain, []):
+            if conf[CONF_TIC_ID].id == hub_id.id:
+                labels |= set(conf["labels"])
+    return labels
+
+
+def _cost_labels(hub_id):
+    """Étiquettes à décoder pour les coûts tic_cost de ce compteur : index, période en cours
+    (PTEC, NTARF et LTARF) et couleurs Tempo (DEMAIN, STGE)."""
+    labels = set()
+    for conf in CORE.config.get("tic_cost", []):
+        if conf[CONF_TIC_ID].id == hub_id.id:
+            labels |= {"PTEC", "DEMAIN", "NTARF", "LTARF", "STGE"}
+            labels |= {p["label"] for p in conf["prices"]}
+    return labels
+
+
+def _overload_labels(hub_id):
+    """Étiquettes à décoder pour le délestage tic_shedding et la prévision tic_overload."""
+    labels = set()
+    for conf in CORE.config.get("tic_shedding", []):
+        if conf[CONF_TIC_ID].id == hub_id.id:
+            labels |= {"ADPS", "ADIR1", "ADIR2", "ADIR3", "STGE", "ISOUSC", "PREF"} | INTENSITES
+    for conf in CORE.config.get("tic_overload", []):
+        if conf[CONF_TIC_ID].id == hub_id.id:
+            labels |= {"ISOUSC", "PREF", "PAPP", "SINSTS"} | INTENSITES
+    return labels
+
+
+def _validate_labels(config):
+    table = mode_labels(config[CONF_MODE], config[CONF_PHASES])
+    for label in TIC_LABELS:
+        if label.lower() in config and label not in table:
+            raise cv.Invalid(
+                f"{label} n'est pas émise en mode {config[CONF_MODE]} "
+                f"({config[CONF_PHASES]} phase(s))",
+                path=[label.lower()],
+            )
+    return config
+
+
+def _validate_link(config):
+    """uart sur ESP, port série (tty ou pseudo-terminal) sur la plateforme host."""
+    if not CORE.is_host:
+        if CONF_PORT in config or CONF_BAUD_RATE in config:
+            raise cv.Invalid("port et baud_rate ne sont disponibles que sur la plateforme host")
+        return uart.UART_DEVICE_SCHEMA.extend({}, extra=cv.ALLOW_EXTRA)(config)
+    if CONF_PORT not in config:
+        raise cv.Invalid("port requis sur la plateforme host", path=[CONF_PORT])
+    if CONF_BAUD_RATE not in config:
+        if MODES[config[CONF_MODE]][1] is None:
+            raise cv.Invalid("baud_rate requis en mode auto", path=[CONF_BAUD_RATE])
+        config[CONF_BAUD_RATE] = MODES[config[CONF_MODE]][1]
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(MyTicComponent),
+            cv.Optional(CONF_MODE, default="historic"): cv.one_of(*MODES, lower=True),
+            cv.Optional(CONF_PHASES, default=1): cv.one_of(1, 3, int=True),
+            cv.Optional(CONF_RECEIVE): switch.switch_schema(TicReceiveSwitch),
+            cv.Optional(CONF_RAM_REPORT, default=False): cv.boolean,
+            # plateforme host uniquement
+            cv.Optional(CONF_PORT): cv.string_strict,
+            cv.Optional(CONF_BAUD_RATE): cv.one_of(1200, 9600, int=True),
+        }
+    )
+    .extend(
+        {cv.Optional(label.lower()): schema for label, schema in TIC_LABELS.items()}
+    )
+    .extend(cv.polling_component_schema("1s"))
+    .extend({cv.Optional(CONF_UART_ID): cv.use_id(uart.UARTComponent)}),
+    _validate_labels,
+    _validate_link,
+)
+
+
+def _check_rx_buffer(config):
+    """Le tampon de l'uart doit contenir tout ce qui arrive entre deux update() (cf. tools/tic_sim)."""
+    full_config = fv.full_config.get()
+    path = full_config.get_path_for_id(config[CONF_UART_ID])[:-1]
+    uart_config = full_config.get_config_for_path(path)
+    interval = config[CONF_UPDATE_INTERVAL]
+    if not isinstance(interval, TimePeriod):  # never
+        return
+    needed = uart_config[CONF_BAUD_RATE] // 10 * interval.total_milliseconds // 1000
+    if uart_config[CONF_RX_BUFFER_SIZE] < needed:
+        _LOGGER.warning(
+            "tic %s : %s octets reçus entre deux update() pour un rx_buffer_size de %s, "
+            "des octets seront perdus (augmenter rx_buffer_size ou réduire update_interval)",
+            config[CONF_ID],
+            needed,
+            uart_config[CONF_RX_BUFFER_SIZE],
+        )
+
+
+def _final_validate(config):
+    if CORE.is_host:
+        return config
+    config = uart.final_validate_device_schema(
+        "tic",
+        baud_rate=MODES[config[CONF_MODE]][1],
+        require_rx=True,
+        parity="EVEN",
+        data_bits=7,
+    )(config)
+    _check_rx_buffer(config)
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
+
+# tailles d'une teleinfo::Trame (tic_parser.h) pour le rapport RAM, vérifiées par static_assert
+# dans le code généré : valeur numérique (uint32_t), texte (TAILLE_TEXTE + 1), deux copies de la
+# trame par compteur (double tampon de TicFrame)
+TAILLE_VALEUR = 4
+TAILLE_TEXTE = 16 + 1
+COPIES_TRAME = 2
+
+
+def _taille_trame(labels):
+    """sizeof(teleinfo::Trame) : deux masques 64 bits, les valeurs puis les textes, aligné sur 8."""
+    valeurs = max(len(labels - TIC_TEXT_LABELS), 1)
+    textes = max(len(labels & TIC_TEXT_LABELS), 1)
+    return (16 + valeurs * TAILLE_VALEUR + textes * TAILLE_TEXTE + 7) // 8 * 8
+
+
+def _rapport_ram(config, labels, sensors, all_labels):
+    """Coût en RAM de chaque étiquette gardée dans les trames de ce compteur, affiché par
+    esphome compile (ram_report: true)."""
+    trame = _taille_trame(all_labels)
+    _LOGGER.info("tic %s : RAM par étiquette", config[CONF_ID])
+    for label in TIC_LABELS:
+        if label not in all_labels:
+            continue
+        taille = TAILLE_TEXTE if label in TIC_TEXT_LABELS else TAILLE_VALEUR
+        if label in sensors:
+            capteur = "text_sensor" if label in TIC_TEXT_LABELS else "sensor"
+        else:
+            capteur = "décodée" if label in labels else "autre compteur"
+        _LOGGER.info(
+            "  %-8s trame %s x %2s octets, %s", label, COPIES_TRAME, taille, capteur
+        )
+    _LOGGER.info(
+        "  Trame %s octets, TicFrame %s octets (x%s) ; %s capteurs, %s capteurs texte "
+        "(tailles dans le log de démarrage)",
+        trame,
+        trame + 8,
+        COPIES_TRAME,
+        len(set(sensors) - TIC_TEXT_LABELS),
+        len(set(sensors) & TIC_TEXT_LABELS),
+    )
+    # le rapport suit les templates : la compilation échoue s'ils changent sans lui
+    message = '"rapport RAM de tic/__init__.py à mettre à jour"'
+    cg.add_global(
+        cg.RawStatement(f"static_assert(sizeof(teleinfo::Trame) == {trame}, {message});")
+    )
+    cg.add_global(
+        cg.RawStatement(
+            f"static_assert(sizeof(esphome::tic::TicFrame) == {trame + 8}, {message});"
+        )
+    )
+
+
+def _sensor_labels(config):
+    return [label for label in TIC_LABELS if label.lower() in config]
+
+
+def _decoded_labels(config):
+    """Étiquettes décodées par un compteur : capteurs déclarés et besoins des autres composants."""
+    table = mode_labels(config[CONF_MODE], config[CONF_PHASES])
+    extra = (
+        _net_labels(config[CONF_ID])
+        | _history_labels(config[CONF_ID])
+        | _cost_labels(config[CONF_ID])
+        | _overload_labels(config[CONF_ID])
+    )
+    return set(_sensor_labels(config)) | (extra & table)
+
+
+async def to_code(config):
+    sensors = _sensor_labels(config)
+    labels = _decoded_labels(config)
+    # une Trame (tic_parser.h) ne garde que les étiquettes décodées par l'un des compteurs
+    all_labels = set().union(*(_decoded_labels(conf) for conf in CORE.config["tic"]))
+    cg.add_define("TIC_ETIQUETTES", f"0x{label_mask(all_labels):X}ULL")
+
+    traits, _ = MODES[config[CONF_MODE]]
+    type_ = MyTicComponent.template(
+        traits.template(config[CONF_PHASES]),
+        cg.RawExpression(f"0x{label_mask(labels):X}ULL"),
+        cg.RawExpression(f"0x{label_mask(sensors):X}ULL"),
+    )
+    var = static_variable(config[CONF_ID], type_)
+    await cg.register_component(var, config)
+    if CORE.is_host:
+        cg.add(var.set_port(config[CONF_PORT], config[CONF_BAUD_RATE]))
+    else:
+        await uart.register_uart_device(var, config)
+
+    if CONF_RECEIVE in config:
+        conf = config[CONF_RECEIVE]
+        sw = cg.Pvariable(conf[CONF_ID], var.get_receive_switch())
+        await switch.register_switch(sw, conf)
+
+    # les capteurs sont ceux alloués dans le composant, pas de new
+    for label in sensors:
+        conf = config[label.lower()]
+        if label in TIC_TEXT_LABELS:
+            sens = cg.Pvariable(conf[CONF_ID], var.get_text_sensor(getattr(TicLabel, label)))
+            await text_sensor.register_text_sensor(sens, conf)
+        else:
+            sens = cg.Pvariable(conf[CONF_ID], var.get_sensor(getattr(TicLabel, label)))
+            await sensor.register_sensor(sens, conf)
+
+    if config[CONF_RAM_REPORT]:
+        cg.add_define("TIC_RAPPORT_RAM")
+        _rapport_ram(config, labels, sensors, all_labels)
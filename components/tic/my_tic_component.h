@@ -0,0 +1,408 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+#include "tic_capture.h"
+#include "tic_parser.h"
+#include "tic_serial.h"
+#include "tic_snapshot.h"
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#ifndef USE_HOST
+#include "esphome/components/uart/uart.h"
+#endif
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/text_sensor/text_sensor.h"
+#include "esphome/components/switch/switch.h"
+
+namespace esphome {
+namespace tic {
+
+// étiquettes du décodeur, cf. TIC_LABELS de __init__.py
+using TicLabel = teleinfo::Label;
+
+// position d'une étiquette parmi celles d'un masque = indice de son capteur
+constexpr uint8_t tic_rank(uint64_t mask, TicLabel label) { return __builtin_popcountll(mask & (teleinfo::bit(label) - 1)); }
+
+class TicMeter;
+
+// dernière trame complète d'un compteur, cf. TicMeter::get_frame()
+struct TicFrame {
+	uint32_t millis = 0;	// instant de réception de l'ETX
+	uint32_t numero = 0;	// trames complètes reçues depuis le démarrage
+	teleinfo::Trame trame;
+};
+
+// millis() prolongé à 64 bits, pour les historiques de plus de 49 jours
+struct TicHorloge {
+	uint64_t ms = 0;
+	uint32_t dernier = 0;
+
+	uint64_t prolonger(uint32_t maintenant)
+	{
+		ms += maintenant - dernier;
+		dernier = maintenant;
+		return ms;
+	}
+};
+
+// switch permettant de stopper les mises à jour
+class TicReceiveSwitch : public switch_::Switch {
+ public:
+	explicit TicReceiveSwitch(TicMeter *parent) : parent_(parent) {}
+
+ protected:
+	void write_state(bool state) override;
+
+	TicMeter *parent_;
+};
+
+#ifdef USE_HOST
+using TicLiaison = TicSerial;
+#else
+using TicLiaison = uart::UARTDevice;
+#endif
+
+// Partie commune à tous les compteurs : réception UART, valeurs de la trame et switch.
+// Le décodage lui-même est dans tic_parser.h, indépendant du framework (Arduino, ESP-IDF ou host).
+class TicMeter : public PollingComponent, public TicLiaison {
+ public:
+	TicMeter() : PollingComponent(1000) {}
+
+	bool enable = true;
+
+	// valeurs de la trame en cours de réception : partiellement mise à jour, à ne pas lire
+	// depuis une lambda ou un autre composant, qui utilisent get_frame()
+	const teleinfo::Trame &trame() const { return en_cours_->trame; }
+
+	TicReceiveSwitch *get_receive_switch() { return &receive_switch_; }
+	// enregistrement des octets reçus, cf. tic_capture
+	void set_capture(teleinfo::capture::Anneau *anneau) { capture_ = anneau; }
+	// appelé à chaque trame complète, dans update() : historiques (tic_history, tic_series)
+	void add_on_frame_callback(std::function<void(const TicFrame &)> &&callback)
+	{
+		frame_callback_.add(std::move(callback));
+	}
+	// appelé dès le décodage d'un groupe qui signale un dépassement (ADPS, ADIRn, STGE), sans
+	// attendre la fin de la trame : délestage (tic_shedding). trame() contient déjà sa valeur ;
+	// lecture_us : micros() à la lecture dans l'UART des derniers octets du groupe.
+	void add_on_overload_callback(std::function<void(TicLabel, uint32_t)> &&callback)
+	{
+		overload_callback_.add(std::move(callback));
+	}
+
+	void setup() override {
+#ifdef USE_HOST
+		ouvrir();
+		rapport_ = millis();
+#endif
+		receive_switch_.publish_state(enable);
+	}
+
+	// vide le tampon de l'UART : toutes les trames reçues depuis le dernier appel sont traitées
+	void update() override {
+#ifdef USE_HOST
+		uint32_t debut = micros();
+		int attente = available();
+#endif
+		uint8_t buff[64];
+		int n;
+		// tampon plein : des octets ont pu être perdus avant ceux-ci
+		uint8_t drapeaux = capture_ != nullptr && tampon_plein(available()) ? teleinfo::capture::TAMPON_PLEIN : 0;
+		while ((n = available()) > 0)
+		{
+			size_t len = n < (int) sizeof(buff) ? n : sizeof(buff);
+			if (!read_array(buff, len))
+			{
+				if (capture_ != nullptr)
+					capture_->enregistrer(micros(), buff, 0, drapeaux | teleinfo::capture::ECHEC_LECTURE);
+				break;
+			}
+			lecture_us_ = micros();
+			// copie du paquet avant décodage, quelques µs
+			if (capture_ != nullptr)
+				capture_->enregistrer(lecture_us_, buff, len, drapeaux | (enable ? 0 : teleinfo::capture::RECEPTION_COUPEE));
+			drapeaux = 0;
+			if (enable)
+				processBytes(buff, len);
+		}
+#ifdef USE_HOST
+		mesurer(attente, micros() - debut);
+#endif
+	}
+
+	// l'assemblage et le décodage dépendent du mode et des étiquettes déclarées, cf. MyTicComponent
+	virtual void processBytes(const uint8_t *data, size_t len) = 0;
+	virtual const teleinfo::Statistiques &get_stats() const = 0;
+
+	// publie la trame décodée dans la copie ouverte de frame_ et ouvre l'autre copie, qui reçoit la
+	// trame suivante (une seule copie de trame par trame)
+	void endFrame()
+	{
+		numero_++;
+		TicFrame &f = *en_cours_;
+		f.millis = millis();
+		f.numero = numero_;
+		frame_.publier();
+		frame_callback_.call(f);
+		en_cours_ = &frame_.ouvrir();
+	}
+
+	// Copie cohérente de la dernière trame complète, lisible à tout moment (lambda, autre composant,
+	// tâche de réception séparée) : jamais un mélange de deux trames ni une trame en cours.
+	// Retourne la génération de la copie, 0 si aucune trame n'a encore été reçue.
+	//   static tic::TicFrame f;
+	//   if (id(my_tic).get_frame(f) != 0) return f.trame.valeur(tic::TicLabel::PAPP);
+	uint32_t get_frame(TicFrame &frame) const { return frame_.lire(frame); }
+	// quelques valeurs de la dernière trame complète, sans la copier : f(const TicFrame &) ne fait
+	// que les recopier, il peut être rappelé (cf. Instantane::lire_en_place)
+	template<typename F>
+	uint32_t read_frame(F &&f) const { return frame_.lire_en_place(f); }
+	// change à chaque trame complète : permet de ne copier que les nouvelles trames
+	uint32_t frame_generation() const { return frame_.generation(); }
+
+ protected:
+#ifdef USE_HOST
+	bool tampon_plein(int) const { return false; }
+#else
+	bool tampon_plein(int attente) const { return attente > 0 && (size_t) attente >= parent_->get_rx_buffer_size(); }
+#endif
+
+#ifdef USE_HOST
+	// Mesures de la plateforme host, affichées chaque minute : le plus ancien octet en attente
+	// au début d'update() a été reçu il y a au plus attente * 10 bits / débit + update_interval.
+	void mesurer(int attente, uint32_t duree_us)
+	{
+		appels_++;
+		cpu_us_ += duree_us;
+		if (duree_us > cpu_max_us_)
+			cpu_max_us_ = duree_us;
+		if (attente > attente_max_)
+			attente_max_ = attente;
+		uint32_t maintenant = millis();
+		if (maintenant - rapport_ < 60000)
+			return;
+		const teleinfo::Statistiques &s = get_stats();
+		ESP_LOGI("tic", "%u trames, %u groupes, %u checksum, %u format, %u débordements ; "
+			"update() : %u appels, %u us en moyenne, %u us au plus, %d octets au plus en attente",
+			s.trames, s.groupes, s.erreurs_checksum, s.erreurs_format, s.debordements,
+			appels_, cpu_us_ / appels_, cpu_max_us_, attente_max_);
+		rapport_ = maintenant;
+		appels_ = cpu_us_ = cpu_max_us_ = 0;
+		attente_max_ = 0;
+	}
+
+	uint32_t rapport_ = 0;
+	uint32_t appels_ = 0;
+	uint32_t cpu_us_ = 0;
+	uint32_t cpu_max_us_ = 0;
+	int attente_max_ = 0;
+#endif
+
+	TicReceiveSwitch receive_switch_{this};
+	teleinfo::capture::Anneau *capture_ = nullptr;
+	// double tampon de la dernière trame complète, la trame en cours est décodée dans la copie ouverte
+	teleinfo::Instantane<TicFrame> frame_;
+	TicFrame *en_cours_ = &frame_.ouvrir();
+	uint32_t numero_ = 0;
+	CallbackManager<void(const TicFrame &)> frame_callback_;
+	CallbackManager<void(TicLabel, uint32_t)> overload_callback_;
+	uint32_t lecture_us_ = 0;	// micros() à la lecture du paquet en cours de décodage
+};
+
+inline void TicReceiveSwitch::write_state(bool state)
+{
+	parent_->enable = state;
+	publish_state(state);
+}
+
+// Compteur spécialisé à la compilation par la génération de code (__init__.py) :
+//  - MODE : teleinfo::Historique<PHASES>, teleinfo::Standard<PHASES> ou teleinfo::Auto<PHASES>
+//  - LABELS : étiquettes décodées (capteurs déclarés + besoins de l'agrégation)
+//  - SENSORS : étiquettes publiées, un capteur alloué statiquement par étiquette
+// Les étiquettes absentes des masques ne génèrent ni code de décodage ni capteur.
+template<typename MODE, uint64_t LABELS, uint64_t SENSORS>
+class MyTicComponent : public TicMeter {
+ public:
+	static constexpr uint64_t NUM_SENSORS = SENSORS & ~teleinfo::TEXTES;
+	static constexpr uint64_t TEXT_SENSORS = SENSORS & teleinfo::TEXTES;
+	static_assert((SENSORS & ~LABELS) == 0, "une étiquette publiée doit être décodée");
+	static_assert((LABELS & ~MODE::ETIQUETTES) == 0, "étiquette absente de ce mode");
+
+	sensor::Sensor *get_sensor(TicLabel label) { return &sensors_[tic_rank(NUM_SENSORS, label)]; }
+	text_sensor::TextSensor *get_text_sensor(TicLabel label) { return &text_sensors_[tic_rank(TEXT_SENSORS, label)]; }
+
+	// Avec "ram_report: true", la génération de code affiche le coût de chaque étiquette dans la
+	// trame ; seules les tailles des capteurs d'ESPHome dépendent de sa version et de la cible
+	void dump_config() override {
+		ESP_LOGCONFIG("tic", "compteur TIC : %u étiquettes décodées, %u publiées", (unsigned) __builtin_popcountll(LABELS),
+			(unsigned) __builtin_popcountll(SENSORS));
+#ifdef TIC_RAPPORT_RAM
+		ESP_LOGCONFIG("tic", "  capteur %u octets, capteur texte %u octets, composant %u octets",
+			(unsigned) sizeof(sensor::Sensor), (unsigned) sizeof(text_sensor::TextSensor), (unsigned) sizeof(*this));
+#endif
+	}
+
+	void processBytes(const uint8_t *data, size_t len) override {
+		lecteur_.pousser(data, len, [this](teleinfo::Evenement e, const teleinfo::Groupe &groupe, bool change) {
+			switch (e)
+			{
+				case teleinfo::Evenement::GROUPE:
+					if constexpr ((LABELS & teleinfo::DEPASSEMENTS) != 0)
+					{
+						if (teleinfo::signale_depassement(groupe))
+							overload_callback_.call(groupe.etiquette, lecture_us_);
+					}
+					if (change)
+						processCommand(groupe);
+					break;
+				case teleinfo::Evenement::FIN_TRAME:
+					endFrame();
+					lecteur_.cibler(en_cours_->trame);
+					break;
+				case teleinfo::Evenement::INVALIDE:
+					ESP_LOGW("tic", "groupe invalide : %.*s", (int) lecteur_.taille(), lecteur_.tampon());
+					break;
+				case teleinfo::Evenement::DEBORDEMENT:
+					ESP_LOGW("tic", "groupe trop long, ignoré");
+					break;
+				default:
+					break;
+			}
+		});
+	}
+
+	const teleinfo::Statistiques &get_stats() const override { return lecteur_.stats; }
+
+	void processCommand(const teleinfo::Groupe &groupe)
+	{
+		ESP_LOGD("tic", "tic_etiquette %s", teleinfo::NOMS[static_cast<uint8_t>(groupe.etiquette)]);
+		ESP_LOGD("tic", "tic_value %.*s", groupe.valeur_len, groupe.valeur);
+		dispatch(groupe, std::make_index_sequence<teleinfo::NB_ETIQUETTES>{});
+	}
+
+ protected:
+	// le décodeur ne renvoie que des étiquettes de LABELS : publish() n'est instancié que pour elles
+	template<size_t... I>
+	void dispatch(const teleinfo::Groupe &groupe, std::index_sequence<I...>)
+	{
+		((groupe.etiquette == static_cast<TicLabel>(I) && (publish<static_cast<TicLabel>(I)>(), true)) || ...);
+	}
+
+	// valeur déjà mémorisée par le lecteur, publiée seulement si elle a changé
+	template<TicLabel L>
+	void publish()
+	{
+		if constexpr ((LABELS & teleinfo::bit(L)) != 0)
+		{
+			if constexpr ((TEXT_SENSORS & teleinfo::bit(L)) != 0)
+				text_sensors_[tic_rank(TEXT_SENSORS, L)].publish_state(en_cours_->trame.texte(L));
+			else if constexpr ((NUM_SENSORS & teleinfo::bit(L)) != 0)
+			{
+				float v = en_cours_->trame.valeur(L);
+				sensors_[tic_rank(NUM_SENSORS, L)].publish_state((teleinfo::INDEX & teleinfo::bit(L)) ? v / 1000.0 : v);
+			}
+		}
+	}
+
+	teleinfo::Lecteur<MODE, LABELS> lecteur_{en_cours_->trame};
+	std::array<sensor::Sensor, __builtin_popcountll(NUM_SENSORS)> sensors_;
+	std::array<text_sensor::TextSensor, __builtin_popcountll(TEXT_SENSORS)> text_sensors_;
+};
+
+// Agrégation d'un compteur de consommation et d'un compteur de production :
+// puissance et énergie nettes (soutirage - injection), publiées au plus une fois par intervalle.
+// Seules les valeurs agrégées sont lues dans la dernière trame de chaque compteur ; quand l'une
+// des deux date de plus de age_max, les valeurs nettes passent à NAN (indisponibles).
+class MyTicAggregator : public PollingComponent {
+ public:
+	MyTicAggregator() : PollingComponent(5000) {}
+
+	sensor::Sensor sensor_puissance_nette;
+	sensor::Sensor sensor_energie_nette;
+
+	// écart maximum entre les trames des deux compteurs (une trame dure ~1.5s à 1200 bauds)
+	uint32_t ecart_max = 2000;
+	// âge maximum de la dernière trame de chaque compteur
+	uint32_t age_max = 10000;
+
+	float puissance_nette = NAN;
+	float energie_nette = NAN;
+
+	void set_compteurs(TicMeter *consommation, TicMeter *production)
+	{
+		conso = consommation;
+		prod = production;
+	}
+	void set_ecart_max(uint32_t ecart) { ecart_max = ecart; }
+	void set_age_max(uint32_t age) { age_max = age; }
+	sensor::Sensor *get_puissance_sensor() { return &sensor_puissance_nette; }
+	sensor::Sensor *get_energie_sensor() { return &sensor_energie_nette; }
+
+	void update() override {
+		// un compteur bidirectionnel peut être à la fois consommation et production
+		Mesure c, p;
+		bool lues = conso->read_frame([&c](const TicFrame &f) {
+			c = {f.millis, f.trame.puissance_soutiree(), f.trame.energie_soutiree()};
+		}) != 0 && prod->read_frame([&p](const TicFrame &f) {
+			p = {f.millis, f.trame.puissance_injectee(), f.trame.energie_injectee()};
+		}) != 0;
+		if (!lues)
+			return;
+
+		uint32_t maintenant = millis();
+		if (maintenant - c.millis > age_max || maintenant - p.millis > age_max)
+		{
+			if (!std::isnan(puissance_nette) || !std::isnan(energie_nette))
+			{
+				ESP_LOGW("tic", "trames de plus de %u ms, agrégation suspendue", age_max);
+				publier(NAN, NAN);
+			}
+			return;
+		}
+
+		// on n'agrège que des trames reçues à moins d'une trame d'écart
+		uint32_t ecart = c.millis > p.millis ? c.millis - p.millis : p.millis - c.millis;
+		if (ecart > ecart_max)
+		{
+			ESP_LOGD("tic", "trames non alignées (%u ms), agrégation ignorée", ecart);
+			return;
+		}
+
+		publier((float) ((int32_t) c.puissance - (int32_t) p.puissance), (float) ((int64_t) c.energie - (int64_t) p.energie));
+	}
+
+ protected:
+	// valeurs d'une trame utiles à l'agrégation
+	struct Mesure {
+		uint32_t millis;
+		uint32_t puissance;
+		uint32_t energie;
+	};
+
+	void publier(float puissance, float energie)
+	{
+		if (puissance != puissance_nette)
+		{
+			sensor_puissance_nette.publish_state(puissance);
+			puissance_nette = puissance;
+		}
+		if (energie != energie_nette)
+		{
+			sensor_energie_nette.publish_state(energie / 1000.0);
+			energie_nette = energie;
+		}
+	}
+
+	TicMeter *conso = nullptr;
+	TicMeter *prod = nullptr;
+};
+
+}  // namespace tic
+}  // namespace esphome
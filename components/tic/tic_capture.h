@@ -0,0 +1,239 @@
+#pragma once
+
+// Capture horodatée de la liaison TIC (fichiers .ticc) : les octets tels que lus par update(),
+// par paquets, avec l'instant de lecture en µs et les anomalies de réception. Enregistrée sur
+// l'ESP par tic_capture (anneau en RAM, téléchargeable par web_server), rejouée sur PC par
+// tools/tic_replay avec sa chronologie d'origine.
+//
+// en-tête { "TICR", version, bauds, référence (µs) } puis des enregistrements :
+//   { écart en µs depuis l'enregistrement précédent (la référence pour le premier), varint
+//     longueur (0 à 127) | 0x80 si des drapeaux suivent
+//     [drapeaux]
+//     octets }
+// Un paquet de 64 octets coûte 2 à 4 octets d'en-tête, environ 5 % de plus que les octets reçus :
+// un anneau de 64 ko garde 9 minutes de liaison historique, 1 minute en standard.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace teleinfo {
+namespace capture {
+
+constexpr uint32_t MAGIE = 0x52434954;	// "TICR"
+constexpr uint16_t VERSION = 1;
+constexpr size_t LONGUEUR_MAX = 127;
+// écart varint (5) + longueur + drapeaux + octets
+constexpr size_t ENREGISTREMENT_MAX = 5 + 1 + 1 + LONGUEUR_MAX;
+
+struct Entete {
+	uint32_t magie;
+	uint16_t version;
+	uint16_t bauds;
+	uint64_t reference_us;
+};
+
+// anomalies constatées par update() au moment de la lecture du paquet
+enum Drapeau : uint8_t {
+	TAMPON_PLEIN = 1 << 0,		// le tampon de réception de l'UART était plein : octets perdus avant ce paquet
+	ECHEC_LECTURE = 1 << 1,		// read_array() a échoué (paquet vide)
+	PERTE = 1 << 2,				// paquets non enregistrés avant celui-ci (téléchargement en cours)
+	RECEPTION_COUPEE = 1 << 3,	// switch receive éteint : paquet non décodé
+};
+
+struct Enregistrement {
+	uint32_t ecart_us = 0;
+	uint8_t drapeaux = 0;
+	uint8_t longueur = 0;
+	const uint8_t *octets = nullptr;
+};
+
+// lecture séquentielle d'une capture en mémoire ; false à la fin ou sur un enregistrement tronqué
+inline bool lire(const uint8_t *&p, const uint8_t *fin, Enregistrement &e)
+{
+	const uint8_t *q = p;
+	uint32_t ecart = 0;
+	for (int decalage = 0;; decalage += 7)
+	{
+		if (q == fin || decalage > 28)
+			return false;
+		uint8_t o = *q++;
+		ecart |= uint32_t(o & 0x7F) << decalage;
+		if (!(o & 0x80))
+			break;
+	}
+	if (q == fin)
+		return false;
+	uint8_t l = *q++;
+	e.drapeaux = 0;
+	if (l & 0x80)
+	{
+		if (q == fin)
+			return false;
+		e.drapeaux = *q++;
+	}
+	e.ecart_us = ecart;
+	e.longueur = l & 0x7F;
+	if (static_cast<size_t>(fin - q) < e.longueur)
+		return false;
+	e.octets = q;
+	p = q + e.longueur;
+	return true;
+}
+
+// Enregistreur en anneau dans une zone fournie par l'appelant (tableau statique, PSRAM) : les
+// plus anciens enregistrements sont écrasés. Écrivain unique (update()), l'exportation se fait
+// entre geler() et degeler(), éventuellement depuis une autre tâche (serveur web de l'ESP32) :
+// pendant ce temps les paquets ne sont pas enregistrés et le suivant porte le drapeau PERTE.
+class Anneau {
+ public:
+	void attribuer(uint8_t *zone, size_t taille, uint16_t bauds)
+	{
+		zone_ = zone;
+		capacite_ = taille;
+		bauds_ = bauds;
+	}
+
+	bool actif() const { return zone_ != nullptr && capacite_ >= ENREGISTREMENT_MAX; }
+
+	// maintenant_us : micros() (32 bits, prolongé ici à 64 bits) ; un paquet de plus de
+	// LONGUEUR_MAX octets occupe plusieurs enregistrements
+	void enregistrer(uint32_t maintenant_us, const uint8_t *data, size_t len, uint8_t drapeaux)
+	{
+		ecriture_.store(true);
+		if (gele_.load() || !actif())
+		{
+			perte_ = true;
+			ecriture_.store(false);
+			return;
+		}
+		if (perte_)
+			drapeaux |= PERTE;
+		perte_ = false;
+		horloge_us_ += maintenant_us - dernier_us_;
+		dernier_us_ = maintenant_us;
+		// plus de 71 minutes sans paquet : écart tronqué
+		uint64_t e = horloge_us_ - precedent_us_;
+		uint32_t ecart = e < UINT32_MAX ? static_cast<uint32_t>(e) : UINT32_MAX;
+		if (taille_ == 0)
+		{
+			reference_us_ = horloge_us_;
+			ecart = 0;
+		}
+		precedent_us_ = horloge_us_;
+		do
+		{
+			size_t n = len < LONGUEUR_MAX ? len : LONGUEUR_MAX;
+			uint8_t entete[7];
+			size_t t = 0;
+			for (; ecart >= 0x80; ecart >>= 7)
+				entete[t++] = static_cast<uint8_t>(ecart | 0x80);
+			entete[t++] = static_cast<uint8_t>(ecart);
+			entete[t++] = static_cast<uint8_t>(n | (drapeaux != 0 ? 0x80 : 0));
+			if (drapeaux != 0)
+				entete[t++] = drapeaux;
+			liberer(t + n);
+			poser(entete, t);
+			poser(data, n);
+			data += n;
+			len -= n;
+			ecart = 0;
+			drapeaux = 0;
+		} while (len != 0);
+		ecriture_.store(false);
+	}
+
+	// Exportation : true quand aucun enregistrement n'est en cours, à rappeler sinon (l'écrivain
+	// termine le sien en quelques µs). Le contenu ne bouge plus jusqu'à degeler().
+	bool geler()
+	{
+		gele_.store(true);
+		return !ecriture_.load();
+	}
+	void degeler() { gele_.store(false); }
+
+	// taille du fichier .ticc
+	size_t taille_export() const { return sizeof(Entete) + taille_; }
+
+	// copie la partie [position, position + taille) du fichier .ticc ; retourne la taille copiée
+	size_t exporter(uint8_t *dest, size_t taille, size_t position) const
+	{
+		size_t copie = 0;
+		if (position < sizeof(Entete))
+		{
+			Entete e = {MAGIE, VERSION, bauds_, reference_us_};
+			size_t n = sizeof(Entete) - position;
+			n = n < taille ? n : taille;
+			memcpy(dest, reinterpret_cast<const uint8_t *>(&e) + position, n);
+			copie = n;
+			position = sizeof(Entete);
+		}
+		size_t offset = position - sizeof(Entete);
+		while (copie < taille && offset < taille_)
+		{
+			size_t i = (debut_ + offset) % capacite_;
+			size_t n = capacite_ - i;
+			n = n < taille_ - offset ? n : taille_ - offset;
+			n = n < taille - copie ? n : taille - copie;
+			memcpy(dest + copie, zone_ + i, n);
+			copie += n;
+			offset += n;
+		}
+		return copie;
+	}
+
+ protected:
+	uint8_t octet(size_t offset) const { return zone_[(debut_ + offset) % capacite_]; }
+
+	// ajoute n octets à la fin de l'anneau (la place a été libérée)
+	void poser(const uint8_t *data, size_t n)
+	{
+		size_t i = (debut_ + taille_) % capacite_;
+		size_t premier = capacite_ - i < n ? capacite_ - i : n;
+		memcpy(zone_ + i, data, premier);
+		memcpy(zone_, data + premier, n - premier);
+		taille_ += n;
+	}
+
+	// écarte les plus anciens enregistrements jusqu'à avoir n octets libres ; la référence avance
+	// de l'écart de chaque enregistrement écarté et reste celle du nouveau plus ancien
+	void liberer(size_t n)
+	{
+		while (capacite_ - taille_ < n)
+		{
+			size_t o = 0;
+			uint32_t ecart = 0;
+			for (int decalage = 0;; decalage += 7)
+			{
+				uint8_t v = octet(o++);
+				ecart |= uint32_t(v & 0x7F) << decalage;
+				if (!(v & 0x80))
+					break;
+			}
+			uint8_t l = octet(o++);
+			if (l & 0x80)
+				o++;
+			o += l & 0x7F;
+			debut_ = (debut_ + o) % capacite_;
+			taille_ -= o;
+			reference_us_ += ecart;
+		}
+	}
+
+	uint8_t *zone_ = nullptr;
+	size_t capacite_ = 0;
+	size_t debut_ = 0;		// plus ancien enregistrement
+	size_t taille_ = 0;		// octets enregistrés
+	uint16_t bauds_ = 0;
+	uint64_t reference_us_ = 0;	// instant dont est compté l'écart du plus ancien enregistrement
+	uint64_t horloge_us_ = 0;	// micros() prolongé à 64 bits
+	uint64_t precedent_us_ = 0;	// instant du dernier enregistrement
+	uint32_t dernier_us_ = 0;
+	bool perte_ = false;
+	std::atomic<bool> gele_{false};
+	std::atomic<bool> ecriture_{false};
+};
+
+}  // namespace capture
+}  // namespace teleinfo
@@ -0,0 +1,146 @@
+#pragma once
+
+// Courbe de charge au pas de 30 minutes, comme celle qu'Enedis relève et facture : chaque point
+// est la puissance active moyenne (W) d'une demi-heure de l'horloge, calculée à partir des index
+// d'énergie et non des PAPP. Les demi-heures sont alignées sur l'heure UNIX (hh:00 et hh:30 en
+// heure légale française, qui est décalée d'heures entières).
+//
+// L'index au passage de chaque demi-heure est interpolé entre la dernière trame avant et la
+// première après : la demi-heure reçoit exactement l'énergie consommée entre ses bornes. Une
+// demi-heure dont une borne tombe dans une coupure (trames espacées de plus d'ECART_MAX) n'a
+// pas de point (ABSENT), de même que la première après le démarrage.
+//
+// Anneau indexé par le numéro de la demi-heure, 2 octets par point : 30 jours tiennent dans
+// 2880 octets.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace teleinfo {
+namespace courbe {
+
+constexpr uint32_t PAS = 1800;					// secondes
+constexpr uint32_t ECART_MAX = 300;				// secondes entre deux trames, au-delà coupure
+constexpr uint16_t ABSENT = 0xFFFF;				// demi-heure sans point
+constexpr uint16_t PUISSANCE_MAX = 0xFFFE;		// W, au-delà la valeur est tronquée
+constexpr uint32_t POINTS_PAR_JOUR = 86400 / PAS;
+
+template<size_t POINTS>
+class Courbe {
+	static_assert(POINTS > 0, "courbe vide");
+
+ public:
+	// instant : heure UNIX de la trame (s), croissante ; index : énergie soutirée totale (Wh).
+	// Retourne true quand une demi-heure vient de se terminer avec un point (cf. dernier()).
+	bool ajouter(uint32_t instant, uint32_t index)
+	{
+		if (connu_ && (instant < instant_ || index < index_))
+			connu_ = debut_connu_ = false;		// heure reculée, changement de compteur
+		if (!connu_)
+		{
+			memoriser(instant, index);
+			connu_ = true;
+			return false;
+		}
+		uint32_t k = instant / PAS;
+		if (k == demi_heure_)
+		{
+			memoriser(instant, index);
+			return false;
+		}
+		bool point = false;
+		if (instant - instant_ <= ECART_MAX)
+		{
+			// une seule borne franchie (ECART_MAX < PAS) : index interpolé à la borne
+			uint32_t borne = k * PAS;
+			uint32_t index_borne = index_ +
+				static_cast<uint32_t>(uint64_t(index - index_) * (borne - instant_) / (instant - instant_));
+			if (debut_connu_)
+			{
+				uint32_t p = (index_borne - index_debut_) * (3600 / PAS);
+				ranger(demi_heure_, static_cast<uint16_t>(p < PUISSANCE_MAX ? p : PUISSANCE_MAX));
+				point = true;
+			}
+			index_debut_ = index_borne;
+			debut_connu_ = true;
+		}
+		else
+			debut_connu_ = false;
+		memoriser(instant, index);
+		return point;
+	}
+
+	// dernière demi-heure terminée : début (heure UNIX) et puissance moyenne ; false si aucune
+	bool dernier(uint32_t &debut, uint16_t &puissance) const
+	{
+		if (suivant_ == 0)
+			return false;
+		debut = (suivant_ - 1) * PAS;
+		puissance = points_[(suivant_ - 1) % POINTS];
+		return true;
+	}
+
+	// demi-heures terminées qui recouvrent [debut, fin] (heure UNIX), de la plus ancienne à la plus
+	// récente : rappel(uint32_t debut_demi_heure, uint16_t puissance) ; puissance ABSENT si aucun
+	// point. Retourne le nombre de demi-heures.
+	template<typename F>
+	size_t lire(uint32_t debut, uint32_t fin, F &&rappel) const
+	{
+		if (suivant_ == 0)
+			return 0;
+		uint32_t premier = suivant_ > POINTS ? suivant_ - POINTS : 0;
+		uint32_t d = debut / PAS, f = fin / PAS;
+		d = d > premier ? d : premier;
+		f = f < suivant_ - 1 ? f : suivant_ - 1;
+		size_t lus = 0;
+		for (uint32_t k = d; k <= f && k >= d; k++, lus++)
+			rappel(k * PAS, points_[k % POINTS]);
+		return lus;
+	}
+
+	// les n dernières demi-heures terminées
+	template<typename F>
+	size_t derniers(uint32_t n, F &&rappel) const
+	{
+		if (suivant_ == 0 || n == 0)
+			return 0;
+		uint32_t d = suivant_ > n ? suivant_ - n : 0;
+		return lire(d * PAS, (suivant_ - 1) * PAS, rappel);
+	}
+
+ protected:
+	void memoriser(uint32_t instant, uint32_t index)
+	{
+		instant_ = instant;
+		index_ = index;
+		demi_heure_ = instant / PAS;
+	}
+
+	// range le point de la demi-heure k ; les demi-heures sautées depuis le dernier point sont absentes
+	void ranger(uint32_t k, uint16_t puissance)
+	{
+		if (suivant_ != 0 && k < suivant_)
+			return;
+		uint32_t debut = suivant_;
+		if (suivant_ == 0 || k - suivant_ >= POINTS)
+			debut = k >= POINTS ? k - POINTS + 1 : 0;
+		for (uint32_t j = debut; j < k; j++)
+			points_[j % POINTS] = ABSENT;
+		points_[k % POINTS] = puissance;
+		suivant_ = k + 1;
+	}
+
+	uint16_t points_[POINTS];
+	uint32_t suivant_ = 0;		// numéro de la dernière demi-heure rangée + 1 (0 : courbe vide)
+	// dernière trame
+	uint32_t instant_ = 0;
+	uint32_t index_ = 0;
+	uint32_t demi_heure_ = 0;
+	bool connu_ = false;
+	// index interpolé au début de la demi-heure en cours
+	uint32_t index_debut_ = 0;
+	bool debut_connu_ = false;
+};
+
+}  // namespace courbe
+}  // namespace teleinfo
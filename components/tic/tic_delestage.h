@@ -0,0 +1,85 @@
+#pragma once
+
+// Délestage sur dépassement de la puissance souscrite. Les charges sont rangées par priorité
+// (la première est coupée en premier). Chaque groupe qui signale un dépassement (ADPS, ADIRn,
+// STGE) coupe la charge suivante, au plus une tous les PAS : la coupure n'apparaît dans IINST
+// qu'à la trame suivante. Les charges coupées sont rétablies dans l'ordre inverse, une à la fois,
+// quand aucune trame n'a signalé de dépassement depuis le délai de retour, et seulement si
+// l'intensité de la charge tient sous l'intensité souscrite moins la marge (hystérésis).
+//
+// Seules les charges coupées par le délestage sont rétablies ; une charge éteinte par ailleurs
+// n'est ni coupée ni rétablie.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace teleinfo {
+namespace delestage {
+
+constexpr int AUCUNE = -1;
+
+template<uint8_t N>
+class Delestage {
+	static_assert(N > 0 && N <= 32, "charges repérées par un masque 32 bits");
+
+ public:
+	// courant : intensité de la charge (A), 0 si inconnue (rétablie sans condition d'intensité)
+	void configurer(uint8_t i, uint16_t courant) { courants_[i] = courant; }
+	// pas : entre deux coupures ; retour : sans dépassement avant de rétablir (ms) ; marge (A)
+	void set_delais(uint32_t pas, uint32_t retour, uint16_t marge)
+	{
+		pas_ = pas;
+		retour_ = retour;
+		marge_ = marge;
+	}
+
+	// Groupe signalant un dépassement ; allumees : bit i si la charge i est allumée.
+	// Retourne la charge à couper, AUCUNE si toutes le sont ou si la précédente vient de l'être.
+	int depassement(uint32_t maintenant, uint32_t allumees)
+	{
+		evenement_ = maintenant;
+		if (coupees_ != 0 && maintenant - coupure_ < pas_)
+			return AUCUNE;
+		for (uint8_t i = 0; i < N; i++)
+			if (((allumees & ~coupees_) >> i) & 1)
+			{
+				coupees_ |= uint32_t(1) << i;
+				coupure_ = maintenant;
+				return i;
+			}
+		return AUCUNE;
+	}
+
+	// Trame complète, sans dépassement : intensite et souscrite en A (souscrite 0 si inconnue).
+	// Retourne la charge à rétablir, AUCUNE sinon.
+	int trame(uint32_t maintenant, uint32_t intensite, uint32_t souscrite)
+	{
+		// toute coupure suit une alerte : evenement_ est connu dès qu'une charge est coupée
+		if (coupees_ == 0 || maintenant - evenement_ < retour_)
+			return AUCUNE;
+		// dernière coupée
+		uint8_t i = N;
+		while (i > 0 && !((coupees_ >> (i - 1)) & 1))
+			i--;
+		i--;
+		if (courants_[i] != 0 && souscrite != 0 && intensite + courants_[i] + marge_ > souscrite)
+			return AUCUNE;
+		coupees_ &= ~(uint32_t(1) << i);
+		evenement_ = maintenant;
+		return i;
+	}
+
+	uint32_t coupees() const { return coupees_; }
+
+ protected:
+	uint16_t courants_[N] = {};
+	uint32_t pas_ = 2000;
+	uint32_t retour_ = 300000;
+	uint16_t marge_ = 0;
+	uint32_t coupees_ = 0;
+	uint32_t coupure_ = 0;
+	uint32_t evenement_ = 0;	// dernier dépassement ou dernier retour
+};
+
+}  // namespace delestage
+}  // namespace teleinfo
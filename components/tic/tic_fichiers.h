@@ -0,0 +1,99 @@
+#pragma once
+
+// Accès aux fichiers d'un dossier par l'API POSIX, pour le journal (tic_journal.h) : PC (tools/)
+// et ESP32, dont LittleFS est monté dans le VFS (/littlefs).
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace teleinfo {
+namespace journal {
+
+class FichiersPosix {
+ public:
+	// crée le dossier s'il n'existe pas
+	bool ouvrir(const char *dossier)
+	{
+		dossier_ = dossier;
+		mkdir(dossier, 0755);
+		struct stat st;
+		return stat(dossier, &st) == 0 && S_ISDIR(st.st_mode);
+	}
+
+	long taille(const char *nom)
+	{
+		struct stat st;
+		return stat(chemin(nom).c_str(), &st) == 0 ? static_cast<long>(st.st_size) : -1;
+	}
+
+	size_t lire(const char *nom, size_t position, uint8_t *dest, size_t n)
+	{
+		int fd = ::open(chemin(nom).c_str(), O_RDONLY);
+		if (fd < 0)
+			return 0;
+		size_t lus = 0;
+		if (lseek(fd, static_cast<off_t>(position), SEEK_SET) >= 0)
+		{
+			ssize_t r;
+			while (lus < n && (r = ::read(fd, dest + lus, n - lus)) > 0)
+				lus += r;
+		}
+		::close(fd);
+		return lus;
+	}
+
+	bool ajouter(const char *nom, const uint8_t *data, size_t n)
+	{
+		int fd = ::open(chemin(nom).c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+		if (fd < 0)
+			return false;
+		size_t ecrits = 0;
+		ssize_t r;
+		while (ecrits < n && (r = ::write(fd, data + ecrits, n - ecrits)) > 0)
+			ecrits += r;
+		bool ok = ecrits == n && fsync(fd) == 0;
+		return ::close(fd) == 0 && ok;
+	}
+
+	bool tronquer(const char *nom, size_t taille)
+	{
+		return truncate(chemin(nom).c_str(), static_cast<off_t>(taille)) == 0;
+	}
+	bool supprimer(const char *nom) { return unlink(chemin(nom).c_str()) == 0; }
+	bool renommer(const char *ancien, const char *nouveau)
+	{
+		return rename(chemin(ancien).c_str(), chemin(nouveau).c_str()) == 0;
+	}
+
+	template<typename F>
+	void lister(F &&rappel)
+	{
+		DIR *d = opendir(dossier_.c_str());
+		if (d == nullptr)
+			return;
+		while (struct dirent *e = readdir(d))
+		{
+			if (e->d_name[0] == '.')
+				continue;
+			long t = taille(e->d_name);
+			if (t >= 0)
+				rappel(static_cast<const char *>(e->d_name), static_cast<size_t>(t));
+		}
+		closedir(d);
+	}
+
+ protected:
+	std::string chemin(const char *nom) const { return dossier_ + "/" + nom; }
+
+	std::string dossier_;
+};
+
+}  // namespace journal
+}  // namespace teleinfo
@@ -0,0 +1,518 @@
+#pragma once
+
+// Journal en ajout seul sur la flash (LittleFS), qui résiste aux coupures de courant : historique
+// et compteurs (index) survivent au redémarrage sans jamais réécrire un fichier existant.
+//
+// Le journal est une suite de segments numérotés (%08x.tj) d'au plus taille_segment octets :
+//   en-tête { "TICJ", version, drapeaux, numéro }
+//   enregistrements { type, longueur (0 à 255), charge, CRC-32 (type à la fin de la charge) }
+// Le premier enregistrement de chaque segment est la DEFINITION fournie par l'appelant (liste des
+// étiquettes...) : un segment se lit seul.
+//
+// - Écriture : ajouter() copie l'enregistrement dans un tampon en RAM, vider() l'ajoute au segment
+//   courant en une écriture. LittleFS réécrit le dernier bloc (4 ko) du fichier à chaque écriture :
+//   vider au plus toutes les quelques minutes borne l'usure à un bloc par vidage. Une coupure perd
+//   le tampon, jamais ce qui était déjà écrit.
+// - Reprise : seuls les segments antérieurs au dernier sont complets par construction ; ouvrir()
+//   ne relit que le dernier (CRC de chaque enregistrement) et tronque une fin d'écriture
+//   interrompue. Un fichier .tmp laissé par une compaction interrompue est supprimé.
+// - Compaction : au-delà de taille_max, le plus ancien segment non compacté est réécrit en ne
+//   gardant que le dernier enregistrement de chaque groupe (par exemple chaque heure) dans un .tmp
+//   renommé ensuite sur l'original (opération atomique de LittleFS). Quand tous les anciens
+//   segments sont compactés, le plus ancien est supprimé. Chaque fichier occupe au moins un bloc
+//   de 4 ko : taille_max compte la flash occupée. compacter() traite quelques
+//   enregistrements par appel, depuis loop() : la réception n'attend jamais la flash.
+//
+// S : accès aux fichiers d'un dossier (cf. tic_fichiers.h pour POSIX, tic_log.h pour l'ESP8266) :
+//   long taille(const char *nom)                       -1 si absent
+//   size_t lire(const char *nom, size_t position, uint8_t *dest, size_t n)
+//   bool ajouter(const char *nom, const uint8_t *data, size_t n)     crée le fichier, synchronise
+//   bool tronquer(const char *nom, size_t taille)
+//   bool supprimer(const char *nom)
+//   bool renommer(const char *ancien, const char *nouveau)            remplace nouveau
+//   void lister(F rappel)                              rappel(const char *nom, size_t taille)
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace teleinfo {
+namespace journal {
+
+constexpr uint32_t MAGIE = 0x4A434954;	// "TICJ"
+constexpr uint16_t VERSION = 1;
+constexpr size_t CHARGE_MAX = 255;
+constexpr size_t ENREGISTREMENT_MAX = 2 + CHARGE_MAX + 4;
+constexpr size_t TAMPON_LECTURE = 512;
+constexpr size_t BLOC_FLASH = 4096;	// bloc de LittleFS sur l'ESP : taille minimale d'un fichier
+static_assert(TAMPON_LECTURE >= ENREGISTREMENT_MAX, "un enregistrement tient dans le tampon de lecture");
+
+struct EnteteSegment {
+	uint32_t magie;
+	uint16_t version;
+	uint8_t drapeaux;
+	uint8_t reserve;
+	uint32_t numero;
+};
+
+constexpr uint8_t COMPACTE = 1 << 0;	// drapeau : segment réécrit par la compaction
+
+// types d'enregistrement ; les autres sont libres pour l'appelant
+constexpr uint8_t DEFINITION = 0;
+
+inline uint32_t crc32(const uint8_t *data, size_t n, uint32_t crc = 0)
+{
+	static constexpr uint32_t TABLE[16] = {0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190,
+		0x6B6B51F4, 0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0,
+		0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+	crc = ~crc;
+	for (size_t i = 0; i < n; i++)
+	{
+		crc = TABLE[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+		crc = TABLE[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+	}
+	return ~crc;
+}
+
+// enregistrement complet dans dest (ENREGISTREMENT_MAX octets) ; retourne sa taille
+inline size_t coder(uint8_t *dest, uint8_t type, const uint8_t *charge, uint8_t n)
+{
+	dest[0] = type;
+	dest[1] = n;
+	memcpy(dest + 2, charge, n);
+	uint32_t crc = crc32(dest, 2 + n);
+	memcpy(dest + 2 + n, &crc, 4);
+	return 2 + n + 4;
+}
+
+inline void nom_segment(char (&nom)[16], uint32_t numero, bool temporaire = false)
+{
+	snprintf(nom, sizeof(nom), temporaire ? "%08x.tmp" : "%08x.tj", (unsigned) numero);
+}
+
+// Lecture séquentielle des enregistrements valides d'un segment, par blocs de TAMPON_LECTURE octets.
+template<typename S>
+class Lecture {
+ public:
+	explicit Lecture(S &support) : support_(support) {}
+
+	void ouvrir(uint32_t numero)
+	{
+		nom_segment(nom_, numero);
+		position_ = debut_ = fin_ = 0;
+	}
+
+	// en-tête du segment ; false s'il est absent ou invalide
+	bool entete(EnteteSegment &e)
+	{
+		if (support_.lire(nom_, 0, reinterpret_cast<uint8_t *>(&e), sizeof(e)) != sizeof(e))
+			return false;
+		position_ = sizeof(e);
+		return e.magie == MAGIE && e.version == VERSION;
+	}
+
+	// enregistrement suivant ; false à la fin du segment ou au premier enregistrement invalide
+	// (position() est alors la fin de la partie valide)
+	bool suivant(uint8_t &type, const uint8_t *&charge, uint8_t &n)
+	{
+		if (!charger(2))
+			return false;
+		n = tampon_[debut_ + 1];
+		if (!charger(2 + n + 4))
+			return false;
+		const uint8_t *r = tampon_ + debut_;
+		uint32_t crc;
+		memcpy(&crc, r + 2 + n, 4);
+		if (crc != crc32(r, 2 + n))
+			return false;
+		type = r[0];
+		charge = r + 2;
+		debut_ += 2 + n + 4;
+		position_ += 2 + n + 4;
+		return true;
+	}
+
+	size_t position() const { return position_; }
+	const char *nom() const { return nom_; }
+
+ protected:
+	// au moins n octets à partir de debut_ dans le tampon
+	bool charger(size_t n)
+	{
+		if (fin_ - debut_ >= n)
+			return true;
+		memmove(tampon_, tampon_ + debut_, fin_ - debut_);
+		fin_ -= debut_;
+		debut_ = 0;
+		fin_ += support_.lire(nom_, position_ + fin_, tampon_ + fin_, TAMPON_LECTURE - fin_);
+		return fin_ >= n;
+	}
+
+	S &support_;
+	char nom_[16] = {};
+	size_t position_ = 0;	// position dans le fichier de tampon_[debut_]
+	uint8_t tampon_[TAMPON_LECTURE];
+	size_t debut_ = 0;
+	size_t fin_ = 0;
+};
+
+template<typename S, size_t TAMPON = 512>
+class Journal {
+	static_assert(TAMPON >= ENREGISTREMENT_MAX, "un enregistrement tient dans le tampon");
+
+ public:
+	explicit Journal(S &support) : support_(support), lecture_(support) {}
+
+	void configurer(size_t taille_segment, size_t taille_max)
+	{
+		taille_segment_ = taille_segment;
+		taille_max_ = taille_max;
+	}
+
+	// premier enregistrement de chaque segment
+	void set_definition(const uint8_t *charge, uint8_t n)
+	{
+		definition_len_ = static_cast<uint8_t>(coder(definition_, DEFINITION, charge, n));
+	}
+
+	// Reprise au démarrage : recense les segments et vérifie le dernier. rappel(type, charge, n) est
+	// appelé pour le dernier enregistrement valide qui n'est pas une DEFINITION (s'il existe).
+	template<typename F>
+	void ouvrir(F &&rappel)
+	{
+		premier_ = UINT32_MAX;
+		dernier_ = 0;
+		total_ = 0;
+		uint32_t temporaire = 0;
+		support_.lister([&](const char *nom, size_t taille) {
+			unsigned numero;
+			char fin[5] = {};
+			if (sscanf(nom, "%8x.%4s", &numero, fin) != 2)
+				return;
+			if (strcmp(fin, "tmp") == 0)
+				temporaire = numero;
+			if (strcmp(fin, "tj") != 0)
+				return;
+			premier_ = numero < premier_ ? numero : premier_;
+			dernier_ = numero > dernier_ ? numero : dernier_;
+			total_ += occupe(taille);
+		});
+		// compaction interrompue avant le renommage : l'original est intact
+		if (temporaire != 0)
+		{
+			char tmp[16];
+			nom_segment(tmp, temporaire, true);
+			support_.supprimer(tmp);
+		}
+		if (premier_ == UINT32_MAX)
+		{
+			premier_ = 1;
+			dernier_ = 0;
+			compactes_ = 1;
+			return;
+		}
+		// dernier segment : tronqué après le dernier enregistrement valide
+		Lecture<S> &l = lecture_;
+		uint8_t type, n, dernier[CHARGE_MAX], dernier_type = DEFINITION, dernier_n = 0;
+		const uint8_t *charge;
+		auto garder = [&]() {
+			while (l.suivant(type, charge, n))
+				if (type != DEFINITION)
+				{
+					dernier_type = type;
+					dernier_n = n;
+					memcpy(dernier, charge, n);
+				}
+		};
+		uint32_t lu = dernier_;
+		l.ouvrir(dernier_);
+		EnteteSegment e;
+		long taille = support_.taille(l.nom());
+		if (!l.entete(e) || e.numero != dernier_)
+		{
+			support_.supprimer(l.nom());
+			total_ -= occupe(taille);
+			dernier_--;
+			taille_courant_ = taille_segment_;	// le suivant commence un segment
+		}
+		else
+		{
+			garder();
+			if (static_cast<long>(l.position()) < taille)
+			{
+				support_.tronquer(l.nom(), l.position());
+				total_ -= occupe(taille) - occupe(l.position());
+				tronques_ += taille - l.position();
+			}
+			taille_courant_ = l.position();
+		}
+		// coupure juste après l'ouverture d'un segment (en-tête incomplet ou aucun enregistrement) :
+		// le dernier enregistrement est dans un segment précédent
+		for (; dernier_type == DEFINITION && lu > premier_; lu--)
+		{
+			l.ouvrir(lu - 1);
+			if (l.entete(e))
+				garder();
+		}
+		if (dernier_type != DEFINITION)
+			rappel(dernier_type, static_cast<const uint8_t *>(dernier), dernier_n);
+		// segments déjà compactés, toujours les plus anciens
+		compactes_ = premier_;
+		for (; compactes_ < dernier_; compactes_++)
+		{
+			l.ouvrir(compactes_);
+			if (!l.entete(e) || !(e.drapeaux & COMPACTE))
+				break;
+		}
+		if (premier_ > dernier_)
+			premier_ = dernier_ + 1;
+	}
+
+	// false si l'enregistrement ne tient pas dans le tampon après un vidage raté
+	bool ajouter(uint8_t type, const uint8_t *charge, uint8_t n)
+	{
+		if (rempli_ + 2 + n + 4 > TAMPON && !vider())
+			return false;
+		rempli_ += coder(tampon_ + rempli_, type, charge, n);
+		return true;
+	}
+
+	// écrit le tampon à la fin du segment courant, ou dans un nouveau segment si celui-ci est plein
+	bool vider()
+	{
+		if (rempli_ == 0)
+			return true;
+		char nom[16];
+		if (dernier_ == 0 || taille_courant_ + rempli_ > taille_segment_)
+		{
+			// nouveau segment : en-tête et définition, puis le tampon
+			uint32_t numero = dernier_ + 1;
+			nom_segment(nom, numero);
+			uint8_t debut[sizeof(EnteteSegment) + ENREGISTREMENT_MAX];
+			EnteteSegment e = {MAGIE, VERSION, 0, 0, numero};
+			memcpy(debut, &e, sizeof(e));
+			memcpy(debut + sizeof(e), definition_, definition_len_);
+			size_t n = sizeof(e) + definition_len_;
+			if (!support_.ajouter(nom, debut, n))
+				return echec();
+			dernier_ = numero;
+			taille_courant_ = n;
+			total_ += occupe(n);
+			if (premier_ > dernier_)
+				premier_ = dernier_;
+		}
+		nom_segment(nom, dernier_);
+		if (!support_.ajouter(nom, tampon_, rempli_))
+			return echec();
+		total_ += occupe(taille_courant_ + rempli_) - occupe(taille_courant_);
+		taille_courant_ += rempli_;
+		ecrits_ += rempli_;
+		rempli_ = 0;
+		return true;
+	}
+
+	// compaction nécessaire : le journal dépasse taille_max et contient un segment terminé
+	bool a_compacter() const { return total_ > taille_max_ && premier_ < dernier_; }
+
+	// Une étape de compaction (au plus ETAPE enregistrements) ; groupe(type, charge, n) retourne la
+	// clé de regroupement d'un enregistrement (par exemple l'heure) : des enregistrements
+	// consécutifs de même clé sont réduits au dernier. Retourne true s'il reste du travail.
+	template<typename F>
+	bool compacter(F &&groupe)
+	{
+		static constexpr uint8_t ETAPE = 16;
+		if (!compaction_.active)
+		{
+			if (!a_compacter())
+				return false;
+			if (compactes_ < dernier_ && compactes_ >= premier_)
+				return commencer();
+			// tous les anciens segments sont compactés : le plus ancien est supprimé
+			char nom[16];
+			nom_segment(nom, premier_);
+			long taille = support_.taille(nom);
+			support_.supprimer(nom);
+			total_ -= occupe(taille);
+			premier_++;
+			compactes_ = compactes_ > premier_ ? compactes_ : premier_;
+			return a_compacter();
+		}
+		Compaction &c = compaction_;
+		uint8_t type, n;
+		const uint8_t *charge;
+		for (uint8_t i = 0; i < ETAPE; i++)
+		{
+			if (!lecture_.suivant(type, charge, n))
+				return terminer();
+			uint32_t cle = type == DEFINITION ? 0 : groupe(type, charge, n);
+			if (c.attente_len != 0 && (type == DEFINITION || cle != c.cle))
+			{
+				if (!sortir(c.attente, c.attente_len))
+					return abandonner();
+				c.attente_len = 0;
+			}
+			if (type == DEFINITION)
+			{
+				uint8_t r[ENREGISTREMENT_MAX];
+				if (!sortir(r, coder(r, type, charge, n)))
+					return abandonner();
+			}
+			else
+			{
+				c.attente_len = coder(c.attente, type, charge, n);
+				c.cle = cle;
+			}
+		}
+		return true;
+	}
+
+	// Tous les enregistrements, du plus ancien au plus récent, y compris ceux du tampon :
+	// rappel(numero_segment, type, charge, n) ; numero_segment vaut 0 pour le tampon. Indépendant
+	// d'une compaction en cours (lecture propre, TAMPON_LECTURE octets sur la pile).
+	template<typename F>
+	void parcourir(F &&rappel)
+	{
+		uint8_t type, n;
+		const uint8_t *charge;
+		Lecture<S> l(support_);
+		for (uint32_t s = premier_; s <= dernier_ && s != 0; s++)
+		{
+			l.ouvrir(s);
+			EnteteSegment e;
+			if (!l.entete(e))
+				continue;
+			while (l.suivant(type, charge, n))
+				rappel(s, type, charge, n);
+		}
+		for (size_t p = 0; p < rempli_; p += 2 + tampon_[p + 1] + 4)
+			rappel(uint32_t(0), tampon_[p], static_cast<const uint8_t *>(tampon_ + p + 2), tampon_[p + 1]);
+	}
+
+	// flash occupée par les segments
+	size_t total() const { return total_; }
+	size_t en_attente() const { return rempli_; }
+	uint32_t segments() const { return dernier_ >= premier_ ? dernier_ - premier_ + 1 : 0; }
+	uint32_t echecs() const { return echecs_; }
+	// octets invalides retirés à la reprise (écriture interrompue)
+	size_t tronques() const { return tronques_; }
+	// octets d'enregistrements écrits depuis le démarrage
+	uint64_t ecrits() const { return ecrits_; }
+
+ protected:
+	struct Compaction {
+		bool active = false;
+		uint8_t attente[ENREGISTREMENT_MAX];	// dernier enregistrement du groupe en cours
+		size_t attente_len = 0;
+		uint32_t cle = 0;
+		uint8_t sortie[TAMPON];
+		size_t sortie_len = 0;
+		size_t ecrits = 0;
+	};
+
+	// un fichier occupe des blocs entiers de la flash
+	static size_t occupe(long taille)
+	{
+		return taille > 0 ? (static_cast<size_t>(taille) + BLOC_FLASH - 1) / BLOC_FLASH * BLOC_FLASH : 0;
+	}
+
+	bool echec()
+	{
+		echecs_++;
+		rempli_ = 0;
+		return false;
+	}
+
+	bool commencer()
+	{
+		Compaction &c = compaction_;
+		c = Compaction();
+		lecture_.ouvrir(compactes_);
+		EnteteSegment e;
+		if (!lecture_.entete(e))
+		{
+			// segment illisible : rien à garder
+			compactes_++;
+			return true;
+		}
+		char tmp[16];
+		nom_segment(tmp, compactes_, true);
+		support_.supprimer(tmp);
+		e.drapeaux |= COMPACTE;
+		c.active = true;
+		return sortir(reinterpret_cast<const uint8_t *>(&e), sizeof(e)) || abandonner();
+	}
+
+	bool sortir(const uint8_t *data, size_t n)
+	{
+		Compaction &c = compaction_;
+		if (c.sortie_len + n > TAMPON)
+		{
+			char tmp[16];
+			nom_segment(tmp, compactes_, true);
+			if (!support_.ajouter(tmp, c.sortie, c.sortie_len))
+				return false;
+			c.ecrits += c.sortie_len;
+			c.sortie_len = 0;
+		}
+		memcpy(c.sortie + c.sortie_len, data, n);
+		c.sortie_len += n;
+		return true;
+	}
+
+	bool terminer()
+	{
+		Compaction &c = compaction_;
+		if (c.attente_len != 0 && !sortir(c.attente, c.attente_len))
+			return abandonner();
+		char tmp[16], nom[16];
+		nom_segment(tmp, compactes_, true);
+		nom_segment(nom, compactes_);
+		if (!support_.ajouter(tmp, c.sortie, c.sortie_len))
+			return abandonner();
+		c.ecrits += c.sortie_len;
+		long avant = support_.taille(nom);
+		if (!support_.renommer(tmp, nom))
+			return abandonner();
+		total_ -= occupe(avant);
+		total_ += occupe(c.ecrits);
+		c.active = false;
+		compactes_++;
+		return a_compacter();
+	}
+
+	// le segment d'origine reste intact ; la compaction passe au suivant
+	bool abandonner()
+	{
+		char tmp[16];
+		nom_segment(tmp, compactes_, true);
+		support_.supprimer(tmp);
+		echecs_++;
+		compaction_.active = false;
+		compactes_++;
+		return a_compacter();
+	}
+
+	S &support_;
+	size_t taille_segment_ = 32 * 1024;
+	size_t taille_max_ = 256 * 1024;
+	uint8_t definition_[ENREGISTREMENT_MAX];
+	uint8_t definition_len_ = 0;
+
+	uint32_t premier_ = 1;		// plus ancien segment
+	uint32_t dernier_ = 0;		// segment courant (0 : aucun)
+	uint32_t compactes_ = 1;	// premier segment non compacté
+	size_t taille_courant_ = 0;
+	size_t total_ = 0;			// flash occupée, cf. occupe()
+	uint8_t tampon_[TAMPON];
+	size_t rempli_ = 0;
+
+	Compaction compaction_;
+	Lecture<S> lecture_;	// reprise, puis segment en cours de compaction
+	uint32_t echecs_ = 0;
+	size_t tronques_ = 0;
+	uint64_t ecrits_ = 0;
+};
+
+}  // namespace journal
+}  // namespace teleinfo
@@ -0,0 +1,178 @@
+#pragma once
+
+// Historique de la puissance apparente et de l'intensité en trois paliers de résolution, de
+// taille fixe : secondes (la dernière heure par défaut), minutes (le dernier jour), quarts
+// d'heure (le dernier mois). Chaque trame met à jour les trois paliers : la seconde est écrite
+// directement, minute et quart d'heure cumulent somme et maximum jusqu'à la fin de l'intervalle.
+// Une lecture parcourt seulement les intervalles demandés.
+//
+// Chaque palier est un anneau indexé par le numéro de l'intervalle (instant / pas) : un
+// intervalle sans trame est marqué ABSENT, une coupure plus longue que le palier le vide.
+// Une seconde occupe 3 octets, une minute ou un quart d'heure 6 : 3600 s + 1440 min + 2880 quarts
+// d'heure (30 jours) tiennent dans 37 ko.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace teleinfo {
+namespace paliers {
+
+constexpr uint16_t ABSENT = 0xFFFF;		// puissance d'un intervalle sans trame
+constexpr uint16_t PUISSANCE_MAX = 0xFFFE;	// VA, au-delà la valeur est tronquée
+constexpr uint8_t INTENSITE_MAX = 0xFF;		// A
+
+enum Palier : uint8_t { SECONDE, MINUTE, QUART };
+constexpr uint32_t PAS[] = {1, 60, 900};	// secondes
+
+// un intervalle ; pour une seconde, moyenne et maximum sont la valeur de la dernière trame
+struct Agregat {
+	uint16_t puissance = ABSENT;	// VA, moyenne des trames
+	uint16_t puissance_max = ABSENT;
+	uint8_t intensite = 0;		// A, moyenne des trames
+	uint8_t intensite_max = 0;
+
+	bool absent() const { return puissance == ABSENT; }
+};
+
+template<size_t SECONDES, size_t MINUTES, size_t QUARTS>
+class Paliers {
+	static_assert(SECONDES > 0 && MINUTES > 0 && QUARTS > 0, "palier vide");
+
+ public:
+	static constexpr size_t TAILLE[] = {SECONDES, MINUTES, QUARTS};
+
+	// seconde : instant de la trame, croissant (une trame antérieure au dernier intervalle
+	// enregistré est ignorée)
+	void ajouter(uint32_t seconde, uint32_t puissance, uint32_t intensite)
+	{
+		uint16_t p = static_cast<uint16_t>(puissance < PUISSANCE_MAX ? puissance : PUISSANCE_MAX);
+		uint8_t i = static_cast<uint8_t>(intensite < INTENSITE_MAX ? intensite : INTENSITE_MAX);
+		if (!avancer(SECONDE, seconde))
+			return;
+		size_t k = seconde % SECONDES;
+		puissance_s_[k] = p;
+		intensite_s_[k] = i;
+		cumuler(minute_, MINUTE, seconde / PAS[MINUTE], p, i);
+		cumuler(quart_, QUART, seconde / PAS[QUART], p, i);
+	}
+
+	// Intervalles terminés du palier qui recouvrent [debut, fin] (secondes), du plus ancien au plus
+	// récent : rappel(uint32_t debut_intervalle, const Agregat &). Retourne le nombre d'intervalles.
+	template<typename F>
+	size_t lire(Palier palier, uint32_t debut, uint32_t fin, F &&rappel) const
+	{
+		uint32_t n = suivant_[palier];
+		if (n == 0)
+			return 0;
+		uint32_t premier = n > TAILLE[palier] ? n - TAILLE[palier] : 0;
+		uint32_t d = debut / PAS[palier], f = fin / PAS[palier];
+		d = d > premier ? d : premier;
+		f = f < n - 1 ? f : n - 1;
+		size_t lus = 0;
+		for (uint32_t k = d; k <= f && k >= d; k++, lus++)
+			rappel(k * PAS[palier], agregat(palier, k));
+		return lus;
+	}
+
+	// les n derniers intervalles terminés du palier
+	template<typename F>
+	size_t derniers(Palier palier, uint32_t n, F &&rappel) const
+	{
+		uint32_t s = suivant_[palier];
+		if (s == 0 || n == 0)
+			return 0;
+		uint32_t d = s > n ? s - n : 0;
+		return lire(palier, d * PAS[palier], (s - 1) * PAS[palier], rappel);
+	}
+
+	// début du dernier intervalle terminé du palier ; false si aucun
+	bool dernier(Palier palier, uint32_t &debut) const
+	{
+		if (suivant_[palier] == 0)
+			return false;
+		debut = (suivant_[palier] - 1) * PAS[palier];
+		return true;
+	}
+
+ protected:
+	struct Cumul {
+		uint32_t intervalle = 0;
+		uint32_t somme_p = 0;
+		uint32_t somme_i = 0;
+		uint16_t trames = 0;
+		uint16_t max_p = 0;
+		uint8_t max_i = 0;
+	};
+
+	// passe à l'intervalle k du palier : les intervalles sautés sont marqués absents ; false si k
+	// précède le dernier intervalle enregistré
+	bool avancer(Palier palier, uint32_t seconde)
+	{
+		uint32_t k = seconde / PAS[palier];
+		uint32_t &n = suivant_[palier];
+		if (n != 0 && k + 1 < n)
+			return false;
+		uint32_t debut = n;
+		if (n == 0 || k - n >= TAILLE[palier])
+			debut = k >= TAILLE[palier] ? k - TAILLE[palier] + 1 : 0;
+		for (uint32_t j = debut; j < k; j++)
+			effacer(palier, j);
+		n = k + 1;
+		return true;
+	}
+
+	void effacer(Palier palier, uint32_t k)
+	{
+		if (palier == SECONDE)
+			puissance_s_[k % SECONDES] = ABSENT;
+		else
+			(palier == MINUTE ? minutes_[k % MINUTES] : quarts_[k % QUARTS]) = Agregat();
+	}
+
+	void cumuler(Cumul &c, Palier palier, uint32_t intervalle, uint16_t p, uint8_t i)
+	{
+		if (c.trames != 0 && intervalle != c.intervalle)
+		{
+			// intervalle précédent terminé : il devient lisible
+			if (avancer(palier, c.intervalle * PAS[palier]))
+			{
+				Agregat &a = palier == MINUTE ? minutes_[c.intervalle % MINUTES] : quarts_[c.intervalle % QUARTS];
+				a.puissance = static_cast<uint16_t>(c.somme_p / c.trames);
+				a.puissance_max = c.max_p;
+				a.intensite = static_cast<uint8_t>(c.somme_i / c.trames);
+				a.intensite_max = c.max_i;
+			}
+			c = Cumul();
+		}
+		c.intervalle = intervalle;
+		c.somme_p += p;
+		c.somme_i += i;
+		c.trames++;
+		c.max_p = p > c.max_p ? p : c.max_p;
+		c.max_i = i > c.max_i ? i : c.max_i;
+	}
+
+	Agregat agregat(Palier palier, uint32_t k) const
+	{
+		if (palier == MINUTE)
+			return minutes_[k % MINUTES];
+		if (palier == QUART)
+			return quarts_[k % QUARTS];
+		Agregat a;
+		uint16_t p = puissance_s_[k % SECONDES];
+		if (p != ABSENT)
+			a = {p, p, intensite_s_[k % SECONDES], intensite_s_[k % SECONDES]};
+		return a;
+	}
+
+	uint16_t puissance_s_[SECONDES];
+	uint8_t intensite_s_[SECONDES];
+	Agregat minutes_[MINUTES];
+	Agregat quarts_[QUARTS];
+	Cumul minute_;
+	Cumul quart_;
+	uint32_t suivant_[3] = {};	// numéro du dernier intervalle enregistré + 1 (0 : palier vide)
+};
+
+}  // namespace paliers
+}  // namespace teleinfo
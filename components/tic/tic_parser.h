@@ -0,0 +1,537 @@
+#pragma once
+
+// Décodage de la téléinformation client (TIC) Enedis, modes historique et standard.
+// En-tête seul, sans dépendance à Arduino ni à ESPHome (uniquement <cstdint>/<cstring>) :
+// le même code est compilé sur l'ESP (Arduino ou ESP-IDF) et sur PC (tools/).
+//
+// Le mode (historique/standard) et le nombre de phases ne changent jamais pour une installation :
+// ils sont passés en paramètres template (Historique<1>, Standard<3>...) pour que séparateur,
+// étendue du checksum, table des étiquettes et tailles des champs soient des constantes.
+// Auto<PHASES> reconnaît le mode à l'exécution (version générique).
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace teleinfo {
+
+enum class Label : uint8_t {
+	// mode historique
+	ADCO, OPTARIF, ISOUSC, BASE, HCHC, HCHP, EJPHN, EJPHPM,
+	BBRHCJB, BBRHPJB, BBRHCJW, BBRHPJW, BBRHCJR, BBRHPJR,
+	PEJP, PTEC, DEMAIN, IINST, IINST1, IINST2, IINST3,
+	ADPS, ADIR1, ADIR2, ADIR3, IMAX, IMAX1, IMAX2, IMAX3,
+	PMAX, PAPP, HHPHC, MOTDETAT, PPOT,
+	// mode standard
+	ADSC, NGTF, LTARF, EAST, EASF01, EASF02, EASF03, EASF04, EASF05, EASF06, EAIT,
+	IRMS1, IRMS2, IRMS3, URMS1, URMS2, URMS3, PREF, PCOUP,
+	SINSTS, SINSTS1, SINSTS2, SINSTS3, SINSTI, NTARF, STGE,
+	// ajoutées après coup : les numéros sont enregistrés (tic_journal, tic_colonnes)
+	EASF07, EASF08, EASF09, EASF10,
+	COUNT,
+	INCONNUE = 0xFF,
+};
+
+constexpr uint8_t NB_ETIQUETTES = static_cast<uint8_t>(Label::COUNT);
+static_assert(NB_ETIQUETTES <= 64, "les étiquettes sont repérées par un masque 64 bits");
+
+constexpr const char *NOMS[NB_ETIQUETTES] = {
+	"ADCO", "OPTARIF", "ISOUSC", "BASE", "HCHC", "HCHP", "EJPHN", "EJPHPM",
+	"BBRHCJB", "BBRHPJB", "BBRHCJW", "BBRHPJW", "BBRHCJR", "BBRHPJR",
+	"PEJP", "PTEC", "DEMAIN", "IINST", "IINST1", "IINST2", "IINST3",
+	"ADPS", "ADIR1", "ADIR2", "ADIR3", "IMAX", "IMAX1", "IMAX2", "IMAX3",
+	"PMAX", "PAPP", "HHPHC", "MOTDETAT", "PPOT",
+	"ADSC", "NGTF", "LTARF", "EAST", "EASF01", "EASF02", "EASF03", "EASF04", "EASF05", "EASF06", "EAIT",
+	"IRMS1", "IRMS2", "IRMS3", "URMS1", "URMS2", "URMS3", "PREF", "PCOUP",
+	"SINSTS", "SINSTS1", "SINSTS2", "SINSTS3", "SINSTI", "NTARF", "STGE",
+	"EASF07", "EASF08", "EASF09", "EASF10",
+};
+
+constexpr uint64_t bit(Label label) { return uint64_t(1) << static_cast<uint8_t>(label); }
+
+template<typename... L>
+constexpr uint64_t masque(L... labels) { return (uint64_t(0) | ... | bit(labels)); }
+
+constexpr uint64_t TOUTES = NB_ETIQUETTES == 64 ? ~uint64_t(0) : (uint64_t(1) << NB_ETIQUETTES) - 1;
+
+// étiquettes dont la valeur est du texte, les autres sont des entiers
+constexpr uint64_t TEXTES = masque(Label::ADCO, Label::OPTARIF, Label::PTEC, Label::DEMAIN, Label::HHPHC,
+	Label::MOTDETAT, Label::PPOT, Label::ADSC, Label::NGTF, Label::LTARF, Label::STGE);
+
+// dépassement de la puissance souscrite : ADPS et ADIRn en historique (trames courtes en triphasé),
+// bit 7 de STGE en standard
+constexpr uint64_t DEPASSEMENTS = masque(Label::ADPS, Label::ADIR1, Label::ADIR2, Label::ADIR3, Label::STGE);
+
+// index d'énergie, en Wh
+constexpr uint64_t INDEX_HISTORIQUE = masque(Label::BASE, Label::HCHC, Label::HCHP, Label::EJPHN, Label::EJPHPM,
+	Label::BBRHCJB, Label::BBRHPJB, Label::BBRHCJW, Label::BBRHPJW, Label::BBRHCJR, Label::BBRHPJR);
+constexpr uint64_t INDEX = INDEX_HISTORIQUE | masque(Label::EAST, Label::EASF01, Label::EASF02, Label::EASF03,
+	Label::EASF04, Label::EASF05, Label::EASF06, Label::EASF07, Label::EASF08, Label::EASF09, Label::EASF10,
+	Label::EAIT);
+
+// tables des étiquettes de chaque mode
+constexpr uint64_t HISTORIQUE = INDEX_HISTORIQUE | masque(Label::ADCO, Label::OPTARIF, Label::ISOUSC, Label::PEJP,
+	Label::PTEC, Label::DEMAIN, Label::PAPP, Label::HHPHC, Label::MOTDETAT);
+constexpr uint64_t HISTORIQUE_MONO = masque(Label::IINST, Label::ADPS, Label::IMAX);
+constexpr uint64_t HISTORIQUE_TRI = masque(Label::IINST1, Label::IINST2, Label::IINST3, Label::ADIR1, Label::ADIR2,
+	Label::ADIR3, Label::IMAX1, Label::IMAX2, Label::IMAX3, Label::PMAX, Label::PPOT);
+constexpr uint64_t STANDARD = masque(Label::ADSC, Label::NGTF, Label::LTARF, Label::EAST, Label::EASF01,
+	Label::EASF02, Label::EASF03, Label::EASF04, Label::EASF05, Label::EASF06, Label::EASF07, Label::EASF08,
+	Label::EASF09, Label::EASF10, Label::EAIT, Label::IRMS1, Label::URMS1, Label::PREF, Label::PCOUP,
+	Label::SINSTS, Label::SINSTI, Label::NTARF, Label::STGE);
+constexpr uint64_t STANDARD_TRI = masque(Label::IRMS2, Label::IRMS3, Label::URMS2, Label::URMS3,
+	Label::SINSTS1, Label::SINSTS2, Label::SINSTS3);
+
+constexpr size_t longueur(const char *s)
+{
+	size_t n = 0;
+	while (s[n] != '\0')
+		n++;
+	return n;
+}
+
+constexpr size_t TAILLE_ETIQUETTE = 8;
+static_assert(longueur(NOMS[static_cast<uint8_t>(Label::MOTDETAT)]) == TAILLE_ETIQUETTE, "");
+
+// Mode historique : 1200 bauds, champs séparés par un espace,
+// checksum calculé de l'étiquette à la fin de la valeur (sans le dernier séparateur).
+template<uint8_t PHASES>
+struct Historique {
+	static_assert(PHASES == 1 || PHASES == 3, "compteur monophasé ou triphasé");
+	static constexpr uint32_t BAUDS = 1200;
+	static constexpr size_t TAILLE_GROUPE = 40;
+	static constexpr uint64_t ETIQUETTES = HISTORIQUE | (PHASES == 1 ? HISTORIQUE_MONO : HISTORIQUE_TRI);
+	static constexpr bool standard() { return false; }
+	static constexpr char separateur() { return ' '; }
+	void detecter(const char *, size_t) {}
+};
+
+// Mode standard : 9600 bauds, champs séparés par une tabulation, horodate optionnelle,
+// checksum calculé de l'étiquette jusqu'au dernier séparateur inclus.
+template<uint8_t PHASES>
+struct Standard {
+	static_assert(PHASES == 1 || PHASES == 3, "compteur monophasé ou triphasé");
+	static constexpr uint32_t BAUDS = 9600;
+	static constexpr size_t TAILLE_GROUPE = 128;
+	static constexpr uint64_t ETIQUETTES = STANDARD | (PHASES == 1 ? 0 : STANDARD_TRI);
+	static constexpr bool standard() { return true; }
+	static constexpr char separateur() { return '\t'; }
+	void detecter(const char *, size_t) {}
+};
+
+// Mode reconnu groupe par groupe à la présence d'une tabulation.
+template<uint8_t PHASES>
+struct Auto {
+	static constexpr uint32_t BAUDS = 0;
+	static constexpr size_t TAILLE_GROUPE = Standard<PHASES>::TAILLE_GROUPE;
+	static constexpr uint64_t ETIQUETTES = Historique<PHASES>::ETIQUETTES | Standard<PHASES>::ETIQUETTES;
+	bool est_standard = false;
+	bool standard() const { return est_standard; }
+	char separateur() const { return est_standard ? '\t' : ' '; }
+	void detecter(const char *groupe, size_t n) { est_standard = memchr(groupe, '\t', n) != nullptr; }
+};
+
+// un groupe décodé ; les pointeurs désignent le tampon passé à Decodeur::decoder()
+struct Groupe {
+	Label etiquette = Label::INCONNUE;
+	const char *horodate = nullptr;
+	uint8_t horodate_len = 0;
+	const char *valeur = nullptr;
+	uint8_t valeur_len = 0;
+};
+
+enum class Erreur : uint8_t {
+	AUCUNE,
+	FORMAT,		// groupe trop court, trop long ou sans séparateur
+	CHECKSUM,
+	IGNOREE,	// étiquette hors de la table du mode ou non déclarée
+};
+
+// Table des étiquettes d'un masque, construite à la compilation.
+template<uint64_t M>
+struct Table {
+	static constexpr uint8_t N = __builtin_popcountll(M);
+	struct Entree {
+		Label label;
+		uint8_t longueur;
+	};
+	Entree entrees[N > 0 ? N : 1] = {};
+
+	constexpr Table()
+	{
+		uint8_t k = 0;
+		for (uint8_t i = 0; i < NB_ETIQUETTES; i++)
+			if (M & (uint64_t(1) << i))
+				entrees[k++] = {static_cast<Label>(i), static_cast<uint8_t>(longueur(NOMS[i]))};
+	}
+
+	Label chercher(const char *nom, size_t n) const
+	{
+		for (uint8_t k = 0; k < N; k++)
+		{
+			const Entree &e = entrees[k];
+			if (e.longueur == n && memcmp(NOMS[static_cast<uint8_t>(e.label)], nom, n) == 0)
+				return e.label;
+		}
+		return Label::INCONNUE;
+	}
+};
+
+// Décodeur d'un groupe (sans LF ni CR) :  <étiquette> SEP [<horodate> SEP] <valeur> SEP <checksum>
+template<typename MODE, uint64_t MASQUE = TOUTES>
+class Decodeur {
+ public:
+	static constexpr uint64_t ETIQUETTES = MODE::ETIQUETTES & MASQUE;
+
+	MODE mode;
+
+	Erreur decoder(const char *g, size_t n, Groupe &out)
+	{
+		if (n < 4 || n > MODE::TAILLE_GROUPE)
+			return Erreur::FORMAT;
+		mode.detecter(g, n);
+		const char sep = mode.separateur();
+		if (g[n - 2] != sep)
+			return Erreur::FORMAT;
+
+		// le checksum (dernier caractère) peut lui-même valoir ' ' : on découpe par position
+		const size_t etendue = mode.standard() ? n - 1 : n - 2;
+		uint32_t somme = 0;
+		for (size_t i = 0; i < etendue; i++)
+			somme += static_cast<uint8_t>(g[i]);
+		if (((somme & 0x3F) + 0x20) != static_cast<uint8_t>(g[n - 1]))
+			return Erreur::CHECKSUM;
+
+		const char *fin = g + n - 2;
+		const char *s = static_cast<const char *>(memchr(g, sep, fin - g));
+		if (s == nullptr || s == g || static_cast<size_t>(s - g) > TAILLE_ETIQUETTE)
+			return Erreur::FORMAT;
+		out.etiquette = TABLE.chercher(g, s - g);
+		if (out.etiquette == Label::INCONNUE)
+			return Erreur::IGNOREE;
+
+		const char *v = s + 1;
+		out.horodate = nullptr;
+		out.horodate_len = 0;
+		if (mode.standard())
+		{
+			const char *h = static_cast<const char *>(memchr(v, sep, fin - v));
+			if (h != nullptr)
+			{
+				out.horodate = v;
+				out.horodate_len = h - v;
+				v = h + 1;
+			}
+		}
+		out.valeur = v;
+		out.valeur_len = fin - v;
+		return Erreur::AUCUNE;
+	}
+
+ protected:
+	static constexpr Table<ETIQUETTES> TABLE{};
+};
+
+// caractères de contrôle de la liaison
+constexpr uint8_t STX = 0x02;	// début de trame
+constexpr uint8_t ETX = 0x03;	// fin de trame
+constexpr uint8_t EOT = 0x04;	// trame interrompue
+constexpr uint8_t LF = 0x0A;	// début de groupe
+constexpr uint8_t CR = 0x0D;	// fin de groupe
+
+enum class Evenement : uint8_t {
+	AUCUN,
+	DEBUT_TRAME,
+	FIN_TRAME,
+	INTERRUPTION,	// EOT : la trame en cours est incomplète
+	GROUPE,		// groupe complet disponible dans tampon()
+	DEBORDEMENT,	// groupe plus long que TAILLE, ignoré
+	INVALIDE,	// groupe rejeté par le décodeur (checksum ou format), cf. Lecteur
+};
+
+// Assemblage incrémental, octet par octet, des groupes reçus sur la liaison.
+// Aucune allocation : le groupe en cours est gardé dans un tampon de TAILLE octets.
+template<size_t TAILLE>
+class Assembleur {
+ public:
+	Evenement pousser(uint8_t c)
+	{
+		switch (c)
+		{
+			case STX:
+				dans_groupe_ = false;
+				return Evenement::DEBUT_TRAME;
+			case ETX:
+				dans_groupe_ = false;
+				return Evenement::FIN_TRAME;
+			case EOT:
+				dans_groupe_ = false;
+				return Evenement::INTERRUPTION;
+			case LF:
+				taille_ = 0;
+				dans_groupe_ = true;
+				return Evenement::AUCUN;
+			case CR:
+				if (!dans_groupe_)
+					return Evenement::AUCUN;
+				dans_groupe_ = false;
+				return Evenement::GROUPE;
+			default:
+				if (!dans_groupe_)
+					return Evenement::AUCUN;
+				if (taille_ == TAILLE)
+				{
+					dans_groupe_ = false;
+					return Evenement::DEBORDEMENT;
+				}
+				tampon_[taille_++] = static_cast<char>(c);
+				return Evenement::AUCUN;
+		}
+	}
+
+	const char *tampon() const { return tampon_; }
+	size_t taille() const { return taille_; }
+
+ protected:
+	char tampon_[TAILLE];
+	size_t taille_ = 0;
+	bool dans_groupe_ = false;
+};
+
+// valeur décimale d'un champ (les valeurs TIC sont des entiers complétés par des zéros)
+inline uint32_t entier(const char *s, size_t n)
+{
+	uint32_t v = 0;
+	for (size_t i = 0; i < n && s[i] >= '0' && s[i] <= '9'; i++)
+		v = v * 10 + (s[i] - '0');
+	return v;
+}
+
+// valeur hexadécimale d'un champ (STGE)
+inline uint32_t hexadecimal(const char *s, size_t n)
+{
+	uint32_t v = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		char c = s[i];
+		if (c >= '0' && c <= '9')
+			v = (v << 4) | (c - '0');
+		else if (c >= 'A' && c <= 'F')
+			v = (v << 4) | (c - 'A' + 10);
+		else
+			break;
+	}
+	return v;
+}
+
+constexpr uint32_t STGE_DEPASSEMENT = uint32_t(1) << 7;	// dépassement de la puissance de référence
+
+// le groupe signale un dépassement en cours (ADPS, ADIRn, STGE avec le bit de dépassement)
+inline bool signale_depassement(const Groupe &g)
+{
+	if (g.etiquette == Label::STGE)
+		return (hexadecimal(g.valeur, g.valeur_len) & STGE_DEPASSEMENT) != 0;
+	return (DEPASSEMENTS & bit(g.etiquette)) != 0;
+}
+
+constexpr size_t TAILLE_TEXTE = 16;
+
+// Étiquettes gardées dans une Trame : celles de tous les compteurs du firmware (TIC_ETIQUETTES,
+// défini par la génération de code), toutes pour les outils.
+#ifdef TIC_ETIQUETTES
+constexpr uint64_t ETIQUETTES_TRAME = TIC_ETIQUETTES;
+#else
+constexpr uint64_t ETIQUETTES_TRAME = TOUTES;
+#endif
+constexpr uint8_t NB_VALEURS = __builtin_popcountll(ETIQUETTES_TRAME & ~TEXTES);
+constexpr uint8_t NB_TEXTES = __builtin_popcountll(ETIQUETTES_TRAME & TEXTES);
+
+// Valeurs décodées d'un compteur, de disposition fixe : valeurs numériques et textes rangés dans
+// l'ordre des étiquettes de ETIQUETTES_TRAME. Une étiquette hors de ETIQUETTES_TRAME vaut 0 ou "".
+struct Trame {
+	uint64_t presentes = 0;		// étiquettes reçues depuis le début de la trame
+	uint64_t recues = 0;		// étiquettes reçues au moins une fois
+	uint32_t valeurs[NB_VALEURS > 0 ? NB_VALEURS : 1] = {};
+	char textes[NB_TEXTES > 0 ? NB_TEXTES : 1][TAILLE_TEXTE + 1] = {};
+
+	static constexpr bool gardee(Label label) { return (ETIQUETTES_TRAME & bit(label)) != 0; }
+	static constexpr uint8_t rang_valeur(Label label)
+	{
+		return __builtin_popcountll(ETIQUETTES_TRAME & ~TEXTES & (bit(label) - 1));
+	}
+	static constexpr uint8_t rang_texte(Label label)
+	{
+		return __builtin_popcountll(ETIQUETTES_TRAME & TEXTES & (bit(label) - 1));
+	}
+
+	bool presente(Label label) const { return (presentes & bit(label)) != 0; }
+	bool recue(Label label) const { return (recues & bit(label)) != 0; }
+	uint32_t valeur(Label label) const { return gardee(label) ? valeurs[rang_valeur(label)] : 0; }
+	const char *texte(Label label) const { return gardee(label) ? textes[rang_texte(label)] : ""; }
+
+	// début de trame (STX)
+	void effacer() { presentes = 0; }
+
+	// mémorise la valeur d'un groupe ; retourne true si elle a changé
+	bool enregistrer(const Groupe &g)
+	{
+		if (!gardee(g.etiquette))
+			return false;
+		presentes |= bit(g.etiquette);
+		recues |= bit(g.etiquette);
+		if (TEXTES & bit(g.etiquette))
+		{
+			char *t = textes[rang_texte(g.etiquette)];
+			size_t n = g.valeur_len < TAILLE_TEXTE ? g.valeur_len : TAILLE_TEXTE;
+			if (strncmp(t, g.valeur, n) == 0 && t[n] == '\0')
+				return false;
+			memcpy(t, g.valeur, n);
+			t[n] = '\0';
+			return true;
+		}
+		uint32_t &dest = valeurs[rang_valeur(g.etiquette)];
+		uint32_t v = entier(g.valeur, g.valeur_len);
+		if (dest == v)
+			return false;
+		dest = v;
+		return true;
+	}
+
+	// puissance apparente soutirée (VA)
+	uint32_t puissance_soutiree() const
+	{
+		return recue(Label::SINSTS) ? valeur(Label::SINSTS) : valeur(Label::PAPP);
+	}
+
+	// énergie soutirée totale (Wh) : EAST, ou somme des index de l'option tarifaire en historique
+	// (un index manquant dans une trame garde sa dernière valeur)
+	uint32_t energie_soutiree() const
+	{
+		if (recue(Label::EAST))
+			return valeur(Label::EAST);
+		uint32_t total = 0;
+		for (uint8_t i = 0; i < NB_ETIQUETTES; i++)
+			if (recues & INDEX_HISTORIQUE & (uint64_t(1) << i))
+				total += valeur(static_cast<Label>(i));
+		return total;
+	}
+
+	// intensité (A) : IINST, ou la plus forte des phases en triphasé (IINSTn, IRMSn)
+	uint32_t intensite() const
+	{
+		if (recue(Label::IINST))
+			return valeur(Label::IINST);
+		static constexpr Label PHASES[] = {Label::IINST1, Label::IINST2, Label::IINST3, Label::IRMS1, Label::IRMS2,
+			Label::IRMS3};
+		uint32_t max = 0;
+		for (Label l : PHASES)
+			if (recue(l) && valeur(l) > max)
+				max = valeur(l);
+		return max;
+	}
+
+	// la trame signale un dépassement de la puissance souscrite
+	bool depassement() const
+	{
+		if ((presentes & DEPASSEMENTS & ~bit(Label::STGE)) != 0)
+			return true;
+		const char *stge = texte(Label::STGE);
+		return presente(Label::STGE) && (hexadecimal(stge, strlen(stge)) & STGE_DEPASSEMENT) != 0;
+	}
+
+	// intensité souscrite par phase (A) : ISOUSC, ou PREF (kVA) sous 230 V ; 0 si inconnue
+	uint32_t intensite_souscrite() const
+	{
+		if (recue(Label::ISOUSC))
+			return valeur(Label::ISOUSC);
+		uint32_t phases = recue(Label::IRMS2) ? 3 : 1;
+		return valeur(Label::PREF) * 1000 / 230 / phases;
+	}
+
+	uint32_t puissance_injectee() const { return valeur(Label::SINSTI); }
+	uint32_t energie_injectee() const { return valeur(Label::EAIT); }
+};
+
+struct Statistiques {
+	uint32_t octets = 0;
+	uint32_t trames = 0;		// ETX reçus
+	uint32_t interruptions = 0;	// EOT reçus
+	uint32_t groupes = 0;		// groupes décodés (étiquettes de la table)
+	uint32_t erreurs_checksum = 0;
+	uint32_t erreurs_format = 0;
+	uint32_t debordements = 0;
+};
+
+// Chaîne complète de lecture d'un compteur : assemblage, décodage et mémorisation dans une trame.
+// Le composant ESPHome et les outils PC passent par elle, un rejeu sur PC exerce donc le même code.
+// Le rappel reçoit (Evenement, const Groupe &, bool change) ; pour GROUPE, change indique que la
+// valeur de l'étiquette a changé, pour INVALIDE le groupe brut reste lisible par tampon()/taille().
+template<typename MODE, uint64_t MASQUE = TOUTES>
+class Lecteur {
+ public:
+	explicit Lecteur(Trame &trame) : trame_(&trame) {}
+
+	// trame où enregistrer les groupes suivants (copie d'un double tampon, cf. TicMeter)
+	void cibler(Trame &trame) { trame_ = &trame; }
+
+	Statistiques stats;
+
+	template<typename RAPPEL>
+	void pousser(const uint8_t *data, size_t len, RAPPEL &&rappel)
+	{
+		stats.octets += len;
+		for (size_t i = 0; i < len; i++)
+		{
+			Evenement e = assembleur_.pousser(data[i]);
+			switch (e)
+			{
+				case Evenement::AUCUN:
+					continue;
+				case Evenement::DEBUT_TRAME:
+					trame_->effacer();
+					break;
+				case Evenement::FIN_TRAME:
+					stats.trames++;
+					break;
+				case Evenement::INTERRUPTION:
+					stats.interruptions++;
+					break;
+				case Evenement::DEBORDEMENT:
+					stats.debordements++;
+					break;
+				case Evenement::GROUPE:
+					switch (decodeur_.decoder(assembleur_.tampon(), assembleur_.taille(), groupe_))
+					{
+						case Erreur::AUCUNE:
+							stats.groupes++;
+							rappel(e, groupe_, trame_->enregistrer(groupe_));
+							continue;
+						case Erreur::IGNOREE:
+							continue;
+						case Erreur::CHECKSUM:
+							stats.erreurs_checksum++;
+							break;
+						case Erreur::FORMAT:
+							stats.erreurs_format++;
+							break;
+					}
+					e = Evenement::INVALIDE;
+					break;
+				default:
+					break;
+			}
+			rappel(e, groupe_, false);
+		}
+	}
+
+	const char *tampon() const { return assembleur_.tampon(); }
+	size_t taille() const { return assembleur_.taille(); }
+
+ protected:
+	Trame *trame_;
+	Assembleur<MODE::TAILLE_GROUPE> assembleur_;
+	Decodeur<MODE, MASQUE> decodeur_;
+	Groupe groupe_;
+};
+
+}  // namespace teleinfo
@@ -0,0 +1,102 @@
+#pragma once
+
+#ifdef USE_HOST
+
+#include <cerrno>
+#include <cstdint>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "tic_termios.h"
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace tic {
+
+// Liaison série de la plateforme host : adaptateur USB (/dev/ttyUSB0) ou pseudo-terminal relié
+// à un simulateur (tools/tic_gen, socat...). Configurée en 7E1 au débit du mode, non bloquante,
+// avec la même interface que uart::UARTDevice pour TicMeter::update().
+class TicSerial {
+ public:
+	void set_port(const char *port, uint32_t bauds)
+	{
+		port_ = port;
+		bauds_ = bauds;
+	}
+
+	int available()
+	{
+		if (fd_ < 0 && !ouvrir())
+			return 0;
+		int n = 0;
+		if (ioctl(fd_, FIONREAD, &n) < 0)
+		{
+			fermer();
+			return 0;
+		}
+		// pseudo-terminal dont l'autre extrémité est fermée : on le rouvrira
+		if (n == 0)
+		{
+			struct pollfd p = {fd_, POLLIN, 0};
+			if (poll(&p, 1, 0) > 0 && (p.revents & (POLLHUP | POLLERR)) != 0)
+				fermer();
+		}
+		return n;
+	}
+
+	bool read_array(uint8_t *data, size_t len)
+	{
+		while (len > 0)
+		{
+			ssize_t n = ::read(fd_, data, len);
+			if (n <= 0)
+			{
+				if (n < 0 && errno == EINTR)
+					continue;
+				return false;
+			}
+			data += n;
+			len -= n;
+		}
+		return true;
+	}
+
+ protected:
+	// nouvel essai au plus une fois par seconde si le port n'existe pas encore
+	bool ouvrir()
+	{
+		uint32_t maintenant = millis();
+		if (essai_ != 0 && maintenant - essai_ < 1000)
+			return false;
+		essai_ = maintenant;
+
+		fd_ = teleinfo::ouvrir_liaison(port_, bauds_);
+		if (fd_ < 0)
+		{
+			ESP_LOGW("tic", "ouverture de %s impossible (%d)", port_, errno);
+			return false;
+		}
+		ESP_LOGI("tic", "%s ouvert à %u bauds", port_, bauds_);
+		return true;
+	}
+
+	void fermer()
+	{
+		ESP_LOGW("tic", "%s fermé", port_);
+		::close(fd_);
+		fd_ = -1;
+	}
+
+	const char *port_ = nullptr;
+	uint32_t bauds_ = 1200;
+	int fd_ = -1;
+	uint32_t essai_ = 0;
+};
+
+}  // namespace tic
+}  // namespace esphome
+
+#endif  // USE_HOST
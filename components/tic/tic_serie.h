@@ -0,0 +1,468 @@
+#pragma once
+
+// Série compressée des valeurs numériques de chaque trame (PAPP, IINST, index...), pour garder
+// des heures d'historique brut dans quelques ko de RAM (ESP8266).
+//
+// Codage inspiré de Gorilla (Facebook) : chaque échantillon est l'écart à une prédiction, écrit
+// bit à bit avec un code de longueur variable. L'instant (pas de 100 ms) est prédit par l'écart
+// précédent (delta-of-delta) : une trame toutes les 1.5 s coûte 1 bit, la gigue d'update() 8 bits.
+// Les valeurs sont entières : au lieu du XOR des flottants de Gorilla, chaque colonne est prédite
+// par sa valeur précédente (puissance, intensité : 1 bit si inchangée) ou, pour une colonne
+// cumulative, par son dernier accroissement (index d'énergie : 1 bit tant que la consommation est
+// stable). Écart nul : '0' ; sinon écart en zigzag : '10' + 5 bits, '110' + 9, '1110' + 16,
+// '1111' + 32. PAPP et l'instant tiennent en 1 à 2 octets par trame.
+//
+// La zone est découpée en blocs de TAILLE_BLOC octets décodables séparément (la prédiction repart
+// de zéro) : quand elle est pleine, le plus ancien bloc est écrasé. Écrivain unique ; un lecteur
+// (Curseur) peut s'interrompre entre deux échantillons, pendant que l'écrivain continue : il saute
+// alors les blocs écrasés entre-temps. Lecteur et écrivain de tâches différentes s'excluent
+// (cf. tic_series) ; la lecture ne sort de toute façon jamais d'un bloc.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace teleinfo {
+namespace serie {
+
+constexpr size_t TAILLE_BLOC = 256;
+constexpr uint32_t RESOLUTION_MS = 100;
+
+struct EnteteBloc {
+	uint32_t instant;		// premier échantillon, en RESOLUTION_MS depuis l'origine de l'appelant
+	uint16_t echantillons;	// mis à jour après l'écriture de chaque échantillon
+	uint16_t reserve;
+};
+
+constexpr size_t BITS_BLOC = (TAILLE_BLOC - sizeof(EnteteBloc)) * 8;
+
+// largeur de l'écart en zigzag après chaque préfixe '0', '10', '110', '1110', '1111'
+constexpr uint8_t LARGEURS[] = {0, 5, 9, 16, 32};
+constexpr uint8_t PREFIXES[] = {1, 2, 3, 4, 4};
+
+inline uint32_t zigzag(int32_t v) { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+inline int32_t dezigzag(uint32_t v) { return static_cast<int32_t>((v >> 1) ^ (0 - (v & 1))); }
+
+inline uint8_t classe(uint32_t z)
+{
+	if (z == 0)
+		return 0;
+	uint8_t k = 1;
+	while (k < 4 && z >= (uint32_t(1) << LARGEURS[k]))
+		k++;
+	return k;
+}
+
+inline uint8_t taille_code(uint32_t z)
+{
+	uint8_t k = classe(z);
+	return PREFIXES[k] + LARGEURS[k];
+}
+
+// écriture et lecture de bits, poids fort en premier, dans les données d'un bloc
+inline void ecrire_bits(uint8_t *d, size_t &pos, uint32_t v, uint8_t n)
+{
+	while (n > 0)
+	{
+		uint8_t libres = 8 - (pos & 7);
+		uint8_t k = n < libres ? n : libres;
+		uint8_t morceau = static_cast<uint8_t>((v >> (n - k)) & ((1u << k) - 1));
+		uint8_t &o = d[pos >> 3];
+		if ((pos & 7) == 0)
+			o = 0;
+		o |= static_cast<uint8_t>(morceau << (libres - k));
+		pos += k;
+		n -= k;
+	}
+}
+
+// au-delà de BITS_BLOC (bloc incohérent), les bits lus valent 0 sans sortir du bloc
+inline uint32_t lire_bits(const uint8_t *d, size_t &pos, uint8_t n)
+{
+	uint32_t v = 0;
+	while (n > 0)
+	{
+		uint8_t restants = 8 - (pos & 7);
+		uint8_t k = n < restants ? n : restants;
+		uint8_t o = pos < BITS_BLOC ? d[pos >> 3] : 0;
+		v = (v << k) | ((o >> (restants - k)) & ((1u << k) - 1));
+		pos += k;
+		n -= k;
+	}
+	return v;
+}
+
+inline void ecrire_code(uint8_t *d, size_t &pos, uint32_t z)
+{
+	uint8_t k = classe(z);
+	// k uns puis un zéro, sauf pour la dernière classe ('1111')
+	ecrire_bits(d, pos, k < 4 ? ((1u << (k + 1)) - 2) : 0xF, PREFIXES[k]);
+	ecrire_bits(d, pos, z, LARGEURS[k]);
+}
+
+inline uint32_t lire_code(const uint8_t *d, size_t &pos)
+{
+	uint8_t k = 0;
+	while (k < 4 && lire_bits(d, pos, 1) == 1)
+		k++;
+	return lire_bits(d, pos, LARGEURS[k]);
+}
+
+template<uint8_t COLONNES>
+class Serie {
+	static_assert(COLONNES > 0 && COLONNES <= 32, "colonnes repérées par un masque 32 bits");
+	// un échantillon au pire : instant et colonnes en '1111' + 32 bits
+	static_assert((COLONNES + 1) * 36 <= BITS_BLOC, "échantillon plus grand qu'un bloc");
+
+ public:
+	static constexpr uint8_t NB_COLONNES = COLONNES;
+
+	// état de la prédiction, commun à l'écrivain et aux curseurs
+	struct Etat {
+		uint32_t instant = 0;
+		int32_t ecart = 0;
+		uint32_t valeurs[COLONNES] = {};
+		int32_t deltas[COLONNES] = {};
+	};
+
+	// position d'un lecteur ; initialisée par debut()
+	struct Curseur {
+		uint32_t bloc = 0;
+		uint16_t rang = 0;
+		size_t bit = 0;
+		Etat etat;
+	};
+
+	// zone : au moins deux blocs ; cumulatives : bit c si la colonne c est un index (croissante)
+	void attribuer(uint8_t *zone, size_t taille, uint32_t cumulatives)
+	{
+		zone_ = zone;
+		nb_blocs_ = static_cast<uint32_t>(taille / TAILLE_BLOC);
+		cumulatives_ = cumulatives;
+	}
+
+	bool actif() const { return zone_ != nullptr && nb_blocs_ >= 2; }
+
+	void ajouter(uint64_t instant_ms, const uint32_t (&valeurs)[COLONNES])
+	{
+		if (!actif())
+			return;
+		uint32_t instant = static_cast<uint32_t>(instant_ms / RESOLUTION_MS);
+		if (blocs_ != 0 && instant < etat_.instant)
+			return;
+		// taille de l'échantillon avant de l'écrire : un échantillon ne chevauche pas deux blocs
+		uint32_t codes[COLONNES + 1];
+		size_t bits = 0;
+		bool premier = blocs_ == 0;
+		if (!premier)
+		{
+			coder(etat_, instant, valeurs, codes, false);
+			for (uint32_t z : codes)
+				bits += taille_code(z);
+			premier = position_ + bits > BITS_BLOC;
+		}
+		if (premier)
+		{
+			// nouveau bloc, le plus ancien est écrasé
+			EnteteBloc e = {instant, 0, 0};
+			memcpy(bloc(blocs_), &e, sizeof(e));
+			blocs_++;
+			position_ = 0;
+			etat_ = Etat();
+			etat_.instant = instant;
+			coder(etat_, instant, valeurs, codes, true);
+		}
+		uint8_t *d = bloc(blocs_ - 1) + sizeof(EnteteBloc);
+		for (uint32_t z : codes)
+			ecrire_code(d, position_, z);
+		avancer(etat_, instant, valeurs, premier);
+		// l'échantillon n'est lisible qu'une fois écrit
+		entete(blocs_ - 1).echantillons++;
+		echantillons_++;
+	}
+
+	// place le curseur sur le plus ancien échantillon
+	void debut(Curseur &c) const
+	{
+		c = Curseur();
+		c.bloc = plus_ancien();
+	}
+
+	// place le curseur au début du bloc qui contient l'instant depuis_ms : seuls les en-têtes des
+	// blocs sont lus, les échantillons antérieurs de ce bloc restent à sauter
+	void debut(Curseur &c, uint64_t depuis_ms) const
+	{
+		debut(c);
+		for (uint32_t b = c.bloc + 1; b < blocs_ && uint64_t(entete(b).instant) * RESOLUTION_MS <= depuis_ms; b++)
+			c.bloc = b;
+	}
+
+	// échantillon suivant du curseur ; false quand tous les échantillons écrits ont été lus
+	// (un appel ultérieur lira ceux ajoutés depuis)
+	bool suivant(Curseur &c, uint64_t &instant_ms, uint32_t (&valeurs)[COLONNES]) const
+	{
+		for (;;)
+		{
+			if (c.bloc < plus_ancien())
+			{
+				// bloc écrasé pendant la lecture
+				c.bloc = plus_ancien();
+				c.rang = 0;
+			}
+			if (c.bloc >= blocs_)
+				return false;
+			const EnteteBloc &e = entete(c.bloc);
+			if (c.rang < e.echantillons)
+			{
+				const uint8_t *d = bloc(c.bloc) + sizeof(EnteteBloc);
+				if (c.rang == 0)
+				{
+					c.etat = Etat();
+					c.etat.instant = e.instant;
+					c.bit = 0;
+				}
+				uint32_t codes[COLONNES + 1];
+				for (uint32_t &z : codes)
+					z = lire_code(d, c.bit);
+				if (c.bit > BITS_BLOC)
+				{
+					// nombre d'échantillons incohérent avec les données (bloc réécrit sous le
+					// lecteur) : bloc abandonné
+					c.bit = BITS_BLOC;
+					c.rang = e.echantillons;
+					continue;
+				}
+				decoder(c.etat, codes, c.rang == 0, valeurs);
+				c.rang++;
+				instant_ms = uint64_t(c.etat.instant) * RESOLUTION_MS;
+				return true;
+			}
+			if (c.bloc + 1 >= blocs_)
+				return false;
+			c.bloc++;
+			c.rang = 0;
+		}
+	}
+
+	// échantillons présents dans la zone
+	size_t echantillons() const
+	{
+		size_t n = 0;
+		for (uint32_t b = plus_ancien(); b < blocs_; b++)
+			n += entete(b).echantillons;
+		return n;
+	}
+	// octets occupés par ces échantillons
+	size_t octets() const
+	{
+		if (blocs_ == 0)
+			return 0;
+		return (blocs_ - 1 - plus_ancien()) * TAILLE_BLOC + sizeof(EnteteBloc) + (position_ + 7) / 8;
+	}
+	// échantillons ajoutés depuis le démarrage
+	uint32_t total() const { return echantillons_; }
+	// instant du dernier échantillon ; false si la série est vide
+	bool dernier(uint64_t &instant_ms) const
+	{
+		if (blocs_ == 0)
+			return false;
+		instant_ms = uint64_t(etat_.instant) * RESOLUTION_MS;
+		return true;
+	}
+
+ protected:
+	uint32_t plus_ancien() const { return blocs_ > nb_blocs_ ? blocs_ - nb_blocs_ : 0; }
+	uint8_t *bloc(uint32_t b) { return zone_ + (b % nb_blocs_) * TAILLE_BLOC; }
+	const uint8_t *bloc(uint32_t b) const { return zone_ + (b % nb_blocs_) * TAILLE_BLOC; }
+	EnteteBloc &entete(uint32_t b) { return *reinterpret_cast<EnteteBloc *>(bloc(b)); }
+	const EnteteBloc &entete(uint32_t b) const { return *reinterpret_cast<const EnteteBloc *>(bloc(b)); }
+
+	bool cumulative(uint8_t c) const { return (cumulatives_ >> c) & 1; }
+
+	// codes[0] : instant, puis une valeur par colonne ; le premier échantillon d'un bloc n'a pas
+	// d'instant (celui de l'en-tête, code nul) et ses valeurs sont écrites telles quelles
+	void coder(const Etat &s, uint32_t instant, const uint32_t (&valeurs)[COLONNES], uint32_t (&codes)[COLONNES + 1],
+		bool premier) const
+	{
+		int32_t ecart = static_cast<int32_t>(instant - s.instant);
+		codes[0] = premier ? 0 : zigzag(ecart - s.ecart);
+		for (uint8_t c = 0; c < COLONNES; c++)
+		{
+			int32_t delta = static_cast<int32_t>(valeurs[c] - s.valeurs[c]);
+			codes[c + 1] = zigzag(premier || !cumulative(c) ? delta : delta - s.deltas[c]);
+		}
+	}
+
+	void avancer(Etat &s, uint32_t instant, const uint32_t (&valeurs)[COLONNES], bool premier) const
+	{
+		s.ecart = static_cast<int32_t>(instant - s.instant);
+		s.instant = instant;
+		for (uint8_t c = 0; c < COLONNES; c++)
+		{
+			s.deltas[c] = premier ? 0 : static_cast<int32_t>(valeurs[c] - s.valeurs[c]);
+			s.valeurs[c] = valeurs[c];
+		}
+	}
+
+	void decoder(Etat &s, const uint32_t (&codes)[COLONNES + 1], bool premier, uint32_t (&valeurs)[COLONNES]) const
+	{
+		if (!premier)
+		{
+			s.ecart += dezigzag(codes[0]);
+			s.instant += static_cast<uint32_t>(s.ecart);
+		}
+		for (uint8_t c = 0; c < COLONNES; c++)
+		{
+			int32_t delta = dezigzag(codes[c + 1]);
+			if (!premier && cumulative(c))
+				delta += s.deltas[c];
+			s.deltas[c] = premier ? 0 : delta;
+			s.valeurs[c] += static_cast<uint32_t>(delta);
+			valeurs[c] = s.valeurs[c];
+		}
+	}
+
+	uint8_t *zone_ = nullptr;
+	uint32_t nb_blocs_ = 0;
+	uint32_t cumulatives_ = 0;
+	uint32_t blocs_ = 0;		// blocs commencés depuis le démarrage
+	uint32_t echantillons_ = 0;
+	size_t position_ = 0;		// bits écrits dans le bloc courant
+	Etat etat_;
+};
+
+// Export texte d'une série, CSV ou JSON, produit à la demande dans le tampon de l'appelant (réponse
+// HTTP en morceaux) : seule la ligne en cours est gardée, quelle que soit la taille de l'export.
+//   CSV  : t_ms,PAPP,IINST puis une ligne par échantillon
+//   JSON : {"colonnes":["t_ms","PAPP","IINST"],"lignes":[[123400,450,2],...]}
+// L'export s'arrête au dernier échantillon présent au moment de commencer().
+template<uint8_t COLONNES>
+class Export {
+ public:
+	enum Format : uint8_t { CSV, JSON };
+
+	// noms : nom de chaque colonne de la série ; colonnes : masque des colonnes exportées ;
+	// seuls les échantillons de [depuis_ms, jusqua_ms] sont exportés
+	void commencer(const Serie<COLONNES> &serie, const char *const *noms, uint32_t colonnes, uint64_t depuis_ms,
+		uint64_t jusqua_ms, Format format)
+	{
+		serie_ = &serie;
+		noms_ = noms;
+		colonnes_ = colonnes;
+		depuis_ = depuis_ms;
+		uint64_t dernier;
+		jusqua_ = serie.dernier(dernier) && dernier < jusqua_ms ? dernier : jusqua_ms;
+		format_ = format;
+		serie.debut(curseur_, depuis_ms);
+		etape_ = EN_TETE;
+		longueur_ = position_ = 0;
+		lignes_ = 0;
+		octets_ = 0;
+	}
+
+	// copie la suite de l'export dans dest (au plus taille octets) ; 0 quand il est terminé
+	size_t remplir(uint8_t *dest, size_t taille)
+	{
+		size_t n = 0;
+		while (n < taille)
+		{
+			if (position_ == longueur_ && !preparer())
+				break;
+			size_t k = longueur_ - position_ < taille - n ? longueur_ - position_ : taille - n;
+			memcpy(dest + n, ligne_ + position_, k);
+			position_ += k;
+			n += k;
+		}
+		octets_ += n;
+		return n;
+	}
+
+	uint32_t lignes() const { return lignes_; }
+	size_t octets() const { return octets_; }
+
+ protected:
+	enum Etape : uint8_t { EN_TETE, LIGNES, TERMINE };
+
+	// ligne suivante dans ligne_ ; false à la fin
+	bool preparer()
+	{
+		longueur_ = position_ = 0;
+		if (etape_ == EN_TETE)
+		{
+			ajouter(format_ == JSON ? "{\"colonnes\":[\"t_ms\"" : "t_ms");
+			for (uint8_t c = 0; c < COLONNES; c++)
+				if ((colonnes_ >> c) & 1)
+				{
+					ajouter(format_ == JSON ? ",\"" : ",");
+					ajouter(noms_[c]);
+					if (format_ == JSON)
+						ajouter("\"");
+				}
+			ajouter(format_ == JSON ? "],\"lignes\":[" : "\n");
+			etape_ = LIGNES;
+			return true;
+		}
+		if (etape_ == TERMINE)
+			return false;
+		uint64_t instant;
+		uint32_t valeurs[COLONNES];
+		while (serie_->suivant(curseur_, instant, valeurs) && instant <= jusqua_)
+		{
+			if (instant < depuis_)
+				continue;
+			char nombre[24];
+			ajouter(format_ == CSV ? "" : lignes_ == 0 ? "[" : ",[");
+			ajouter(decimal(nombre, instant));
+			for (uint8_t c = 0; c < COLONNES; c++)
+				if ((colonnes_ >> c) & 1)
+				{
+					ajouter(",");
+					ajouter(decimal(nombre, valeurs[c]));
+				}
+			ajouter(format_ == JSON ? "]" : "\n");
+			lignes_++;
+			return true;
+		}
+		etape_ = TERMINE;
+		if (format_ == CSV)
+			return false;
+		ajouter("]}\n");
+		return true;
+	}
+
+	void ajouter(const char *texte)
+	{
+		while (*texte != '\0' && longueur_ < sizeof(ligne_))
+			ligne_[longueur_++] = *texte++;
+	}
+
+	static const char *decimal(char (&tampon)[24], uint64_t v)
+	{
+		char *p = tampon + sizeof(tampon) - 1;
+		*p = '\0';
+		do
+		{
+			*--p = static_cast<char>('0' + v % 10);
+			v /= 10;
+		} while (v != 0);
+		return p;
+	}
+
+	const Serie<COLONNES> *serie_ = nullptr;
+	const char *const *noms_ = nullptr;
+	uint32_t colonnes_ = 0;
+	uint64_t depuis_ = 0;
+	uint64_t jusqua_ = 0;
+	Format format_ = CSV;
+	Etape etape_ = TERMINE;
+	typename Serie<COLONNES>::Curseur curseur_;
+	// en-tête JSON : noms de 8 caractères au plus (étiquettes TIC)
+	char ligne_[32 + 12 * COLONNES];
+	size_t longueur_ = 0;
+	size_t position_ = 0;
+	uint32_t lignes_ = 0;
+	size_t octets_ = 0;
+};
+
+}  // namespace serie
+}  // namespace teleinfo
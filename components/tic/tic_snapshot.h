@@ -0,0 +1,119 @@
+#pragma once
+
+// Publication d'une valeur entière (trame, instantané) par un écrivain unique à des lecteurs
+// qui ne le bloquent jamais : variante à deux copies du seqlock.
+//
+// L'écrivain remplit la copie inactive, encadrée par sa séquence (impaire pendant l'écriture),
+// puis incrémente la génération qui la désigne. Un lecteur copie la dernière copie publiée et
+// vérifie que sa séquence n'a pas bougé ; il ne recommence que si l'écrivain a publié deux fois
+// pendant sa lecture. La structure est de taille fixe et sans pointeur : elle peut résider en
+// mémoire partagée entre processus si les atomiques 32 bits y sont sans verrou, ce que vérifie
+// tools/tic_shm.h.
+//
+// L'écrivain peut aussi remplir la copie inactive en place, sans valeur intermédiaire : ouvrir()
+// la rend, initialisée avec la dernière valeur publiée, et publier() la publie. Elle peut rester
+// ouverte longtemps (trame en cours de réception) : les lecteurs lisent l'autre copie.
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace teleinfo {
+
+template<typename T>
+class Instantane {
+	static_assert(std::is_trivially_copyable<T>::value, "copie octet par octet");
+
+ public:
+	// écrivain unique
+	void publier(const T &valeur)
+	{
+		uint32_t g = generation_.load(std::memory_order_relaxed) + 1;
+		Copie &c = copies_[g & 1];
+		uint32_t s = c.sequence.load(std::memory_order_relaxed);
+		c.sequence.store(s + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(&c.valeur, &valeur, sizeof(T));
+		c.sequence.store(s + 2, std::memory_order_release);
+		generation_.store(g, std::memory_order_release);
+	}
+
+	// copie inactive, à modifier en place puis à publier() ; rouvrir sans publier repart de la
+	// dernière valeur publiée
+	T &ouvrir()
+	{
+		uint32_t g = generation_.load(std::memory_order_relaxed);
+		Copie &c = copies_[(g + 1) & 1];
+		uint32_t s = c.sequence.load(std::memory_order_relaxed);
+		if (!(s & 1))
+			c.sequence.store(s + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(&c.valeur, &copies_[g & 1].valeur, sizeof(T));
+		return c.valeur;
+	}
+
+	// publie la copie ouverte par ouvrir()
+	void publier()
+	{
+		uint32_t g = generation_.load(std::memory_order_relaxed) + 1;
+		Copie &c = copies_[g & 1];
+		c.sequence.store(c.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		generation_.store(g, std::memory_order_release);
+	}
+
+	// nombre de publications, pour détecter une nouvelle valeur sans la copier
+	uint32_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+	// copie cohérente de la dernière valeur publiée ; retourne sa génération (0 = jamais publiée)
+	uint32_t lire(T &valeur) const
+	{
+		for (;;)
+		{
+			uint32_t g = generation_.load(std::memory_order_acquire);
+			const Copie &c = copies_[g & 1];
+			uint32_t s = c.sequence.load(std::memory_order_acquire);
+			if (s & 1)
+				continue;
+			// lecture concurrente d'une écriture possible : la copie est écartée si la séquence a changé
+			memcpy(&valeur, &c.valeur, sizeof(T));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (c.sequence.load(std::memory_order_relaxed) == s)
+				return g;
+		}
+	}
+
+	// lecture en place de la dernière valeur publiée, sans la copier : extraire(const T &) ne doit
+	// que recopier les quelques champs voulus. Il est rappelé si l'écrivain a publié pendant la
+	// lecture, seul le dernier appel est cohérent. Retourne la génération (0 : jamais publiée,
+	// extraire n'est pas appelé).
+	template<typename F>
+	uint32_t lire_en_place(F &&extraire) const
+	{
+		for (;;)
+		{
+			uint32_t g = generation_.load(std::memory_order_acquire);
+			if (g == 0)
+				return 0;
+			const Copie &c = copies_[g & 1];
+			uint32_t s = c.sequence.load(std::memory_order_acquire);
+			if (s & 1)
+				continue;
+			extraire(static_cast<const T &>(c.valeur));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (c.sequence.load(std::memory_order_relaxed) == s)
+				return g;
+		}
+	}
+
+ protected:
+	struct Copie {
+		std::atomic<uint32_t> sequence{0};
+		T valeur{};
+	};
+
+	std::atomic<uint32_t> generation_{0};
+	Copie copies_[2];
+};
+
+}  // namespace teleinfo
@@ -0,0 +1,248 @@
+#pragma once
+
+// Périodes tarifaires et coût de l'énergie. Le compteur tient un index par période (HCHC/HCHP,
+// EJPHN/EJPHPM, BBRH** pour Tempo en historique ; EASF01 à EASF10 en standard) : l'énergie d'une
+// période est exactement l'accroissement de son index, sans dépendre de l'instant où PTEC change.
+// Couts cumule cet accroissement multiplié par le prix de la période, en entiers, à chaque
+// changement d'index.
+//
+// Historique : PTEC donne l'index en cours et la couleur Tempo du jour, DEMAIN celle du lendemain.
+// Standard : NTARF donne l'index en cours, LTARF le nom de la période, les bits 24 à 27 de STGE
+// les couleurs Tempo du jour et du lendemain.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "tic_parser.h"
+
+namespace teleinfo {
+namespace tarif {
+
+enum class Couleur : uint8_t { INCONNUE, BLEU, BLANC, ROUGE };
+
+constexpr const char *NOMS_COULEURS[] = {"inconnue", "bleu", "blanc", "rouge"};
+
+// prix en dix-millièmes d'euro par kWh (0,2516 €/kWh : 2516) ; coûts en 1e-7 € (prix x Wh)
+constexpr uint32_t PRIX_UNITE = 10000;
+constexpr double COUT_UNITE = 1e-7;
+
+// index de la période en cours : PTEC en historique, NTARF (EASF01 à EASF10) en standard ; INCONNUE si aucun
+inline Label index_en_cours(const Trame &t)
+{
+	if (t.recue(Label::NTARF))
+	{
+		// EASF07 à EASF10 suivent STGE dans l'enum
+		static constexpr Label EASF[] = {Label::EASF01, Label::EASF02, Label::EASF03, Label::EASF04, Label::EASF05,
+			Label::EASF06, Label::EASF07, Label::EASF08, Label::EASF09, Label::EASF10};
+		uint32_t n = t.valeur(Label::NTARF);
+		return n >= 1 && n <= 10 ? EASF[n - 1] : Label::INCONNUE;
+	}
+	if (!t.recue(Label::PTEC))
+		return Label::INCONNUE;
+	// PTEC : TH.. (base), HC.., HP.., HN.. et PM.. (EJP), HCJB, HPJW... (Tempo)
+	static constexpr struct {
+		char ptec[5];
+		Label index;
+	} TABLE[] = {
+		{"TH..", Label::BASE}, {"HC..", Label::HCHC}, {"HP..", Label::HCHP}, {"HN..", Label::EJPHN},
+		{"PM..", Label::EJPHPM}, {"HCJB", Label::BBRHCJB}, {"HPJB", Label::BBRHPJB}, {"HCJW", Label::BBRHCJW},
+		{"HPJW", Label::BBRHPJW}, {"HCJR", Label::BBRHCJR}, {"HPJR", Label::BBRHPJR},
+	};
+	const char *ptec = t.texte(Label::PTEC);
+	for (const auto &e : TABLE)
+		if (strncmp(ptec, e.ptec, 4) == 0)
+			return e.index;
+	return Label::INCONNUE;
+}
+
+// couleur Tempo d'un index historique (INCONNUE hors Tempo)
+inline Couleur couleur(Label index)
+{
+	switch (index)
+	{
+		case Label::BBRHCJB:
+		case Label::BBRHPJB:
+			return Couleur::BLEU;
+		case Label::BBRHCJW:
+		case Label::BBRHPJW:
+			return Couleur::BLANC;
+		case Label::BBRHCJR:
+		case Label::BBRHPJR:
+			return Couleur::ROUGE;
+		default:
+			return Couleur::INCONNUE;
+	}
+}
+
+// STGE (standard) : couleur Tempo du jour aux bits 24-25, du lendemain aux bits 26-27 ; 0 sans
+// annonce, puis bleu, blanc, rouge dans l'ordre de Couleur
+constexpr uint8_t STGE_JOUR = 24;
+constexpr uint8_t STGE_DEMAIN = 26;
+
+inline Couleur couleur_stge(const Trame &t, uint8_t decalage)
+{
+	if (!t.recue(Label::STGE))
+		return Couleur::INCONNUE;
+	const char *stge = t.texte(Label::STGE);
+	return static_cast<Couleur>((hexadecimal(stge, strlen(stge)) >> decalage) & 3);
+}
+
+// couleur Tempo du jour : celle de l'index en cours (PTEC) en historique, STGE en standard
+inline Couleur couleur_jour(const Trame &t)
+{
+	if (t.recue(Label::STGE))
+		return couleur_stge(t, STGE_JOUR);
+	return couleur(index_en_cours(t));
+}
+
+// couleur du lendemain (DEMAIN : "----" tant qu'elle n'est pas annoncée, BLEU, BLAN, ROUG ; STGE en
+// standard)
+inline Couleur couleur_demain(const Trame &t)
+{
+	if (!t.recue(Label::DEMAIN))
+		return couleur_stge(t, STGE_DEMAIN);
+	const char *d = t.texte(Label::DEMAIN);
+	if (strncmp(d, "BLEU", 4) == 0)
+		return Couleur::BLEU;
+	if (strncmp(d, "BLAN", 4) == 0)
+		return Couleur::BLANC;
+	if (strncmp(d, "ROUG", 4) == 0)
+		return Couleur::ROUGE;
+	return Couleur::INCONNUE;
+}
+
+// nom lisible de la période d'un index ("HC", "HP bleu", "pointe mobile"...)
+inline const char *nom_periode(Label index)
+{
+	switch (index)
+	{
+		case Label::BASE:
+		case Label::EAST:
+			return "base";
+		case Label::HCHC:
+			return "HC";
+		case Label::HCHP:
+			return "HP";
+		case Label::EJPHN:
+			return "heures normales";
+		case Label::EJPHPM:
+			return "pointe mobile";
+		case Label::BBRHCJB:
+			return "HC bleu";
+		case Label::BBRHPJB:
+			return "HP bleu";
+		case Label::BBRHCJW:
+			return "HC blanc";
+		case Label::BBRHPJW:
+			return "HP blanc";
+		case Label::BBRHCJR:
+			return "HC rouge";
+		case Label::BBRHPJR:
+			return "HP rouge";
+		case Label::INCONNUE:
+			return "inconnue";
+		default:
+			// EASF01 à EASF10 : la période dépend du contrat, LTARF la nomme (ci-dessous)
+			return NOMS[static_cast<uint8_t>(index)];
+	}
+}
+
+// nom de la période en cours : LTARF en standard, sans les espaces de cadrage et les mots de plus
+// de deux lettres en minuscules ("    HC  BLEU    " : "HC bleu") ; nom de l'index en cours sinon
+inline void nom_periode(const Trame &t, char (&nom)[TAILLE_TEXTE + 1])
+{
+	size_t n = 0;
+	const char *s = t.recue(Label::LTARF) ? t.texte(Label::LTARF) : "";
+	while (n < TAILLE_TEXTE)
+	{
+		while (*s == ' ')
+			s++;
+		const char *mot = s;
+		while (*s != '\0' && *s != ' ')
+			s++;
+		size_t l = s - mot;
+		if (l == 0)
+			break;
+		if (n > 0)
+			nom[n++] = ' ';
+		for (size_t i = 0; i < l && n < TAILLE_TEXTE; i++)
+			nom[n++] = l > 2 && mot[i] >= 'A' && mot[i] <= 'Z' ? mot[i] - 'A' + 'a' : mot[i];
+	}
+	nom[n] = '\0';
+	if (n == 0)
+	{
+		strncpy(nom, nom_periode(index_en_cours(t)), TAILLE_TEXTE);
+		nom[TAILLE_TEXTE] = '\0';
+	}
+}
+
+// Coût cumulé de N index, chacun à son prix.
+template<uint8_t N>
+class Couts {
+ public:
+	// état à sauvegarder : l'index de référence rattrape au redémarrage l'énergie consommée
+	// depuis la dernière sauvegarde, qui n'est donc jamais perdue
+	struct Totaux {
+		uint32_t index[N];		// Wh, 0 si jamais reçu
+		uint64_t couts[N];		// COUT_UNITE
+	};
+
+	void configurer(uint8_t i, Label index, uint32_t prix)
+	{
+		labels_[i] = index;
+		prix_[i] = prix;
+	}
+
+	void restaurer(const Totaux &t) { totaux_ = t; }
+	const Totaux &totaux() const { return totaux_; }
+
+	// à chaque trame ; retourne le masque des index dont le coût a changé
+	uint32_t ajouter(const Trame &t)
+	{
+		uint32_t changes = 0;
+		for (uint8_t i = 0; i < N; i++)
+		{
+			if (!t.recue(labels_[i]))
+				continue;
+			uint32_t v = t.valeur(labels_[i]);
+			uint32_t &ref = totaux_.index[i];
+			// premier index reçu ou compteur remplacé : nouvelle référence
+			if (ref != 0 && v > ref)
+			{
+				totaux_.couts[i] += uint64_t(v - ref) * prix_[i];
+				changes |= uint32_t(1) << i;
+			}
+			ref = v;
+		}
+		return changes;
+	}
+
+	uint64_t cout(uint8_t i) const { return totaux_.couts[i]; }
+	uint64_t cout_total() const
+	{
+		uint64_t total = 0;
+		for (uint8_t i = 0; i < N; i++)
+			total += totaux_.couts[i];
+		return total;
+	}
+
+	// rang du prix de l'index, N s'il n'a pas de prix
+	uint8_t rang(Label index) const
+	{
+		uint8_t i = 0;
+		while (i < N && labels_[i] != index)
+			i++;
+		return i;
+	}
+	uint32_t prix(uint8_t i) const { return prix_[i]; }
+	Label label(uint8_t i) const { return labels_[i]; }
+
+ protected:
+	Label labels_[N] = {};
+	uint32_t prix_[N] = {};
+	Totaux totaux_ = {};
+};
+
+}  // namespace tarif
+}  // namespace teleinfo
@@ -0,0 +1,130 @@
+#pragma once
+
+// Tendance de l'intensité et de la puissance sur les dernières trames, pour prévoir un
+// dépassement avant ADPS : droite des moindres carrés sur une fenêtre glissante, prolongée de
+// quelques secondes.
+//
+// En entiers, temps et mémoire constants par trame : l'abscisse est le rang de l'échantillon
+// dans la fenêtre (0 pour le plus ancien), si bien que Σx et Σx² ne dépendent que du nombre
+// d'échantillons ; Σy et Σxy se mettent à jour en retirant le plus ancien (Σxy perd Σy, chaque
+// rang reculant de 1). La période des trames, mesurée sur la fenêtre, convertit l'horizon en
+// rangs. Pente et prévision sont en 1/256 (virgule fixe Q8).
+
+#include <cstddef>
+#include <cstdint>
+
+namespace teleinfo {
+namespace tendance {
+
+constexpr uint32_t ECART_MAX = 10000;	// ms entre deux trames, au-delà la fenêtre repart de zéro
+constexpr uint8_t ECHANTILLONS_MIN = 3;
+
+// régression sur les FENETRE dernières valeurs
+template<uint8_t FENETRE>
+class Droite {
+	static_assert(FENETRE >= ECHANTILLONS_MIN, "fenêtre trop courte");
+
+ public:
+	void vider()
+	{
+		n_ = debut_ = 0;
+		s0_ = s1_ = 0;
+	}
+
+	void ajouter(int32_t y)
+	{
+		if (n_ == FENETRE)
+		{
+			int32_t ancien = y_[debut_];
+			s1_ += int64_t(FENETRE - 1) * y - (s0_ - ancien);
+			s0_ += y - ancien;
+			y_[debut_] = y;
+			debut_ = (debut_ + 1) % FENETRE;
+			return;
+		}
+		s1_ += int64_t(n_) * y;
+		s0_ += y;
+		y_[(debut_ + n_) % FENETRE] = y;
+		n_++;
+	}
+
+	uint8_t echantillons() const { return n_; }
+
+	// pente en 1/256 d'unité par rang
+	int64_t pente_q8() const
+	{
+		int64_t n = n_, sx = n * (n - 1) / 2, sxx = (n - 1) * n * (2 * n - 1) / 6;
+		int64_t d = n * sxx - sx * sx;
+		return d != 0 ? (n * s1_ - sx * s0_) * 256 / d : 0;
+	}
+
+	// valeur de la droite k_q8 / 256 rangs après le dernier échantillon, en 1/256
+	int64_t prevoir_q8(int64_t k_q8) const
+	{
+		if (n_ == 0)
+			return 0;
+		int64_t n = n_, b = pente_q8();
+		int64_t a = (s0_ * 256 - b * (n * (n - 1) / 2)) / n;
+		return a + b * (n - 1) + b * k_q8 / 256;
+	}
+
+ protected:
+	int32_t y_[FENETRE];
+	uint8_t n_ = 0;
+	uint8_t debut_ = 0;
+	int64_t s0_ = 0;	// Σy
+	int64_t s1_ = 0;	// Σxy
+};
+
+// intensité et puissance d'une même fenêtre de trames
+template<uint8_t FENETRE>
+class Predicteur {
+ public:
+	void ajouter(uint32_t instant_ms, uint32_t intensite, uint32_t puissance)
+	{
+		if (intensite_.echantillons() != 0 && instant_ms - instants_[dernier_] > ECART_MAX)
+			vider();
+		uint8_t n = intensite_.echantillons();
+		if (n == FENETRE)
+			premier_ = (premier_ + 1) % FENETRE;
+		dernier_ = (premier_ + (n == FENETRE ? n - 1 : n)) % FENETRE;
+		instants_[dernier_] = instant_ms;
+		intensite_.ajouter(static_cast<int32_t>(intensite));
+		puissance_.ajouter(static_cast<int32_t>(puissance));
+	}
+
+	void vider()
+	{
+		intensite_.vider();
+		puissance_.vider();
+		premier_ = dernier_ = 0;
+	}
+
+	// Valeurs prévues dans horizon_ms, en 1/256 (A, VA) ; false tant que la fenêtre a moins de
+	// ECHANTILLONS_MIN trames
+	bool prevoir(uint32_t horizon_ms, int64_t &intensite_q8, int64_t &puissance_q8) const
+	{
+		uint8_t n = intensite_.echantillons();
+		uint32_t duree = instants_[dernier_] - instants_[premier_];
+		if (n < ECHANTILLONS_MIN || duree == 0)
+			return false;
+		// horizon en rangs : horizon / (durée / (n - 1))
+		int64_t k_q8 = int64_t(horizon_ms) * (n - 1) * 256 / duree;
+		intensite_q8 = intensite_.prevoir_q8(k_q8);
+		puissance_q8 = puissance_.prevoir_q8(k_q8);
+		return true;
+	}
+
+	const Droite<FENETRE> &intensite() const { return intensite_; }
+	const Droite<FENETRE> &puissance() const { return puissance_; }
+
+ protected:
+	Droite<FENETRE> intensite_;
+	Droite<FENETRE> puissance_;
+	uint32_t instants_[FENETRE] = {};
+	uint8_t premier_ = 0;
+	uint8_t dernier_ = 0;
+};
+
+}  // namespace tendance
+}  // namespace teleinfo
@@ -0,0 +1,34 @@
+#pragma once
+
+// Ouverture d'une liaison TIC sous Linux (termios), sans dépendance à ESPhome :
+// utilisée par la plateforme host (tic_serial.h) et par le démon tools/ticd.cpp.
+
+#include <cstdint>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace teleinfo {
+
+// Ouvre le port en lecture seule, non bloquant, en 7E1 brut au débit demandé (1200 ou 9600).
+// Un pseudo-terminal ignore la vitesse et la parité : seul le mode brut compte.
+// Retourne le descripteur, ou -1 (errno renseigné).
+inline int ouvrir_liaison(const char *port, uint32_t bauds)
+{
+	int fd = ::open(port, O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0)
+		return -1;
+	struct termios t = {};
+	tcgetattr(fd, &t);
+	cfmakeraw(&t);
+	t.c_cflag &= ~(CSIZE | CSTOPB | PARODD);
+	t.c_cflag |= CS7 | PARENB | CREAD | CLOCAL;
+	t.c_iflag |= ISTRIP;
+	speed_t vitesse = bauds == 9600 ? B9600 : B1200;
+	cfsetispeed(&t, vitesse);
+	cfsetospeed(&t, vitesse);
+	tcsetattr(fd, TCSANOW, &t);
+	return fd;
+}
+
+}  // namespace teleinfo
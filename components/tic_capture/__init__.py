@@ -0,0 +1,54 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import web_server_base
+from esphome.components.tic import CONF_TIC_ID, MODES, TicMeter, static_variable, tic_ns
+from esphome.components.web_server_base import CONF_WEB_SERVER_BASE_ID
+from esphome.const import CONF_BAUD_RATE, CONF_BUFFER_SIZE, CONF_ID, CONF_MODE, CONF_PATH
+from esphome.core import CORE
+
+DEPENDENCIES = ["tic", "network"]
+AUTO_LOAD = ["web_server_base"]
+MULTI_CONF = True
+
+TicCaptureHandler = tic_ns.class_("TicCaptureHandler", cg.Component)
+
+
+def _chemin(value):
+    value = cv.string_strict(value)
+    if not value.startswith("/"):
+        raise cv.Invalid("le chemin doit commencer par /")
+    return value
+
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(TicCaptureHandler),
+        cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(web_server_base.WebServerBase),
+        cv.Required(CONF_TIC_ID): cv.use_id(TicMeter),
+        # environ 126 octets par seconde en historique, 1 ko en standard
+        cv.Optional(CONF_BUFFER_SIZE, default="16kB"): cv.All(
+            cv.validate_bytes, cv.int_range(min=1024)
+        ),
+        cv.Optional(CONF_PATH, default="/tic/capture"): _chemin,
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+def _bauds(tic_id):
+    """Débit du compteur, inscrit dans l'en-tête de la capture (0 = inconnu, mode auto)."""
+    for conf in CORE.config.get("tic", []):
+        if conf[CONF_ID].id == tic_id.id:
+            return conf.get(CONF_BAUD_RATE) or MODES[conf[CONF_MODE]][1] or 0
+    return 0
+
+
+async def to_code(config):
+    var = static_variable(config[CONF_ID], TicCaptureHandler)
+    await cg.register_component(var, config)
+
+    base = await cg.get_variable(config[CONF_WEB_SERVER_BASE_ID])
+    cg.add(var.set_web_server(base))
+    compteur = await cg.get_variable(config[CONF_TIC_ID])
+    cg.add(var.set_compteur(compteur, _bauds(config[CONF_TIC_ID])))
+    cg.add(var.set_taille(config[CONF_BUFFER_SIZE]))
+    cg.add(var.set_chemin(config[CONF_PATH]))
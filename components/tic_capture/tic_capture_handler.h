@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/components/web_server_base/web_server_base.h"
+#include "esphome/components/tic/my_tic_component.h"
+
+#ifndef USE_ARDUINO
+#include <esp_http_server.h>
+#endif
+
+namespace esphome {
+namespace tic {
+
+// Enregistreur des octets reçus par un compteur : anneau en RAM (PSRAM de l'ESP32 si présente),
+// alloué une fois au démarrage et rempli par TicMeter::update() avant décodage. GET sur le chemin
+// configuré télécharge la capture (.ticc, cf. tic_capture.h), à rejouer avec tools/tic_replay.
+class TicCaptureHandler : public AsyncWebHandler, public Component {
+ public:
+	static constexpr size_t TAMPON = 512;
+
+	void set_web_server(web_server_base::WebServerBase *base) { base_ = base; }
+	void set_compteur(TicMeter *compteur, uint16_t bauds)
+	{
+		compteur_ = compteur;
+		bauds_ = bauds;
+	}
+	void set_taille(size_t taille) { taille_ = taille; }
+	void set_chemin(const char *chemin) { chemin_ = chemin; }
+
+	// l'anneau doit exister avant le premier update() du compteur
+	float get_setup_priority() const override { return setup_priority::WIFI - 1.0f; }
+
+	void setup() override
+	{
+		ExternalRAMAllocator<uint8_t> allocateur(ExternalRAMAllocator<uint8_t>::ALLOW_FAILURE);
+		uint8_t *zone = allocateur.allocate(taille_);
+		if (zone == nullptr)
+		{
+			ESP_LOGE("tic", "capture : %u octets non disponibles", (unsigned) taille_);
+			mark_failed();
+			return;
+		}
+		anneau_.attribuer(zone, taille_, bauds_);
+		compteur_->set_capture(&anneau_);
+		base_->init();
+		base_->add_handler(this);
+	}
+
+	void dump_config() override
+	{
+		ESP_LOGCONFIG("tic", "capture : %u octets, GET %s", (unsigned) taille_, chemin_);
+	}
+
+	bool canHandle(AsyncWebServerRequest *request) const override
+	{
+		return request->method() == HTTP_GET && request->url() == chemin_;
+	}
+
+	void handleRequest(AsyncWebServerRequest *request) override
+	{
+		if (telechargement_.exchange(true))
+		{
+			request->send(503, "text/plain", "capture en cours de telechargement");
+			return;
+		}
+		// l'enregistrement en cours (update(), autre tâche sur l'ESP32) se termine en quelques µs ;
+		// sur l'ESP8266 la requête ne peut pas l'interrompre, geler() réussit toujours
+		while (!anneau_.geler())
+			delay(1);
+#ifdef USE_ARDUINO
+		// lu directement dans l'anneau, figé jusqu'à la fin de la connexion
+		AsyncWebServerResponse *reponse = request->beginResponse("application/octet-stream", anneau_.taille_export(),
+			[this](uint8_t *buffer, size_t taille, size_t position) -> size_t {
+				return anneau_.exporter(buffer, taille, position);
+			});
+		request->onDisconnect([this]() {
+			anneau_.degeler();
+			telechargement_ = false;
+		});
+		reponse->addHeader("Content-Disposition", "attachment; filename=\"tic.ticc\"");
+		request->send(reponse);
+#else
+		// serveur web d'ESP-IDF : envoi bloquant dans sa tâche, par morceaux lus dans l'anneau figé
+		httpd_req_t *req = *request;
+		httpd_resp_set_type(req, "application/octet-stream");
+		httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"tic.ticc\"");
+		char tampon[TAMPON];
+		size_t n;
+		for (size_t position = 0; (n = anneau_.exporter(reinterpret_cast<uint8_t *>(tampon), sizeof(tampon), position)) > 0;
+			position += n)
+			if (httpd_resp_send_chunk(req, tampon, n) != ESP_OK)
+				break;
+		httpd_resp_send_chunk(req, nullptr, 0);
+		anneau_.degeler();
+		telechargement_ = false;
+#endif
+	}
+
+ protected:
+	web_server_base::WebServerBase *base_ = nullptr;
+	TicMeter *compteur_ = nullptr;
+	uint16_t bauds_ = 0;
+	size_t taille_ = 0;
+	const char *chemin_ = "";
+	teleinfo::capture::Anneau anneau_;
+	std::atomic<bool> telechargement_{false};
+};
+
+}  // namespace tic
+}  // namespace esphome
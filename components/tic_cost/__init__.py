@@ -0,0 +1,130 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor, text_sensor
+from esphome.components.tic import (
+    CONF_TIC_ID,
+    INDEX_HISTORIQUE,
+    TIC_LABELS,
+    TicLabel,
+    TicMeter,
+    static_variable,
+    tic_ns,
+)
+from esphome.const import (
+    CONF_ID,
+    DEVICE_CLASS_MONETARY,
+    STATE_CLASS_TOTAL,
+)
+
+DEPENDENCIES = ["tic"]
+AUTO_LOAD = ["sensor", "text_sensor"]
+MULTI_CONF = True
+
+CONF_LABEL = "label"
+CONF_PRICE = "price"
+CONF_PRICES = "prices"
+CONF_COST = "cost"
+CONF_PERIOD = "period"
+CONF_TODAY = "today"
+CONF_TOMORROW = "tomorrow"
+CONF_SAVE_INTERVAL = "save_interval"
+
+TicCost = tic_ns.class_("TicCost", cg.Component)
+
+# cf. teleinfo::tarif::PRIX_UNITE (tic_tarif.h)
+PRIX_UNITE = 10000
+
+INDEX = [
+    label
+    for label in TIC_LABELS
+    if label in INDEX_HISTORIQUE or label == "EAST" or label.startswith("EASF")
+]
+
+
+def _cout(icon="mdi:currency-eur"):
+    return sensor.sensor_schema(
+        unit_of_measurement="€",
+        icon=icon,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_MONETARY,
+        state_class=STATE_CLASS_TOTAL,
+    )
+
+
+def _labels_uniques(prices):
+    labels = [p[CONF_LABEL] for p in prices]
+    if len(set(labels)) != len(labels):
+        raise cv.Invalid("un seul prix par index")
+    return prices
+
+
+PRIX_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_LABEL): cv.one_of(*INDEX, upper=True),
+        # €/kWh, 4 décimales
+        cv.Required(CONF_PRICE): cv.positive_float,
+        cv.Optional(CONF_COST): _cout(),
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(TicCost),
+        cv.Required(CONF_TIC_ID): cv.use_id(TicMeter),
+        cv.Required(CONF_PRICES): cv.All(
+            cv.ensure_list(PRIX_SCHEMA), cv.Length(min=1, max=12), _labels_uniques
+        ),
+        # coût total de tous les index
+        cv.Optional(CONF_COST): _cout(),
+        # prix de la période en cours (€/kWh)
+        cv.Optional(CONF_PRICE): sensor.sensor_schema(
+            unit_of_measurement="€/kWh",
+            icon="mdi:cash-clock",
+            accuracy_decimals=4,
+        ),
+        # période en cours d'après PTEC/LTARF : "HC", "HP blanc", "pointe mobile"...
+        cv.Optional(CONF_PERIOD): text_sensor.text_sensor_schema(icon="mdi:clock-outline"),
+        # couleurs Tempo du jour et du lendemain d'après PTEC/DEMAIN ou STGE
+        cv.Optional(CONF_TODAY): text_sensor.text_sensor_schema(icon="mdi:calendar-today"),
+        cv.Optional(CONF_TOMORROW): text_sensor.text_sensor_schema(
+            icon="mdi:calendar-arrow-right"
+        ),
+        # usure de la flash : une écriture au plus par intervalle
+        cv.Optional(
+            CONF_SAVE_INTERVAL, default="15min"
+        ): cv.positive_time_period_milliseconds,
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    prices = config[CONF_PRICES]
+    var = static_variable(config[CONF_ID], TicCost.template(len(prices)))
+    await cg.register_component(var, config)
+
+    compteur = await cg.get_variable(config[CONF_TIC_ID])
+    cg.add(var.set_compteur(compteur))
+    cg.add(var.set_nom(config[CONF_ID].id))
+    cg.add(var.set_save_interval(config[CONF_SAVE_INTERVAL]))
+    for i, conf in enumerate(prices):
+        prix = round(conf[CONF_PRICE] * PRIX_UNITE)
+        cg.add(var.set_prix(i, getattr(TicLabel, conf[CONF_LABEL]), prix))
+        if CONF_COST in conf:
+            sens = cg.Pvariable(conf[CONF_COST][CONF_ID], var.get_cout_sensor(i))
+            await sensor.register_sensor(sens, conf[CONF_COST])
+
+    if CONF_COST in config:
+        sens = cg.Pvariable(config[CONF_COST][CONF_ID], var.get_cout_sensor())
+        await sensor.register_sensor(sens, config[CONF_COST])
+    if CONF_PRICE in config:
+        sens = cg.Pvariable(config[CONF_PRICE][CONF_ID], var.get_prix_sensor())
+        await sensor.register_sensor(sens, config[CONF_PRICE])
+    if CONF_PERIOD in config:
+        sens = cg.Pvariable(config[CONF_PERIOD][CONF_ID], var.get_periode_sensor())
+        await text_sensor.register_text_sensor(sens, config[CONF_PERIOD])
+    if CONF_TODAY in config:
+        sens = cg.Pvariable(config[CONF_TODAY][CONF_ID], var.get_jour_sensor())
+        await text_sensor.register_text_sensor(sens, config[CONF_TODAY])
+    if CONF_TOMORROW in config:
+        sens = cg.Pvariable(config[CONF_TOMORROW][CONF_ID], var.get_demain_sensor())
+        await text_sensor.register_text_sensor(sens, config[CONF_TOMORROW])
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/text_sensor/text_sensor.h"
+#include "esphome/components/tic/my_tic_component.h"
+#include "esphome/components/tic/tic_tarif.h"
+
+namespace esphome {
+namespace tic {
+
+// Coût de l'énergie par période tarifaire (cf. tic_tarif.h), mis à jour à chaque trame où un index
+// avance : les capteurs de coût ne sont publiés qu'à ce moment. Les totaux et le dernier index de
+// chaque période sont sauvegardés en flash toutes les save_interval et à l'arrêt ; au redémarrage,
+// l'écart entre l'index sauvegardé et le premier reçu est compté au prix de sa période.
+template<uint8_t N>
+class TicCost : public Component {
+ public:
+	using Couts = teleinfo::tarif::Couts<N>;
+
+	void set_compteur(TicMeter *compteur) { compteur_ = compteur; }
+	// prix : cf. teleinfo::tarif::PRIX_UNITE
+	void set_prix(uint8_t i, TicLabel index, uint32_t prix) { couts_.configurer(i, index, prix); }
+	void set_nom(const char *nom) { nom_ = nom; }
+	void set_save_interval(uint32_t ms) { intervalle_ = ms; }
+
+	sensor::Sensor *get_cout_sensor() { return &sensor_cout_; }
+	sensor::Sensor *get_cout_sensor(uint8_t i) { return &sensors_couts_[i]; }
+	sensor::Sensor *get_prix_sensor() { return &sensor_prix_; }
+	text_sensor::TextSensor *get_periode_sensor() { return &sensor_periode_; }
+	text_sensor::TextSensor *get_jour_sensor() { return &sensor_jour_; }
+	text_sensor::TextSensor *get_demain_sensor() { return &sensor_demain_; }
+
+	const Couts &get_couts() const { return couts_; }
+
+	// les totaux sont restaurés avant la première trame
+	float get_setup_priority() const override { return setup_priority::DATA; }
+
+	void setup() override
+	{
+		// la clé change avec la liste des index : des totaux d'une autre liste ne sont pas relus
+		std::string cle = std::string("tic_cost") + nom_;
+		for (uint8_t i = 0; i < N; i++)
+			cle += teleinfo::NOMS[static_cast<uint8_t>(couts_.label(i))];
+		pref_ = global_preferences->make_preference<typename Couts::Totaux>(fnv1_hash(cle), true);
+		typename Couts::Totaux totaux;
+		if (pref_.load(&totaux))
+		{
+			couts_.restaurer(totaux);
+			publier_couts((uint32_t(1) << N) - 1);
+		}
+		compteur_->add_on_frame_callback([this](const TicFrame &f) { trame(f.trame); });
+	}
+
+	void loop() override
+	{
+		if (modifie_ && millis() - sauvegarde_ >= intervalle_)
+			sauvegarder();
+	}
+
+	void on_shutdown() override
+	{
+		if (modifie_)
+			sauvegarder();
+	}
+
+	void dump_config() override
+	{
+		ESP_LOGCONFIG("tic", "coût : %u périodes, sauvegarde toutes les %u s", (unsigned) N, (unsigned) (intervalle_ / 1000));
+		for (uint8_t i = 0; i < N; i++)
+			ESP_LOGCONFIG("tic", "  %s (%s) : %.4f €/kWh", teleinfo::NOMS[static_cast<uint8_t>(couts_.label(i))],
+				teleinfo::tarif::nom_periode(couts_.label(i)), (float) couts_.prix(i) / teleinfo::tarif::PRIX_UNITE);
+	}
+
+ protected:
+	void trame(const teleinfo::Trame &t)
+	{
+		using namespace teleinfo::tarif;
+		uint32_t changes = couts_.ajouter(t);
+		if (changes != 0)
+		{
+			modifie_ = true;
+			publier_couts(changes);
+		}
+		TicLabel index = index_en_cours(t);
+		char periode[teleinfo::TAILLE_TEXTE + 1];
+		nom_periode(t, periode);
+		if (index != index_ || strcmp(periode, periode_) != 0)
+		{
+			index_ = index;
+			strcpy(periode_, periode);
+			uint8_t i = couts_.rang(index);
+			sensor_periode_.publish_state(periode);
+			sensor_prix_.publish_state(i < N ? (float) couts_.prix(i) / PRIX_UNITE : NAN);
+		}
+		Couleur jour = couleur_jour(t);
+		if (jour != jour_ || !couleurs_publiees_)
+		{
+			jour_ = jour;
+			sensor_jour_.publish_state(NOMS_COULEURS[static_cast<uint8_t>(jour)]);
+		}
+		Couleur demain = couleur_demain(t);
+		if (demain != demain_ || !couleurs_publiees_)
+		{
+			demain_ = demain;
+			sensor_demain_.publish_state(NOMS_COULEURS[static_cast<uint8_t>(demain)]);
+		}
+		couleurs_publiees_ = true;
+	}
+
+	void publier_couts(uint32_t changes)
+	{
+		for (uint8_t i = 0; i < N; i++)
+			if ((changes >> i) & 1)
+				sensors_couts_[i].publish_state(couts_.cout(i) * teleinfo::tarif::COUT_UNITE);
+		sensor_cout_.publish_state(couts_.cout_total() * teleinfo::tarif::COUT_UNITE);
+	}
+
+	void sauvegarder()
+	{
+		pref_.save(&couts_.totaux());
+		modifie_ = false;
+		sauvegarde_ = millis();
+	}
+
+	TicMeter *compteur_ = nullptr;
+	const char *nom_ = "";
+	uint32_t intervalle_ = 15 * 60 * 1000;
+	Couts couts_;
+	ESPPreferenceObject pref_;
+	bool modifie_ = false;
+	uint32_t sauvegarde_ = 0;
+	TicLabel index_ = TicLabel::INCONNUE;
+	char periode_[teleinfo::TAILLE_TEXTE + 1] = "inconnue";
+	teleinfo::tarif::Couleur jour_ = teleinfo::tarif::Couleur::INCONNUE;
+	teleinfo::tarif::Couleur demain_ = teleinfo::tarif::Couleur::INCONNUE;
+	bool couleurs_publiees_ = false;
+	sensor::Sensor sensor_cout_;
+	sensor::Sensor sensors_couts_[N];
+	sensor::Sensor sensor_prix_;
+	text_sensor::TextSensor sensor_periode_;
+	text_sensor::TextSensor sensor_jour_;
+	text_sensor::TextSensor sensor_demain_;
+};
+
+}  // namespace tic
+}  // namespace esphome
@@ -0,0 +1,54 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import web_server_base
+from esphome.components.tic import static_variable, tic_ns
+from esphome.components.tic_series import TicSeries, series_type
+from esphome.components.web_server_base import CONF_WEB_SERVER_BASE_ID
+from esphome.const import CONF_ID, CONF_PATH
+from esphome.core import CORE
+
+DEPENDENCIES = ["tic_series", "network"]
+AUTO_LOAD = ["web_server_base"]
+MULTI_CONF = True
+
+CONF_SERIES_ID = "series_id"
+
+TicExport = tic_ns.class_("TicExport", cg.Component)
+
+
+def _chemin(value):
+    value = cv.string_strict(value)
+    if not value.startswith("/"):
+        raise cv.Invalid("le chemin doit commencer par /")
+    return value
+
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(TicExport),
+        cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(
+            web_server_base.WebServerBase
+        ),
+        cv.Required(CONF_SERIES_ID): cv.use_id(TicSeries),
+        cv.Optional(CONF_PATH, default="/tic/export"): _chemin,
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+def _series(series_id):
+    for conf in CORE.config.get("tic_series", []):
+        if conf[CONF_ID].id == series_id.id:
+            return conf
+    raise cv.Invalid(f"série {series_id.id} introuvable")
+
+
+async def to_code(config):
+    type_ = TicExport.template(series_type(_series(config[CONF_SERIES_ID])))
+    var = static_variable(config[CONF_ID], type_)
+    await cg.register_component(var, config)
+
+    base = await cg.get_variable(config[CONF_WEB_SERVER_BASE_ID])
+    cg.add(var.set_web_server(base))
+    series = await cg.get_variable(config[CONF_SERIES_ID])
+    cg.add(var.set_series(series))
+    cg.add(var.set_chemin(config[CONF_PATH]))
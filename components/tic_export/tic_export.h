@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/components/web_server_base/web_server_base.h"
+#include "esphome/components/tic/tic_serie.h"
+#include "esphome/components/tic_series/tic_series.h"
+
+#ifndef USE_ARDUINO
+#include <esp_http_server.h>
+#endif
+
+namespace esphome {
+namespace tic {
+
+// Export HTTP d'une série compressée (tic_series), décodée au fil de l'envoi en réponse découpée
+// en morceaux (chunked) : rien n'est construit en RAM, l'export tient dans le tampon d'envoi du
+// serveur (Arduino) ou dans TAMPON octets de pile (ESP-IDF), quelle que soit la durée demandée.
+//
+// GET <chemin>?from=&to=&last=&labels=&format=
+//   from, to : instants en ms depuis le démarrage (colonne t_ms), bornes comprises
+//   last     : les dernières secondes seulement (remplace from)
+//   labels   : étiquettes exportées parmi celles de la série, séparées par des virgules
+//   format   : csv (défaut) ou json
+// Un seul export à la fois ; durée et débit de chaque export sont journalisés. Le serveur web lit
+// la série depuis sa tâche (ESP32) : chaque morceau est décodé sous le verrou de tic_series, que
+// loop() prend pour écrire une trame, et envoyé hors verrou.
+template<typename SERIES>
+class TicExport : public AsyncWebHandler, public Component {
+ public:
+	static constexpr size_t TAMPON = 512;
+
+	void set_web_server(web_server_base::WebServerBase *base) { base_ = base; }
+	void set_series(SERIES *series) { series_ = series; }
+	void set_chemin(const char *chemin) { chemin_ = chemin; }
+
+	void setup() override
+	{
+		for (uint8_t c = 0; c < COLONNES; c++)
+			noms_[c] = teleinfo::NOMS[static_cast<uint8_t>(series_->get_label(c))];
+		base_->init();
+		base_->add_handler(this);
+	}
+
+	void dump_config() override { ESP_LOGCONFIG("tic", "export de la série : GET %s", chemin_); }
+
+	bool canHandle(AsyncWebServerRequest *request) const override
+	{
+		return request->method() == HTTP_GET && request->url() == chemin_;
+	}
+
+	void handleRequest(AsyncWebServerRequest *request) override
+	{
+		if (en_cours_.exchange(true))
+		{
+			request->send(503, "text/plain", "export en cours");
+			return;
+		}
+		const auto &serie = series_->get_serie();
+		uint64_t depuis = 0, jusqua = UINT64_MAX, dernier = 0;
+		if (request->hasParam("from"))
+			depuis = strtoull(request->getParam("from")->value().c_str(), nullptr, 10);
+		if (request->hasParam("to"))
+			jusqua = strtoull(request->getParam("to")->value().c_str(), nullptr, 10);
+		if (request->hasParam("last") && dernier_instant(dernier))
+		{
+			uint64_t duree = strtoull(request->getParam("last")->value().c_str(), nullptr, 10) * 1000;
+			depuis = dernier > duree ? dernier - duree : 0;
+		}
+		uint32_t colonnes = COLONNES < 32 ? (uint32_t(1) << COLONNES) - 1 : UINT32_MAX;
+		if (request->hasParam("labels"))
+		{
+			colonnes = selection(request->getParam("labels")->value().c_str());
+			if (colonnes == 0)
+			{
+				en_cours_ = false;
+				request->send(400, "text/plain", "etiquette absente de la serie");
+				return;
+			}
+		}
+		bool json = request->hasParam("format") && request->getParam("format")->value() == "json";
+		const char *type = json ? "application/json" : "text/csv";
+
+		{
+			LockGuard garde(series_->get_mutex());
+			export_.commencer(serie, noms_, colonnes, depuis, jusqua, json ? Export::JSON : Export::CSV);
+		}
+		debut_ = millis();
+#ifdef USE_ARDUINO
+		// chaque morceau est décodé directement dans le tampon d'envoi, quand le client l'accepte
+		AsyncWebServerResponse *reponse = request->beginChunkedResponse(type,
+			[this](uint8_t *buffer, size_t taille, size_t) -> size_t { return remplir(buffer, taille); });
+		request->onDisconnect([this]() { terminer(); });
+		request->send(reponse);
+#else
+		// serveur web d'ESP-IDF : envoi bloquant dans sa tâche, verrou libéré pendant chaque envoi
+		httpd_req_t *req = *request;
+		httpd_resp_set_type(req, type);
+		char tampon[TAMPON];
+		size_t n;
+		while ((n = remplir(reinterpret_cast<uint8_t *>(tampon), sizeof(tampon))) > 0)
+			if (httpd_resp_send_chunk(req, tampon, n) != ESP_OK)
+				break;
+		httpd_resp_send_chunk(req, nullptr, 0);
+		terminer();
+#endif
+	}
+
+ protected:
+	static constexpr uint8_t COLONNES = SERIES::Stockage::NB_COLONNES;
+	using Export = teleinfo::serie::Export<COLONNES>;
+
+	bool dernier_instant(uint64_t &instant_ms)
+	{
+		LockGuard garde(series_->get_mutex());
+		return series_->get_serie().dernier(instant_ms);
+	}
+
+	size_t remplir(uint8_t *dest, size_t taille)
+	{
+		LockGuard garde(series_->get_mutex());
+		return export_.remplir(dest, taille);
+	}
+
+	// masque des colonnes nommées dans liste ("PAPP,IINST") ; 0 si une étiquette n'est pas enregistrée
+	uint32_t selection(const char *liste) const
+	{
+		uint32_t masque = 0;
+		while (*liste != '\0')
+		{
+			const char *fin = strchr(liste, ',');
+			size_t n = fin != nullptr ? static_cast<size_t>(fin - liste) : strlen(liste);
+			uint8_t c = 0;
+			while (c < COLONNES && !(strlen(noms_[c]) == n && strncmp(noms_[c], liste, n) == 0))
+				c++;
+			if (c == COLONNES)
+				return 0;
+			masque |= uint32_t(1) << c;
+			liste += fin != nullptr ? n + 1 : n;
+		}
+		return masque;
+	}
+
+	void terminer()
+	{
+		if (!en_cours_.exchange(false))
+			return;
+		uint32_t duree = millis() - debut_;
+		ESP_LOGD("tic", "export : %u lignes, %u octets en %u ms (%.1f ko/s)", (unsigned) export_.lignes(),
+			(unsigned) export_.octets(), (unsigned) duree, duree != 0 ? export_.octets() / 1.024f / duree : 0.0f);
+	}
+
+	web_server_base::WebServerBase *base_ = nullptr;
+	SERIES *series_ = nullptr;
+	const char *chemin_ = "";
+	const char *noms_[COLONNES] = {};
+	Export export_;
+	std::atomic<bool> en_cours_{false};
+	uint32_t debut_ = 0;
+};
+
+}  // namespace tic
+}  // namespace esphome
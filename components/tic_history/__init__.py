@@ -0,0 +1,85 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import web_server_base
+from esphome.components.tic import CONF_TIC_ID, TicMeter, static_variable, tic_ns
+from esphome.components.web_server_base import CONF_WEB_SERVER_BASE_ID
+from esphome.const import CONF_ID, CONF_PATH
+
+DEPENDENCIES = ["tic", "network"]
+AUTO_LOAD = ["web_server_base"]
+MULTI_CONF = True
+
+CONF_SECONDS = "seconds"
+CONF_MINUTES = "minutes"
+CONF_QUARTER_HOURS = "quarter_hours"
+CONF_MAX_SIZE = "max_size"
+
+TicHistory = tic_ns.class_("TicHistory", cg.Component)
+
+# durée du pas de chaque palier (s) et octets par intervalle (tic_paliers.h)
+PALIERS = {
+    CONF_SECONDS: (1, 3),
+    CONF_MINUTES: (60, 6),
+    CONF_QUARTER_HOURS: (900, 6),
+}
+
+
+def _chemin(value):
+    value = cv.string_strict(value)
+    if not value.startswith("/"):
+        raise cv.Invalid("le chemin doit commencer par /")
+    return value.rstrip("/")
+
+
+def _intervalles(config):
+    return {
+        cle: max(1, config[cle].total_seconds // pas) for cle, (pas, _) in PALIERS.items()
+    }
+
+
+def _valider_taille(config):
+    n = _intervalles(config)
+    taille = sum(n[cle] * octets for cle, (_, octets) in PALIERS.items())
+    if taille > config[CONF_MAX_SIZE]:
+        raise cv.Invalid(
+            f"l'historique occupe {taille} octets, plus que {CONF_MAX_SIZE} ({config[CONF_MAX_SIZE]})"
+        )
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(TicHistory),
+            cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(
+                web_server_base.WebServerBase
+            ),
+            cv.Required(CONF_TIC_ID): cv.use_id(TicMeter),
+            # durée couverte par chaque palier
+            cv.Optional(CONF_SECONDS, default="1h"): cv.positive_time_period_seconds,
+            cv.Optional(CONF_MINUTES, default="24h"): cv.positive_time_period_seconds,
+            cv.Optional(
+                CONF_QUARTER_HOURS, default="30d"
+            ): cv.positive_time_period_seconds,
+            # 37 ko avec les durées par défaut
+            cv.Optional(CONF_MAX_SIZE, default="40kB"): cv.validate_bytes,
+            cv.Optional(CONF_PATH, default="/tic/history"): _chemin,
+        }
+    ).extend(cv.COMPONENT_SCHEMA),
+    _valider_taille,
+)
+
+
+async def to_code(config):
+    n = _intervalles(config)
+    type_ = TicHistory.template(
+        n[CONF_SECONDS], n[CONF_MINUTES], n[CONF_QUARTER_HOURS]
+    )
+    var = static_variable(config[CONF_ID], type_)
+    await cg.register_component(var, config)
+
+    base = await cg.get_variable(config[CONF_WEB_SERVER_BASE_ID])
+    cg.add(var.set_web_server(base))
+    compteur = await cg.get_variable(config[CONF_TIC_ID])
+    cg.add(var.set_compteur(compteur))
+    cg.add(var.set_chemin(config[CONF_PATH]))
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/components/web_server_base/web_server_base.h"
+#include "esphome/components/tic/my_tic_component.h"
+#include "esphome/components/tic/tic_paliers.h"
+
+#ifndef USE_ARDUINO
+#include <esp_http_server.h>
+#endif
+
+namespace esphome {
+namespace tic {
+
+// Historique en RAM de la puissance apparente et de l'intensité d'un compteur, en trois paliers
+// (cf. tic_paliers.h), alimenté à chaque trame complète par le compteur. Les instants
+// sont comptés en secondes depuis le démarrage, d'après l'heure de réception des trames.
+//
+// GET <chemin>/s, <chemin>/min ou <chemin>/15min renvoie le palier en JSON, produit au fil de
+// l'envoi (réponse en morceaux) ; ?n= limite aux n derniers intervalles. Le serveur web lit les
+// paliers depuis sa tâche (ESP32) : chaque morceau est produit sous un verrou, que la trame
+// reçue dans loop() prend aussi, et envoyé hors verrou.
+template<size_t SECONDES, size_t MINUTES, size_t QUARTS>
+class TicHistory : public AsyncWebHandler, public Component {
+ public:
+	using Stockage = teleinfo::paliers::Paliers<SECONDES, MINUTES, QUARTS>;
+
+	void set_web_server(web_server_base::WebServerBase *base) { base_ = base; }
+	void set_compteur(TicMeter *compteur) { compteur_ = compteur; }
+	void set_chemin(const char *chemin) { chemin_ = chemin; }
+
+	// accès depuis une lambda (tâche de loop(), sans verrou) :
+	//   id(historique).get_paliers().derniers(teleinfo::paliers::MINUTE, 60, [](uint32_t t, auto &a) {...});
+	const Stockage &get_paliers() const { return paliers_; }
+	// instant de la dernière trame enregistrée (s depuis le démarrage)
+	uint32_t get_seconde() const { return static_cast<uint32_t>(horloge_.ms / 1000); }
+
+	void setup() override
+	{
+		compteur_->add_on_frame_callback([this](const TicFrame &f) {
+			LockGuard garde(mutex_);
+			horloge_.prolonger(f.millis);
+			paliers_.ajouter(get_seconde(), f.trame.puissance_soutiree(), f.trame.intensite());
+		});
+		base_->init();
+		base_->add_handler(this);
+	}
+
+	void dump_config() override
+	{
+		ESP_LOGCONFIG("tic", "historique : %u s, %u min, %u x 15 min (%u octets), GET %s/{s,min,15min}",
+			(unsigned) SECONDES, (unsigned) MINUTES, (unsigned) QUARTS, (unsigned) sizeof(Stockage), chemin_);
+	}
+
+	bool canHandle(AsyncWebServerRequest *request) const override
+	{
+		teleinfo::paliers::Palier palier;
+		return request->method() == HTTP_GET && palier_demande(request, palier);
+	}
+
+	void handleRequest(AsyncWebServerRequest *request) override
+	{
+		using namespace teleinfo::paliers;
+		Palier palier = SECONDE;
+		palier_demande(request, palier);
+		uint32_t n = Stockage::TAILLE[palier];
+		if (request->hasParam("n"))
+		{
+			long v = atol(request->getParam("n")->value().c_str());
+			n = v > 0 && static_cast<uint32_t>(v) < n ? static_cast<uint32_t>(v) : n;
+		}
+		// {"pas":60,"maintenant":12345,"debut":9000,"puissance":[...],"puissance_max":[...],...}
+		// les intervalles se suivent à partir de debut ; null pour un intervalle sans trame
+		Reponse r;
+		r.palier = palier;
+		{
+			LockGuard garde(mutex_);
+			r.maintenant = get_seconde();
+			uint32_t dernier;
+			if (paliers_.dernier(palier, dernier))
+			{
+				uint32_t d = dernier / PAS[palier] + 1;
+				r.nb = d > n ? n : d;
+				r.debut = (d - r.nb) * PAS[palier];
+			}
+		}
+#ifdef USE_ARDUINO
+		request->send(request->beginChunkedResponse("application/json",
+			[this, r](uint8_t *buffer, size_t taille, size_t) mutable -> size_t { return remplir(r, buffer, taille); }));
+#else
+		httpd_req_t *req = *request;
+		httpd_resp_set_type(req, "application/json");
+		char tampon[256];
+		size_t k;
+		while ((k = remplir(r, reinterpret_cast<uint8_t *>(tampon), sizeof(tampon))) > 0)
+			if (httpd_resp_send_chunk(req, tampon, k) != ESP_OK)
+				break;
+		httpd_resp_send_chunk(req, nullptr, 0);
+#endif
+	}
+
+ protected:
+	static constexpr uint8_t CHAMPS = 4;
+
+	// Réponse JSON en cours : seul l'élément en cours d'envoi est gardé. Éléments : l'en-tête, puis
+	// pour chaque champ '[', ses nb valeurs et ']', enfin '}'.
+	struct Reponse {
+		teleinfo::paliers::Palier palier = teleinfo::paliers::SECONDE;
+		uint32_t maintenant = 0;
+		uint32_t debut = 0;
+		uint32_t nb = 0;		// intervalles
+		uint32_t element = 0;
+		char ligne[64];
+		uint8_t longueur = 0;
+		uint8_t position = 0;
+	};
+
+	// copie la suite de la réponse dans dest (au plus taille octets), sous le verrou ; 0 quand elle
+	// est terminée
+	size_t remplir(Reponse &r, uint8_t *dest, size_t taille) const
+	{
+		LockGuard garde(mutex_);
+		size_t n = 0;
+		while (n < taille)
+		{
+			if (r.position == r.longueur && !preparer(r))
+				break;
+			size_t reste = r.longueur - r.position;
+			size_t k = reste < taille - n ? reste : taille - n;
+			memcpy(dest + n, r.ligne + r.position, k);
+			r.position += k;
+			n += k;
+		}
+		return n;
+	}
+
+	// élément suivant dans r.ligne ; false à la fin
+	bool preparer(Reponse &r) const
+	{
+		using namespace teleinfo::paliers;
+		static const char *const NOMS_CHAMPS[] = {"puissance", "puissance_max", "intensite", "intensite_max"};
+		const uint32_t par_champ = r.nb + 2;
+		const uint32_t e = r.element++;
+		int k;
+		if (e == 0)
+			k = snprintf(r.ligne, sizeof(r.ligne), "{\"pas\":%u,\"maintenant\":%u,\"debut\":%u", (unsigned) PAS[r.palier],
+				(unsigned) r.maintenant, (unsigned) r.debut);
+		else if (e - 1 < CHAMPS * par_champ)
+		{
+			uint8_t c = (e - 1) / par_champ;
+			uint32_t j = (e - 1) % par_champ;
+			if (j == 0)
+				k = snprintf(r.ligne, sizeof(r.ligne), ",\"%s\":[", NOMS_CHAMPS[c]);
+			else if (j == par_champ - 1)
+				k = snprintf(r.ligne, sizeof(r.ligne), "]");
+			else
+			{
+				// intervalle écrasé depuis le début de la réponse : absent
+				Agregat a;
+				uint32_t t = r.debut + (j - 1) * PAS[r.palier];
+				paliers_.lire(r.palier, t, t, [&a](uint32_t, const Agregat &x) { a = x; });
+				unsigned v = c == 0 ? a.puissance : c == 1 ? a.puissance_max : c == 2 ? a.intensite : a.intensite_max;
+				const char *virgule = j == 1 ? "" : ",";
+				if (a.absent())
+					k = snprintf(r.ligne, sizeof(r.ligne), "%snull", virgule);
+				else
+					k = snprintf(r.ligne, sizeof(r.ligne), "%s%u", virgule, v);
+			}
+		}
+		else if (e - 1 == CHAMPS * par_champ)
+			k = snprintf(r.ligne, sizeof(r.ligne), "}");
+		else
+			return false;
+		r.longueur = static_cast<uint8_t>(k);
+		r.position = 0;
+		return true;
+	}
+
+	bool palier_demande(AsyncWebServerRequest *request, teleinfo::paliers::Palier &palier) const
+	{
+		static const char *const SUFFIXES[] = {"/s", "/min", "/15min"};
+		std::string url = request->url().c_str();
+		size_t n = strlen(chemin_);
+		if (url.compare(0, n, chemin_) != 0)
+			return false;
+		for (uint8_t p = 0; p < 3; p++)
+			if (url.compare(n, std::string::npos, SUFFIXES[p]) == 0)
+			{
+				palier = static_cast<teleinfo::paliers::Palier>(p);
+				return true;
+			}
+		return false;
+	}
+
+	web_server_base::WebServerBase *base_ = nullptr;
+	TicMeter *compteur_ = nullptr;
+	const char *chemin_ = "";
+	TicHorloge horloge_;	// le palier des quarts d'heure dépasse 49 jours
+	Stockage paliers_;
+	mutable Mutex mutex_;	// paliers et horloge, entre loop() et le serveur web
+};
+
+}  // namespace tic
+}  // namespace esphome
@@ -0,0 +1,59 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.components import time as time_
+from esphome.components.tic import CONF_TIC_ID, TicMeter, static_variable, tic_ns
+from esphome.const import (
+    CONF_DURATION,
+    CONF_ID,
+    CONF_POWER,
+    CONF_TIME_ID,
+    DEVICE_CLASS_POWER,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_WATT,
+)
+
+DEPENDENCIES = ["tic", "time"]
+AUTO_LOAD = ["sensor"]
+MULTI_CONF = True
+
+TicLoadCurve = tic_ns.class_("TicLoadCurve", cg.Component)
+
+# cf. teleinfo::courbe::PAS (tic_courbe.h)
+PAS = 1800
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(TicLoadCurve),
+        cv.Required(CONF_TIC_ID): cv.use_id(TicMeter),
+        cv.Required(CONF_TIME_ID): cv.use_id(time_.RealTimeClock),
+        # 2 octets par demi-heure : 672 octets pour 7 jours
+        cv.Optional(CONF_DURATION, default="7d"): cv.All(
+            cv.positive_time_period_seconds,
+            cv.Range(min=cv.TimePeriod(seconds=PAS), max=cv.TimePeriod(days=400)),
+        ),
+        # un point par demi-heure : puissance moyenne de la demi-heure écoulée
+        cv.Optional(CONF_POWER): sensor.sensor_schema(
+            unit_of_measurement=UNIT_WATT,
+            icon="mdi:chart-bell-curve",
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_POWER,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    points = config[CONF_DURATION].total_seconds // PAS
+    var = static_variable(config[CONF_ID], TicLoadCurve.template(points))
+    await cg.register_component(var, config)
+
+    compteur = await cg.get_variable(config[CONF_TIC_ID])
+    cg.add(var.set_compteur(compteur))
+    horloge = await cg.get_variable(config[CONF_TIME_ID])
+    cg.add(var.set_time(horloge))
+
+    if CONF_POWER in config:
+        sens = cg.Pvariable(config[CONF_POWER][CONF_ID], var.get_puissance_sensor())
+        await sensor.register_sensor(sens, config[CONF_POWER])
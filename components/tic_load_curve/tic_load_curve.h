@@ -0,0 +1,61 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/log.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/time/real_time_clock.h"
+#include "esphome/components/tic/my_tic_component.h"
+#include "esphome/components/tic/tic_courbe.h"
+
+namespace esphome {
+namespace tic {
+
+// Courbe de charge au pas de 30 minutes (cf. tic_courbe.h), calculée à chaque trame complète à
+// partir de l'énergie soutirée du compteur et de l'heure du composant time (SNTP...) : les trames
+// reçues avant que l'heure soit connue sont ignorées. Le capteur reçoit un point par demi-heure,
+// publié juste après sa fin : la puissance moyenne de la demi-heure qui vient de s'achever.
+//
+// Lecture depuis une lambda :
+//   id(courbe).get_courbe().derniers(48, [](uint32_t debut, uint16_t w) {...});
+template<size_t POINTS>
+class TicLoadCurve : public Component {
+ public:
+	using Stockage = teleinfo::courbe::Courbe<POINTS>;
+
+	void set_compteur(TicMeter *compteur) { compteur_ = compteur; }
+	void set_time(time::RealTimeClock *horloge) { time_ = horloge; }
+	sensor::Sensor *get_puissance_sensor() { return &sensor_puissance_; }
+
+	const Stockage &get_courbe() const { return courbe_; }
+
+	void setup() override
+	{
+		compteur_->add_on_frame_callback([this](const TicFrame &f) {
+			ESPTime maintenant = time_->now();
+			uint32_t index = f.trame.energie_soutiree();
+			if (!maintenant.is_valid() || index == 0)
+				return;
+			uint32_t debut;
+			uint16_t puissance;
+			if (courbe_.ajouter(static_cast<uint32_t>(maintenant.timestamp), index) && courbe_.dernier(debut, puissance))
+			{
+				ESP_LOGD("tic", "courbe de charge : %u W à partir de %u", (unsigned) puissance, (unsigned) debut);
+				sensor_puissance_.publish_state(puissance);
+			}
+		});
+	}
+
+	void dump_config() override
+	{
+		ESP_LOGCONFIG("tic", "courbe de charge : %u demi-heures (%u octets)", (unsigned) POINTS, (unsigned) sizeof(Stockage));
+	}
+
+ protected:
+	TicMeter *compteur_ = nullptr;
+	time::RealTimeClock *time_ = nullptr;
+	sensor::Sensor sensor_puissance_;
+	Stockage courbe_;
+};
+
+}  // namespace tic
+}  // namespace esphome
@@ -0,0 +1,100 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import time as time_
+from esphome.components.tic import (
+    CONF_TIC_ID,
+    TIC_LABELS,
+    TIC_TEXT_LABELS,
+    TicLabel,
+    TicMeter,
+    static_variable,
+    tic_ns,
+)
+from esphome.const import CONF_ID, CONF_PATH, CONF_TIME_ID
+from esphome.core import CORE
+
+DEPENDENCIES = ["tic"]
+MULTI_CONF = True
+
+CONF_LABELS = "labels"
+CONF_FLUSH_INTERVAL = "flush_interval"
+CONF_SEGMENT_SIZE = "segment_size"
+CONF_MAX_SIZE = "max_size"
+CONF_PARTITION = "partition"
+
+TicLog = tic_ns.class_("TicLog", cg.PollingComponent)
+
+# cf. teleinfo::journal::BLOC_FLASH (tic_journal.h)
+BLOC_FLASH = 4096
+
+NUMERIQUES = [label for label in TIC_LABELS if label not in TIC_TEXT_LABELS]
+
+
+def _chemin(value):
+    value = cv.string_strict(value)
+    if not value.startswith("/"):
+        raise cv.Invalid("le chemin doit commencer par /")
+    return value.rstrip("/")
+
+
+def _valider_tailles(config):
+    if config[CONF_MAX_SIZE] < 4 * config[CONF_SEGMENT_SIZE]:
+        raise cv.Invalid(f"{CONF_MAX_SIZE} doit valoir au moins 4 segments")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(TicLog),
+            cv.Required(CONF_TIC_ID): cv.use_id(TicMeter),
+            cv.Optional(CONF_TIME_ID): cv.use_id(time_.RealTimeClock),
+            # étiquettes numériques enregistrées à chaque update_interval
+            cv.Required(CONF_LABELS): cv.All(
+                cv.ensure_list(cv.one_of(*NUMERIQUES, upper=True)),
+                cv.Length(min=1, max=8),
+            ),
+            # usure de la flash : au plus un bloc de 4 ko réécrit par vidage
+            cv.Optional(
+                CONF_FLUSH_INTERVAL, default="5min"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_SEGMENT_SIZE, default="32kB"): cv.All(
+                cv.validate_bytes, cv.int_range(min=BLOC_FLASH)
+            ),
+            cv.Optional(CONF_MAX_SIZE, default="256kB"): cv.validate_bytes,
+            cv.Optional(CONF_PATH, default="/tic"): _chemin,
+            # partition LittleFS de l'ESP32 (table de partitions)
+            cv.Optional(CONF_PARTITION, default="spiffs"): cv.string_strict,
+        }
+    ).extend(cv.polling_component_schema("1min")),
+    _valider_tailles,
+)
+
+
+async def to_code(config):
+    labels = config[CONF_LABELS]
+    var = static_variable(config[CONF_ID], TicLog.template(len(labels)))
+    await cg.register_component(var, config)
+
+    compteur = await cg.get_variable(config[CONF_TIC_ID])
+    cg.add(var.set_compteur(compteur))
+    for i, label in enumerate(labels):
+        cg.add(var.set_colonne(i, getattr(TicLabel, label)))
+    cg.add(var.set_chemin(config[CONF_PATH]))
+    cg.add(var.set_partition(config[CONF_PARTITION]))
+    cg.add(var.set_tailles(config[CONF_SEGMENT_SIZE], config[CONF_MAX_SIZE]))
+    cg.add(var.set_flush_interval(config[CONF_FLUSH_INTERVAL]))
+    if CONF_TIME_ID in config:
+        horloge = await cg.get_variable(config[CONF_TIME_ID])
+        cg.add(var.set_time(horloge))
+
+    if CORE.using_esp_idf:
+        from esphome.components.esp32 import add_idf_component
+
+        add_idf_component(
+            name="esp_littlefs",
+            repo="https://github.com/joltwallet/esp_littlefs.git",
+            ref="v1.14.8",
+        )
+    elif CORE.using_arduino:
+        cg.add_library("LittleFS", None)
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <cstring>
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#ifdef USE_TIME
+#include "esphome/components/time/real_time_clock.h"
+#endif
+#include "esphome/components/tic/my_tic_component.h"
+#include "esphome/components/tic/tic_journal.h"
+
+#ifdef USE_ESP8266
+#include <LittleFS.h>
+#else
+#include "esphome/components/tic/tic_fichiers.h"
+#ifdef USE_ESP32
+#ifdef USE_ARDUINO
+#include <LittleFS.h>
+#else
+#include "esp_littlefs.h"
+#endif
+#endif
+#endif
+
+namespace esphome {
+namespace tic {
+
+#ifdef USE_ESP8266
+// LittleFS de l'ESP8266 : pas de VFS, API fs::FS d'Arduino
+class TicFichiers {
+ public:
+	bool ouvrir(const char *dossier)
+	{
+		dossier_ = dossier;
+		LittleFS.mkdir(dossier_);
+		return LittleFS.exists(dossier_);
+	}
+
+	long taille(const char *nom)
+	{
+		File f = LittleFS.open(chemin(nom), "r");
+		if (!f)
+			return -1;
+		long t = f.size();
+		f.close();
+		return t;
+	}
+
+	size_t lire(const char *nom, size_t position, uint8_t *dest, size_t n)
+	{
+		File f = LittleFS.open(chemin(nom), "r");
+		if (!f)
+			return 0;
+		size_t lus = f.seek(position) ? f.read(dest, n) : 0;
+		f.close();
+		return lus;
+	}
+
+	// la fermeture écrit les métadonnées du fichier
+	bool ajouter(const char *nom, const uint8_t *data, size_t n)
+	{
+		File f = LittleFS.open(chemin(nom), "a");
+		if (!f)
+			return false;
+		size_t ecrits = f.write(data, n);
+		f.close();
+		return ecrits == n;
+	}
+
+	bool tronquer(const char *nom, size_t taille)
+	{
+		File f = LittleFS.open(chemin(nom), "r+");
+		if (!f)
+			return false;
+		bool ok = f.truncate(taille);
+		f.close();
+		return ok;
+	}
+
+	bool supprimer(const char *nom) { return LittleFS.remove(chemin(nom)); }
+	bool renommer(const char *ancien, const char *nouveau) { return LittleFS.rename(chemin(ancien), chemin(nouveau)); }
+
+	template<typename F>
+	void lister(F &&rappel)
+	{
+		Dir d = LittleFS.openDir(dossier_);
+		while (d.next())
+			rappel(d.fileName().c_str(), static_cast<size_t>(d.fileSize()));
+	}
+
+ protected:
+	String chemin(const char *nom) const { return dossier_ + "/" + nom; }
+
+	String dossier_;
+};
+#else
+// ESP32 : LittleFS monté dans le VFS ; host : dossier du PC
+using TicFichiers = teleinfo::journal::FichiersPosix;
+#endif
+
+// Journal sur la flash (cf. tic_journal.h) des valeurs de quelques étiquettes : un échantillon par
+// update_interval, écrit par paquets toutes les flush_interval. Les index d'énergie retrouvés au
+// démarrage sont accessibles par get_restored() (reprise des compteurs après une coupure).
+// Flash et compaction ne sont utilisées que depuis loop() et update() de ce composant.
+template<uint8_t COLONNES>
+class TicLog : public PollingComponent {
+ public:
+	static constexpr uint8_t ECHANTILLON = 1;
+
+	// charge d'un enregistrement ECHANTILLON
+	struct Echantillon {
+		uint32_t horodatage = 0;	// heure UNIX (s), 0 si l'heure n'était pas connue
+		uint32_t secondes = 0;		// depuis le démarrage
+		uint32_t valeurs[COLONNES] = {};
+	};
+
+	void set_compteur(TicMeter *compteur) { compteur_ = compteur; }
+	void set_colonne(uint8_t c, TicLabel label) { labels_[c] = label; }
+	void set_chemin(const char *chemin) { chemin_ = chemin; }
+	void set_partition(const char *partition) { partition_ = partition; }
+	void set_tailles(size_t segment, size_t max)
+	{
+		taille_segment_ = segment;
+		taille_max_ = max;
+	}
+	void set_flush_interval(uint32_t ms) { vidage_ms_ = ms; }
+#ifdef USE_TIME
+	void set_time(time::RealTimeClock *horloge) { time_ = horloge; }
+#endif
+
+	// dernier échantillon du journal au démarrage ; false s'il n'y en avait pas
+	bool get_restored(Echantillon &e) const
+	{
+		e = reprise_;
+		return repris_;
+	}
+	teleinfo::journal::Journal<TicFichiers> &get_journal() { return journal_; }
+	TicLabel get_label(uint8_t c) const { return labels_[c]; }
+
+	float get_setup_priority() const override { return setup_priority::DATA; }
+
+	void setup() override
+	{
+		if (!monter() || !fichiers_.ouvrir(dossier_.c_str()))
+		{
+			ESP_LOGE("tic", "journal : LittleFS indisponible");
+			mark_failed();
+			return;
+		}
+		journal_.configurer(taille_segment_, taille_max_);
+		uint8_t definition[COLONNES];
+		for (uint8_t c = 0; c < COLONNES; c++)
+			definition[c] = static_cast<uint8_t>(labels_[c]);
+		journal_.set_definition(definition, COLONNES);
+		journal_.ouvrir([this](uint8_t type, const uint8_t *charge, uint8_t n) {
+			if (type != ECHANTILLON || n != sizeof(Echantillon))
+				return;
+			memcpy(&reprise_, charge, n);
+			repris_ = true;
+		});
+		compteur_->add_on_frame_callback([this](const TicFrame &f) {
+			for (uint8_t c = 0; c < COLONNES; c++)
+				valeurs_[c] = f.trame.valeur(labels_[c]);
+			recu_ = true;
+		});
+		vidage_ = millis();
+	}
+
+	void dump_config() override
+	{
+		ESP_LOGCONFIG("tic", "journal %s : %u segment(s), %u octets sur %u, %u octets tronqués à la reprise",
+			dossier_.c_str(), (unsigned) journal_.segments(), (unsigned) journal_.total(), (unsigned) taille_max_,
+			(unsigned) journal_.tronques());
+		for (uint8_t c = 0; c < COLONNES; c++)
+			ESP_LOGCONFIG("tic", "  %s", teleinfo::NOMS[static_cast<uint8_t>(labels_[c])]);
+	}
+
+	// échantillon en RAM : aucune écriture en flash ; aucun sans nouvelle trame (compteur
+	// débranché, liaison coupée)
+	void update() override
+	{
+		if (!recu_)
+			return;
+		Echantillon e;
+#ifdef USE_TIME
+		if (time_ != nullptr && time_->now().is_valid())
+			e.horodatage = static_cast<uint32_t>(time_->now().timestamp);
+#endif
+		e.secondes = millis() / 1000;
+		memcpy(e.valeurs, valeurs_, sizeof(valeurs_));
+		recu_ = false;
+		if (!journal_.ajouter(ECHANTILLON, reinterpret_cast<const uint8_t *>(&e), sizeof(e)))
+			ESP_LOGW("tic", "journal : échec d'écriture");
+	}
+
+	// vidage périodique du tampon et une étape de compaction par passage
+	void loop() override
+	{
+		if (millis() - vidage_ >= vidage_ms_)
+		{
+			vidage_ = millis();
+			if (!journal_.vider())
+				ESP_LOGW("tic", "journal : échec d'écriture");
+		}
+		journal_.compacter([](uint8_t, const uint8_t *charge, uint8_t) {
+			// une heure par enregistrement, de l'heure UNIX ou à défaut depuis le démarrage
+			uint32_t horodatage, secondes;
+			memcpy(&horodatage, charge, 4);
+			memcpy(&secondes, charge + 4, 4);
+			return horodatage != 0 ? horodatage / 3600 : 0x80000000 | (secondes / 3600);
+		});
+	}
+
+	void on_shutdown() override { journal_.vider(); }
+
+ protected:
+	bool monter()
+	{
+#if defined(USE_ESP8266)
+		dossier_ = chemin_;
+		return LittleFS.begin();
+#elif defined(USE_ESP32)
+		dossier_ = std::string("/littlefs") + chemin_;
+#ifdef USE_ARDUINO
+		return LittleFS.begin(true, "/littlefs", 5, partition_);
+#else
+		esp_vfs_littlefs_conf_t conf = {};
+		conf.base_path = "/littlefs";
+		conf.partition_label = partition_;
+		conf.format_if_mount_failed = true;
+		esp_err_t err = esp_vfs_littlefs_register(&conf);
+		return err == ESP_OK || err == ESP_ERR_INVALID_STATE;	// déjà monté
+#endif
+#else
+		// plateforme host : dossier relatif au répertoire courant
+		dossier_ = std::string(".") + chemin_;
+		return true;
+#endif
+	}
+
+	TicMeter *compteur_ = nullptr;
+	TicLabel labels_[COLONNES] = {};
+	const char *chemin_ = "/tic";
+	const char *partition_ = "spiffs";
+#ifdef USE_ESP8266
+	String dossier_;
+#else
+	std::string dossier_;
+#endif
+	size_t taille_segment_ = 32 * 1024;
+	size_t taille_max_ = 256 * 1024;
+	uint32_t vidage_ms_ = 5 * 60 * 1000;
+	uint32_t vidage_ = 0;
+#ifdef USE_TIME
+	time::RealTimeClock *time_ = nullptr;
+#endif
+	uint32_t valeurs_[COLONNES] = {};
+	bool recu_ = false;
+	Echantillon reprise_;
+	bool repris_ = false;
+	TicFichiers fichiers_;
+	teleinfo::journal::Journal<TicFichiers> journal_{fichiers_};
+};
+
+}  // namespace tic
+}  // namespace esphome
@@ -0,0 +1,74 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.components.tic import TicMeter, static_variable, tic_ns
+from esphome.const import (
+    CONF_ENERGY,
+    CONF_ID,
+    CONF_POWER,
+    DEVICE_CLASS_ENERGY,
+    DEVICE_CLASS_POWER,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL,
+    UNIT_KILOWATT_HOURS,
+    UNIT_WATT,
+)
+
+DEPENDENCIES = ["tic"]
+AUTO_LOAD = ["sensor"]
+MULTI_CONF = True
+
+CONF_CONSUMER_ID = "consumer_id"
+CONF_PRODUCER_ID = "producer_id"
+CONF_MAX_SKEW = "max_skew"
+CONF_MAX_AGE = "max_age"
+
+MyTicAggregator = tic_ns.class_("MyTicAggregator", cg.PollingComponent)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(MyTicAggregator),
+        cv.Required(CONF_CONSUMER_ID): cv.use_id(TicMeter),
+        cv.Required(CONF_PRODUCER_ID): cv.use_id(TicMeter),
+        # une trame dure ~1.5s à 1200 bauds
+        cv.Optional(
+            CONF_MAX_SKEW, default="2s"
+        ): cv.positive_time_period_milliseconds,
+        # au-delà, compteur muet : valeurs nettes indisponibles
+        cv.Optional(
+            CONF_MAX_AGE, default="10s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_POWER): sensor.sensor_schema(
+            unit_of_measurement=UNIT_WATT,
+            icon="mdi:transmission-tower",
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_POWER,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_ENERGY): sensor.sensor_schema(
+            unit_of_measurement=UNIT_KILOWATT_HOURS,
+            icon="mdi:transmission-tower",
+            accuracy_decimals=3,
+            device_class=DEVICE_CLASS_ENERGY,
+            state_class=STATE_CLASS_TOTAL,
+        ),
+    }
+).extend(cv.polling_component_schema("5s"))
+
+
+async def to_code(config):
+    var = static_variable(config[CONF_ID], MyTicAggregator)
+    await cg.register_component(var, config)
+
+    conso = await cg.get_variable(config[CONF_CONSUMER_ID])
+    prod = await cg.get_variable(config[CONF_PRODUCER_ID])
+    cg.add(var.set_compteurs(conso, prod))
+    cg.add(var.set_ecart_max(config[CONF_MAX_SKEW]))
+    cg.add(var.set_age_max(config[CONF_MAX_AGE]))
+
+    if CONF_POWER in config:
+        sens = cg.Pvariable(config[CONF_POWER][CONF_ID], var.get_puissance_sensor())
+        await sensor.register_sensor(sens, config[CONF_POWER])
+    if CONF_ENERGY in config:
+        sens = cg.Pvariable(config[CONF_ENERGY][CONF_ID], var.get_energie_sensor())
+        await sensor.register_sensor(sens, config[CONF_ENERGY])
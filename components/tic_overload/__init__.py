@@ -0,0 +1,73 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome import automation
+from esphome.components import binary_sensor
+from esphome.components.tic import CONF_TIC_ID, TicMeter, static_variable, tic_ns
+from esphome.const import (
+    CONF_ID,
+    CONF_TRIGGER_ID,
+    DEVICE_CLASS_PROBLEM,
+)
+
+DEPENDENCIES = ["tic"]
+AUTO_LOAD = ["binary_sensor"]
+MULTI_CONF = True
+
+CONF_WINDOW = "window"
+CONF_HORIZON = "horizon"
+CONF_CURRENT_LIMIT = "current_limit"
+CONF_POWER_LIMIT = "power_limit"
+CONF_IMMINENT = "imminent"
+CONF_ON_OVERLOAD_PREDICTED = "on_overload_predicted"
+
+TicOverloadPredictor = tic_ns.class_("TicOverloadPredictor", cg.Component)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(TicOverloadPredictor),
+        cv.Required(CONF_TIC_ID): cv.use_id(TicMeter),
+        # trames de la fenêtre : 10 trames couvrent 15 s en historique
+        cv.Optional(CONF_WINDOW, default=10): cv.int_range(min=3, max=64),
+        cv.Optional(
+            CONF_HORIZON, default="5s"
+        ): cv.positive_time_period_milliseconds,
+        # par défaut ISOUSC (ou PREF / 230 V) et PREF
+        cv.Optional(CONF_CURRENT_LIMIT): cv.int_range(min=1, max=255),
+        cv.Optional(CONF_POWER_LIMIT): cv.int_range(min=1, max=100000),
+        cv.Optional(CONF_IMMINENT): binary_sensor.binary_sensor_schema(
+            device_class=DEVICE_CLASS_PROBLEM,
+            icon="mdi:flash-alert",
+        ),
+        cv.Optional(CONF_ON_OVERLOAD_PREDICTED): automation.validate_automation(
+            {
+                cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
+                    automation.Trigger.template()
+                ),
+            }
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    var = static_variable(
+        config[CONF_ID], TicOverloadPredictor.template(config[CONF_WINDOW])
+    )
+    await cg.register_component(var, config)
+
+    compteur = await cg.get_variable(config[CONF_TIC_ID])
+    cg.add(var.set_compteur(compteur))
+    cg.add(var.set_horizon(config[CONF_HORIZON]))
+    cg.add(
+        var.set_limites(
+            config.get(CONF_CURRENT_LIMIT, 0), config.get(CONF_POWER_LIMIT, 0)
+        )
+    )
+
+    if CONF_IMMINENT in config:
+        sens = cg.Pvariable(config[CONF_IMMINENT][CONF_ID], var.get_imminent_sensor())
+        await binary_sensor.register_binary_sensor(sens, config[CONF_IMMINENT])
+    # le déclencheur est un membre du composant, partagé par les automatisations
+    for conf in config.get(CONF_ON_OVERLOAD_PREDICTED, []):
+        trigger = cg.Pvariable(conf[CONF_TRIGGER_ID], var.get_trigger())
+        await automation.build_automation(trigger, [], conf)
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include "esphome/core/component.h"
+#include "esphome/core/log.h"
+#include "esphome/components/binary_sensor/binary_sensor.h"
+#include "esphome/components/tic/my_tic_component.h"
+#include "esphome/components/tic/tic_tendance.h"
+
+namespace esphome {
+namespace tic {
+
+// Prévision d'un dépassement (cf. tic_tendance.h) : à chaque trame, l'intensité (IINST, ou la plus
+// forte phase) et la puissance (PAPP ou SINSTS) de la fenêtre sont prolongées de horizon. Dépassement
+// imminent quand l'une des prévisions atteint sa limite : le capteur binaire passe à vrai et
+// le déclencheur est appelé une fois ; il retombe quand les deux prévisions repassent sous 95 %
+// de leur limite.
+//
+// Limites par défaut : l'intensité souscrite (ISOUSC, ou PREF sous 230 V) et, en standard, PREF
+// en VA. Sans limite connue, aucune prévision.
+template<uint8_t FENETRE>
+class TicOverloadPredictor : public Component {
+ public:
+	void set_compteur(TicMeter *compteur) { compteur_ = compteur; }
+	void set_horizon(uint32_t ms) { horizon_ = ms; }
+	// 0 : limite lue dans la trame
+	void set_limites(uint32_t courant, uint32_t puissance)
+	{
+		limite_courant_ = courant;
+		limite_puissance_ = puissance;
+	}
+	binary_sensor::BinarySensor *get_imminent_sensor() { return &sensor_imminent_; }
+	Trigger<> *get_trigger() { return &trigger_; }
+
+	const teleinfo::tendance::Predicteur<FENETRE> &get_predicteur() const { return predicteur_; }
+
+	void setup() override
+	{
+		sensor_imminent_.publish_initial_state(false);
+		compteur_->add_on_frame_callback([this](const TicFrame &f) { trame(f); });
+	}
+
+	void dump_config() override
+	{
+		ESP_LOGCONFIG("tic", "prévision de dépassement : %u trames, %u ms d'avance", (unsigned) FENETRE, (unsigned) horizon_);
+	}
+
+ protected:
+	void trame(const TicFrame &f)
+	{
+		const teleinfo::Trame &t = f.trame;
+		predicteur_.ajouter(f.millis, t.intensite(), t.puissance_soutiree());
+		int64_t courant = 0, puissance = 0;
+		bool pret = predicteur_.prevoir(horizon_, courant, puissance);
+		int64_t lc = int64_t(limite_courant_ != 0 ? limite_courant_ : t.intensite_souscrite()) * 256;
+		int64_t lp = int64_t(limite_puissance_ != 0 ? limite_puissance_ : t.valeur(TicLabel::PREF) * 1000) * 256;
+		if (!imminent_ && pret && ((lc != 0 && courant >= lc) || (lp != 0 && puissance >= lp)))
+		{
+			imminent_ = true;
+			ESP_LOGW("tic", "dépassement prévu dans %u ms : %.1f A, %.0f VA", (unsigned) horizon_, courant / 256.0f,
+				puissance / 256.0f);
+			sensor_imminent_.publish_state(true);
+			trigger_.trigger();
+		}
+		else if (imminent_ && (!pret || ((lc == 0 || courant * 100 < lc * 95) && (lp == 0 || puissance * 100 < lp * 95))))
+		{
+			imminent_ = false;
+			sensor_imminent_.publish_state(false);
+		}
+	}
+
+	TicMeter *compteur_ = nullptr;
+	uint32_t horizon_ = 5000;
+	uint32_t limite_courant_ = 0;
+	uint32_t limite_puissance_ = 0;
+	teleinfo::tendance::Predicteur<FENETRE> predicteur_;
+	bool imminent_ = false;
+	binary_sensor::BinarySensor sensor_imminent_;
+	Trigger<> trigger_;
+};
+
+}  // namespace tic
+}  // namespace esphome
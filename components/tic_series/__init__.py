@@ -0,0 +1,62 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components.tic import (
+    CONF_TIC_ID,
+    TIC_LABELS,
+    TIC_TEXT_LABELS,
+    TicLabel,
+    TicMeter,
+    static_variable,
+    tic_ns,
+)
+from esphome.const import CONF_BUFFER_SIZE, CONF_ID
+
+DEPENDENCIES = ["tic"]
+MULTI_CONF = True
+
+CONF_LABELS = "labels"
+
+TicSeries = tic_ns.class_("TicSeries", cg.Component)
+
+# cf. teleinfo::serie::TAILLE_BLOC (tic_serie.h)
+TAILLE_BLOC = 256
+
+NUMERIQUES = [label for label in TIC_LABELS if label not in TIC_TEXT_LABELS]
+
+
+def _taille(value):
+    value = cv.validate_bytes(value)
+    if value < 2 * TAILLE_BLOC:
+        raise cv.Invalid(f"au moins {2 * TAILLE_BLOC} octets (deux blocs)")
+    return value - value % TAILLE_BLOC
+
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(TicSeries),
+        cv.Required(CONF_TIC_ID): cv.use_id(TicMeter),
+        # étiquettes numériques enregistrées à chaque trame
+        cv.Optional(CONF_LABELS, default=["PAPP"]): cv.All(
+            cv.ensure_list(cv.one_of(*NUMERIQUES, upper=True)),
+            cv.Length(min=1, max=8),
+        ),
+        # PAPP seule : ~1.4 octet par trame, 4 ko gardent une heure
+        cv.Optional(CONF_BUFFER_SIZE, default="4kB"): _taille,
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+def series_type(config):
+    """Type C++ de la série décrite par config (utilisé aussi par tic_export)."""
+    return TicSeries.template(len(config[CONF_LABELS]), config[CONF_BUFFER_SIZE])
+
+
+async def to_code(config):
+    labels = config[CONF_LABELS]
+    var = static_variable(config[CONF_ID], series_type(config))
+    await cg.register_component(var, config)
+
+    compteur = await cg.get_variable(config[CONF_TIC_ID])
+    cg.add(var.set_compteur(compteur))
+    for i, label in enumerate(labels):
+        cg.add(var.set_colonne(i, getattr(TicLabel, label)))
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/components/tic/my_tic_component.h"
+#include "esphome/components/tic/tic_serie.h"
+
+namespace esphome {
+namespace tic {
+
+// Valeurs brutes de quelques étiquettes numériques à chaque trame, compressées en RAM
+// (cf. tic_serie.h) : quelques ko gardent des heures de trames sur l'ESP8266. Les instants sont
+// en ms depuis le démarrage, à 100 ms près.
+//
+// Lecture depuis une lambda, de la plus ancienne trame à la plus récente :
+//   auto &s = id(serie).get_serie();
+//   decltype(s)::Curseur c;
+//   uint64_t t;
+//   uint32_t v[1];
+//   for (s.debut(c); s.suivant(c, t, v);) ...
+// Depuis une autre tâche (serveur web de l'ESP32), la lecture se fait sous get_mutex(), que
+// l'écriture de chaque trame prend aussi.
+template<uint8_t COLONNES, size_t OCTETS>
+class TicSeries : public Component {
+ public:
+	using Stockage = teleinfo::serie::Serie<COLONNES>;
+
+	void set_compteur(TicMeter *compteur) { compteur_ = compteur; }
+	void set_colonne(uint8_t c, TicLabel label)
+	{
+		labels_[c] = label;
+		// index d'énergie : prédits par leur dernier accroissement
+		if (teleinfo::INDEX & teleinfo::bit(label))
+			cumulatives_ |= uint32_t(1) << c;
+	}
+
+	const Stockage &get_serie() const { return serie_; }
+	Mutex &get_mutex() { return mutex_; }
+	TicLabel get_label(uint8_t c) const { return labels_[c]; }
+
+	void setup() override
+	{
+		serie_.attribuer(zone_, OCTETS, cumulatives_);
+		compteur_->add_on_frame_callback([this](const TicFrame &f) {
+			uint32_t valeurs[COLONNES];
+			for (uint8_t c = 0; c < COLONNES; c++)
+				valeurs[c] = f.trame.valeur(labels_[c]);
+			LockGuard garde(mutex_);
+			serie_.ajouter(horloge_.prolonger(f.millis), valeurs);
+		});
+	}
+
+	void dump_config() override
+	{
+		ESP_LOGCONFIG("tic", "série compressée : %u étiquettes, %u octets", (unsigned) COLONNES, (unsigned) OCTETS);
+		for (uint8_t c = 0; c < COLONNES; c++)
+			ESP_LOGCONFIG("tic", "  %s", teleinfo::NOMS[static_cast<uint8_t>(labels_[c])]);
+		size_t n = serie_.echantillons();
+		if (n != 0)
+			ESP_LOGCONFIG("tic", "  %u trames en %u octets (%.2f par trame)", (unsigned) n, (unsigned) serie_.octets(),
+				(float) serie_.octets() / n);
+	}
+
+ protected:
+	TicMeter *compteur_ = nullptr;
+	TicLabel labels_[COLONNES] = {};
+	uint32_t cumulatives_ = 0;
+	TicHorloge horloge_;
+	Stockage serie_;
+	Mutex mutex_;
+	uint8_t zone_[OCTETS];
+};
+
+}  // namespace tic
+}  // namespace esphome
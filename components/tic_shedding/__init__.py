@@ -0,0 +1,104 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor, switch
+from esphome.components.tic import CONF_TIC_ID, TicMeter, static_variable, tic_ns
+from esphome.const import (
+    CONF_CURRENT,
+    CONF_ID,
+    CONF_PRIORITY,
+    CONF_SWITCH_ID,
+    CONF_UPDATE_INTERVAL,
+    STATE_CLASS_MEASUREMENT,
+)
+from esphome.core import TimePeriod
+import esphome.final_validate as fv
+
+DEPENDENCIES = ["tic"]
+AUTO_LOAD = ["sensor"]
+MULTI_CONF = True
+
+CONF_LOADS = "loads"
+CONF_SHED_INTERVAL = "shed_interval"
+CONF_RESTORE_DELAY = "restore_delay"
+CONF_MARGIN = "margin"
+CONF_REACTION_TIME = "reaction_time"
+
+# attente au plus dans le tampon de l'UART avant que le groupe de dépassement soit décodé
+ATTENTE_MAX = TimePeriod(milliseconds=100)
+
+TicShedding = tic_ns.class_("TicShedding", cg.Component)
+
+CHARGE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_SWITCH_ID): cv.use_id(switch.Switch),
+        # la plus petite priorité est coupée en premier
+        cv.Optional(CONF_PRIORITY, default=0): cv.int_range(min=0, max=255),
+        # intensité de la charge (A) : rétablie seulement si elle tient sous ISOUSC - margin
+        cv.Optional(CONF_CURRENT, default=0): cv.int_range(min=0, max=255),
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(TicShedding),
+        cv.Required(CONF_TIC_ID): cv.use_id(TicMeter),
+        cv.Required(CONF_LOADS): cv.All(
+            cv.ensure_list(CHARGE_SCHEMA), cv.Length(min=1, max=16)
+        ),
+        # IINST ne reflète une coupure qu'à la trame suivante (~1.5 s en historique)
+        cv.Optional(
+            CONF_SHED_INTERVAL, default="2s"
+        ): cv.positive_time_period_milliseconds,
+        # sans dépassement avant de rétablir une charge, puis entre deux retours
+        cv.Optional(
+            CONF_RESTORE_DELAY, default="5min"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MARGIN, default=2): cv.int_range(min=0, max=60),
+        # de la lecture du groupe dans l'UART au switch basculé, à chaque coupure
+        cv.Optional(CONF_REACTION_TIME): sensor.sensor_schema(
+            unit_of_measurement="µs",
+            icon="mdi:timer-outline",
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+def _final_validate(config):
+    """Le groupe de dépassement attend dans l'UART jusqu'au prochain update() du compteur."""
+    full_config = fv.full_config.get()
+    path = full_config.get_path_for_id(config[CONF_TIC_ID])[:-1]
+    interval = full_config.get_config_for_path(path)[CONF_UPDATE_INTERVAL]
+    # "never" n'est pas une TimePeriod : le groupe ne serait jamais décodé
+    if not isinstance(interval, TimePeriod) or interval > ATTENTE_MAX:
+        raise cv.Invalid(
+            f"tic_shedding : update_interval du compteur {config[CONF_TIC_ID]} de {interval}, "
+            f"le délestage demande {ATTENTE_MAX} au plus"
+        )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
+
+async def to_code(config):
+    # tri stable : à priorité égale, l'ordre de la configuration
+    charges = sorted(config[CONF_LOADS], key=lambda c: c[CONF_PRIORITY])
+    var = static_variable(config[CONF_ID], TicShedding.template(len(charges)))
+    await cg.register_component(var, config)
+
+    compteur = await cg.get_variable(config[CONF_TIC_ID])
+    cg.add(var.set_compteur(compteur))
+    cg.add(
+        var.set_delais(
+            config[CONF_SHED_INTERVAL], config[CONF_RESTORE_DELAY], config[CONF_MARGIN]
+        )
+    )
+    for i, conf in enumerate(charges):
+        charge = await cg.get_variable(conf[CONF_SWITCH_ID])
+        cg.add(var.set_charge(i, charge, conf[CONF_CURRENT]))
+
+    if CONF_REACTION_TIME in config:
+        sens = cg.Pvariable(config[CONF_REACTION_TIME][CONF_ID], var.get_reaction_sensor())
+        await sensor.register_sensor(sens, config[CONF_REACTION_TIME])
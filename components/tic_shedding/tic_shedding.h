@@ -0,0 +1,89 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/switch/switch.h"
+#include "esphome/components/tic/my_tic_component.h"
+#include "esphome/components/tic/tic_delestage.h"
+
+namespace esphome {
+namespace tic {
+
+// Délestage (cf. tic_delestage.h) piloté directement par le décodage : la charge est coupée dans
+// le rappel du groupe ADPS/ADIRn/STGE, avant la fin de la trame et sans passer par Home Assistant.
+// Les charges sont des switch (gpio, relais...), rangées par priorité par la génération de code.
+//
+// Temps de réaction : de la lecture dans l'UART des derniers octets du groupe au switch basculé
+// (décodage du reste du paquet compris), mesuré à chaque coupure (capteur reaction_time, µs).
+// Avant cette lecture, les octets attendent dans le tampon de l'UART au plus update_interval du
+// compteur (100 ms au plus, imposé par la génération de code), borne donnée par dump_config.
+template<uint8_t N>
+class TicShedding : public Component {
+ public:
+	using Moteur = teleinfo::delestage::Delestage<N>;
+
+	void set_compteur(TicMeter *compteur) { compteur_ = compteur; }
+	void set_charge(uint8_t i, switch_::Switch *charge, uint16_t courant)
+	{
+		charges_[i] = charge;
+		moteur_.configurer(i, courant);
+	}
+	void set_delais(uint32_t pas, uint32_t retour, uint16_t marge) { moteur_.set_delais(pas, retour, marge); }
+	sensor::Sensor *get_reaction_sensor() { return &sensor_reaction_; }
+
+	const Moteur &get_moteur() const { return moteur_; }
+	// pire temps de réaction mesuré depuis le démarrage (µs)
+	uint32_t get_reaction_max() const { return reaction_max_; }
+
+	void setup() override
+	{
+		compteur_->add_on_overload_callback([this](TicLabel label, uint32_t lecture_us) { depassement(label, lecture_us); });
+		compteur_->add_on_frame_callback([this](const TicFrame &f) {
+			if (f.trame.depassement())
+				return;
+			int i = moteur_.trame(f.millis, f.trame.intensite(), f.trame.intensite_souscrite());
+			if (i != teleinfo::delestage::AUCUNE)
+			{
+				ESP_LOGI("tic", "délestage : charge %d rétablie (%u A)", i, (unsigned) f.trame.intensite());
+				charges_[i]->turn_on();
+			}
+		});
+	}
+
+	void dump_config() override
+	{
+		ESP_LOGCONFIG("tic", "délestage : %u charges", (unsigned) N);
+		ESP_LOGCONFIG("tic", "  attente dans le tampon de l'UART : %u ms au plus", (unsigned) compteur_->get_update_interval());
+		if (reaction_max_ != 0)
+			ESP_LOGCONFIG("tic", "  temps de réaction depuis la lecture de l'UART : %u µs au plus", (unsigned) reaction_max_);
+	}
+
+ protected:
+	void depassement(TicLabel label, uint32_t lecture_us)
+	{
+		uint32_t allumees = 0;
+		for (uint8_t i = 0; i < N; i++)
+			if (charges_[i]->state)
+				allumees |= uint32_t(1) << i;
+		int i = moteur_.depassement(millis(), allumees);
+		if (i == teleinfo::delestage::AUCUNE)
+			return;
+		charges_[i]->turn_off();
+		uint32_t reaction = micros() - lecture_us;
+		reaction_max_ = reaction > reaction_max_ ? reaction : reaction_max_;
+		ESP_LOGW("tic", "délestage : %s, charge %d coupée en %u µs", teleinfo::NOMS[static_cast<uint8_t>(label)], i,
+			(unsigned) reaction);
+		sensor_reaction_.publish_state(reaction);
+	}
+
+	TicMeter *compteur_ = nullptr;
+	switch_::Switch *charges_[N] = {};
+	Moteur moteur_;
+	uint32_t reaction_max_ = 0;
+	sensor::Sensor sensor_reaction_;
+};
+
+}  // namespace tic
+}  // namespace esphome
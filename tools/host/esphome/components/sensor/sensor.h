@@ -0,0 +1,21 @@
+#pragma once
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace sensor {
+
+class Sensor {
+ public:
+	float state = NAN;
+	uint32_t publications = 0;
+
+	void publish_state(float valeur)
+	{
+		state = valeur;
+		publications++;
+	}
+};
+
+}  // namespace sensor
+}  // namespace esphome
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace switch_ {
+
+class Switch {
+ public:
+	virtual ~Switch() = default;
+	bool state = false;
+
+	void publish_state(bool etat) { state = etat; }
+	void turn_on() { write_state(true); }
+	void turn_off() { write_state(false); }
+
+ protected:
+	virtual void write_state(bool etat) = 0;
+};
+
+}  // namespace switch_
+}  // namespace esphome
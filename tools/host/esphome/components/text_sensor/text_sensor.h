@@ -0,0 +1,21 @@
+#pragma once
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace text_sensor {
+
+class TextSensor {
+ public:
+	std::string state;
+	uint32_t publications = 0;
+
+	void publish_state(const std::string &valeur)
+	{
+		state = valeur;
+		publications++;
+	}
+};
+
+}  // namespace text_sensor
+}  // namespace esphome
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace uart {
+
+// UART scriptée : le programme hôte remplit rx, le composant la vide par available()/read_array()
+class UARTComponent {
+ public:
+	std::deque<uint8_t> rx;
+	size_t rx_buffer_size = SIZE_MAX;	// la file du bouchon ne perd aucun octet
+
+	size_t get_rx_buffer_size() { return rx_buffer_size; }
+	void ecrire(const uint8_t *data, size_t len) { rx.insert(rx.end(), data, data + len); }
+};
+
+class UARTDevice {
+ public:
+	void set_uart_parent(UARTComponent *parent) { parent_ = parent; }
+
+	int available() { return parent_->rx.size(); }
+	bool read_array(uint8_t *data, size_t len)
+	{
+		if (parent_->rx.size() < len)
+			return false;
+		for (size_t i = 0; i < len; i++)
+		{
+			data[i] = parent_->rx.front();
+			parent_->rx.pop_front();
+		}
+		return true;
+	}
+
+ protected:
+	UARTComponent *parent_ = nullptr;
+};
+
+}  // namespace uart
+}  // namespace esphome
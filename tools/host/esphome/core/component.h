@@ -0,0 +1,43 @@
+#pragma once
+
+// Bouchons ESPhome pour compiler my_tic_component.h sur PC (cf. tools/tic_replay.cpp) :
+// seules les méthodes utilisées par les composants tic, tic_net et tic_log sont présentes.
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace esphome {
+
+namespace setup_priority {
+constexpr float DATA = 600.0f;
+}  // namespace setup_priority
+
+class Component {
+ public:
+	virtual ~Component() = default;
+	virtual void setup() {}
+	virtual void loop() {}
+	virtual void dump_config() {}
+	virtual void on_shutdown() {}
+	virtual float get_setup_priority() const { return 0.0f; }
+	void mark_failed() { failed_ = true; }
+	bool is_failed() const { return failed_; }
+
+ protected:
+	bool failed_ = false;
+};
+
+class PollingComponent : public Component {
+ public:
+	PollingComponent() = default;
+	explicit PollingComponent(uint32_t intervalle) : update_interval_(intervalle) {}
+	virtual void update() = 0;
+	void set_update_interval(uint32_t intervalle) { update_interval_ = intervalle; }
+	uint32_t get_update_interval() const { return update_interval_; }
+
+ protected:
+	uint32_t update_interval_ = 0;
+};
+
+}  // namespace esphome
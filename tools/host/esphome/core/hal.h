@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+
+// horloge fournie par le programme hôte (horloge virtuelle ou réelle)
+uint32_t millis();
+uint32_t micros();
+
+}  // namespace esphome
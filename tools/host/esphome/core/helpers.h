@@ -0,0 +1,47 @@
+#pragma once
+
+// Bouchon de esphome/core/helpers.h : CallbackManager, Mutex et LockGuard seulement.
+
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+
+template<typename T> class CallbackManager;
+
+template<typename... Ts>
+class CallbackManager<void(Ts...)> {
+ public:
+	void add(std::function<void(Ts...)> &&callback) { callbacks_.push_back(std::move(callback)); }
+	void call(Ts... args)
+	{
+		for (auto &cb : callbacks_)
+			cb(args...);
+	}
+
+ protected:
+	std::vector<std::function<void(Ts...)>> callbacks_;
+};
+
+class Mutex {
+ public:
+	void lock() { m_.lock(); }
+	bool try_lock() { return m_.try_lock(); }
+	void unlock() { m_.unlock(); }
+
+ protected:
+	std::mutex m_;
+};
+
+class LockGuard {
+ public:
+	explicit LockGuard(Mutex &mutex) : mutex_(mutex) { mutex_.lock(); }
+	~LockGuard() { mutex_.unlock(); }
+
+ protected:
+	Mutex &mutex_;
+};
+
+}  // namespace esphome
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdio>
+
+namespace esphome {
+// niveau d'affichage des journaux : 0 = aucun, 1 = W/E, 2 = + I, 3 = + D
+extern int log_niveau;
+}  // namespace esphome
+
+#define ESP_LOG_HOTE(n, lettre, tag, ...) \
+	(esphome::log_niveau >= (n) ? (printf("[" lettre "][%s] ", tag), printf(__VA_ARGS__), printf("\n")) : 0)
+#define ESP_LOGE(tag, ...) ESP_LOG_HOTE(1, "E", tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ESP_LOG_HOTE(1, "W", tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ESP_LOG_HOTE(2, "I", tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ESP_LOG_HOTE(2, "C", tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ESP_LOG_HOTE(3, "D", tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ((void) 0)
@@ -0,0 +1,303 @@
+// Banc de mesure du décodage TIC sur PC.
+//
+//   g++ -O2 -std=c++17 -I components/tic tools/tic_bench.cpp -o tic_bench
+//   ./tic_bench [-m historic|standard|auto] [-p 1|3] [capture...]
+//
+// 1. décodeur seul : le décodeur spécialisé à la compilation (Historique<1>, Standard<1>) comparé
+//    à la version générique Auto<3>, qui reconnaît le mode et porte toutes les étiquettes.
+// 2. chaîne de lecture complète (teleinfo::Lecteur, celle du composant) sur des flux de plusieurs
+//    Mo générés par tic_synth.h pour chaque option tarifaire, ou sur des captures brutes passées
+//    en argument : ns/octet, ns/groupe, allocations par trame et pic de tas. La référence
+//    "String" reproduit le traitement d'origine du composant (processString()/processCommand()
+//    à base de String), pour mesurer chaque modification du décodage par rapport à elle.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_parser.h"
+#include "tic_synth.h"
+
+using namespace teleinfo;
+
+// comptage des allocations : chaque bloc est précédé de sa taille
+static bool compter = false;
+static uint64_t allocations = 0;
+static size_t tas = 0, pic = 0;
+
+void *operator new(size_t n)
+{
+	size_t *p = static_cast<size_t *>(malloc(n + sizeof(max_align_t)));
+	if (p == nullptr)
+		throw std::bad_alloc();
+	*p = n;
+	if (compter)
+	{
+		allocations++;
+		tas += n;
+		if (tas > pic)
+			pic = tas;
+	}
+	return reinterpret_cast<char *>(p) + sizeof(max_align_t);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	if (ptr == nullptr)
+		return;
+	size_t *p = reinterpret_cast<size_t *>(static_cast<char *>(ptr) - sizeof(max_align_t));
+	if (compter && tas >= *p)
+		tas -= *p;
+	free(p);
+}
+
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+
+struct Mesure {
+	double ns = 0;
+	uint64_t allocations = 0;
+	size_t pic = 0;
+	uint32_t trames = 0;
+};
+
+template<typename F>
+static Mesure mesurer(F &&traitement)
+{
+	Mesure m;
+	allocations = 0;
+	tas = pic = 0;
+	compter = true;
+	auto debut = std::chrono::steady_clock::now();
+	traitement(m);
+	std::chrono::duration<double, std::nano> duree = std::chrono::steady_clock::now() - debut;
+	compter = false;
+	m.ns = duree.count();
+	m.allocations = allocations;
+	m.pic = pic;
+	return m;
+}
+
+template<typename DECODEUR>
+static double mesurer_decodeur(const std::vector<std::string> &groupes, int tours, uint64_t &controle)
+{
+	DECODEUR decodeur;
+	Groupe g;
+	auto debut = std::chrono::steady_clock::now();
+	for (int t = 0; t < tours; t++)
+		for (const std::string &s : groupes)
+			if (decodeur.decoder(s.data(), s.size(), g) == Erreur::AUCUNE)
+				controle += entier(g.valeur, g.valeur_len);
+	std::chrono::duration<double, std::nano> duree = std::chrono::steady_clock::now() - debut;
+	return duree.count() / (double(tours) * groupes.size());
+}
+
+// chaîne de lecture du composant, toutes les étiquettes du mode décodées et mémorisées
+template<typename MODE>
+static Mesure lecteur(const std::string &flux, uint64_t &controle)
+{
+	return mesurer([&](Mesure &m) {
+		Trame trame;
+		Lecteur<MODE> l(trame);
+		l.pousser(reinterpret_cast<const uint8_t *>(flux.data()), flux.size(),
+			[&](Evenement e, const Groupe &g, bool change) {
+				if (e == Evenement::GROUPE && change)
+					controle += g.valeur_len;
+			});
+		m.trames = l.stats.trames;
+	});
+}
+
+// Référence : traitement d'origine du composant, une String par caractère reçu, copiée et
+// découpée par substring() à chaque groupe, comparée étiquette par étiquette (mode historique).
+// std::string tient lieu de String ; son optimisation des chaînes courtes est comparable à
+// celle des cores ESP8266/ESP32 récents, les anciens cores allouaient davantage.
+struct Historique_String {
+	float base = 0, isousc = 0, iinst = 0, papp = 0;
+	std::string adco;
+	uint64_t &controle;
+
+	void processString(std::string str)
+	{
+		char separator = ' ';
+		if (str.find(separator) != std::string::npos)
+		{
+			std::string etiquette = str.substr(0, str.find(separator));
+			std::string value = str.substr(str.find(separator) + 1);
+			if (value.find(separator) != std::string::npos)
+			{
+				value = value.substr(0, value.find(separator));
+				processCommand(etiquette, value);
+			}
+		}
+	}
+
+	void processCommand(std::string etiquette, std::string value)
+	{
+		if (etiquette == "ADCO")
+		{
+			if (adco != value)
+			{
+				controle += value.size();
+				adco = value;
+			}
+		}
+		else if (etiquette == "BASE")
+			publier(base, value);
+		else if (etiquette == "ISOUSC")
+			publier(isousc, value);
+		else if (etiquette == "IINST")
+			publier(iinst, value);
+		else if (etiquette == "PAPP")
+			publier(papp, value);
+	}
+
+	void publier(float &memoire, const std::string &value)
+	{
+		float v = strtof(value.c_str(), nullptr);
+		if (memoire != v)
+		{
+			controle += 1;
+			memoire = v;
+		}
+	}
+};
+
+static Mesure reference_string(const std::string &flux, uint64_t &controle)
+{
+	return mesurer([&](Mesure &m) {
+		Historique_String h{0, 0, 0, 0, {}, controle};
+		std::string buff;
+		for (char c : flux)
+		{
+			if (c == '\x03')
+				m.trames++;
+			if (c == '\r')
+			{
+				if (!buff.empty())
+					h.processString(buff);
+				buff = "";
+				continue;
+			}
+			buff += c;
+			if (c == '\n' || buff.length() > 50)
+				buff = "";
+		}
+	});
+}
+
+// ns/groupe : rapporté à tous les groupes du flux, y compris ceux que le décodeur ignore
+static void afficher(const char *nom, const char *chaine, const std::string &f, const Mesure &m)
+{
+	size_t groupes = std::count(f.begin(), f.end(), '\n');
+	printf("%-22s %-14s %8.1f %9.1f %11.2f %9zu\n", nom, chaine, m.ns / f.size(),
+		groupes ? m.ns / groupes : 0.0, m.trames ? double(m.allocations) / m.trames : 0.0, m.pic);
+}
+
+static std::string flux(const synth::Profil &profil, size_t octets)
+{
+	synth::Generateur gen(profil);
+	std::string f;
+	while (f.size() < octets)
+		f += gen.trame();
+	return f;
+}
+
+template<typename MODE>
+static void chaines(const char *nom, const std::string &f, bool historique, uint64_t &controle)
+{
+	afficher(nom, "Lecteur", f, lecteur<MODE>(f, controle));
+	afficher(nom, "Lecteur Auto", f, lecteur<Auto<3>>(f, controle));
+	if (historique)
+		afficher(nom, "String", f, reference_string(f, controle));
+}
+
+static bool lire(const char *chemin, std::string &capture)
+{
+	FILE *f = fopen(chemin, "rb");
+	if (f == nullptr)
+		return false;
+	char buff[4096];
+	size_t n;
+	while ((n = fread(buff, 1, sizeof(buff), f)) > 0)
+		capture.append(buff, n);
+	fclose(f);
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	std::string mode = "historic";
+	int phases = 1;
+	int c;
+	while ((c = getopt(argc, argv, "m:p:")) != -1)
+	{
+		switch (c)
+		{
+			case 'm': mode = optarg; break;
+			case 'p': phases = atoi(optarg); break;
+			default:
+				fprintf(stderr, "usage : %s [-m historic|standard|auto] [-p 1|3] [capture...]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	uint64_t controle = 0;
+	const int tours = 200;
+	std::vector<std::string> historique, standard;
+	synth::Generateur gen_h({}), gen_s({synth::Option::BASE, 1, true});
+	for (uint32_t i = 0; i < 1000; i++)
+	{
+		// groupes sans STX/ETX, LF ni CR
+		for (synth::Generateur *gen : {&gen_h, &gen_s})
+		{
+			std::string t = gen->trame();
+			for (size_t d = 1; (d = t.find('\n', d)) != std::string::npos; d++)
+				(gen == &gen_h ? historique : standard).push_back(t.substr(d + 1, t.find('\r', d) - d - 1));
+		}
+	}
+	printf("%-34s %10s\n", "décodeur", "ns/groupe");
+	printf("%-34s %10.1f\n", "Historique<1>", mesurer_decodeur<Decodeur<Historique<1>>>(historique, tours, controle));
+	printf("%-34s %10.1f\n", "Auto<3> (générique), historique", mesurer_decodeur<Decodeur<Auto<3>>>(historique, tours, controle));
+	printf("%-34s %10.1f\n", "Standard<1>", mesurer_decodeur<Decodeur<Standard<1>>>(standard, tours, controle));
+	printf("%-34s %10.1f\n", "Auto<3> (générique), standard", mesurer_decodeur<Decodeur<Auto<3>>>(standard, tours, controle));
+
+	printf("\n%-22s %-14s %8s %9s %11s %9s\n", "flux", "chaîne", "ns/octet", "ns/groupe", "allocs/trame", "pic tas");
+	if (optind < argc)
+	{
+		for (int i = optind; i < argc; i++)
+		{
+			std::string capture;
+			if (!lire(argv[i], capture))
+			{
+				perror(argv[i]);
+				return 2;
+			}
+			bool tri = phases == 3;
+			if (mode == "standard")
+				tri ? chaines<Standard<3>>(argv[i], capture, false, controle) : chaines<Standard<1>>(argv[i], capture, false, controle);
+			else if (mode == "auto")
+				tri ? chaines<Auto<3>>(argv[i], capture, true, controle) : chaines<Auto<1>>(argv[i], capture, true, controle);
+			else
+				tri ? chaines<Historique<3>>(argv[i], capture, true, controle) : chaines<Historique<1>>(argv[i], capture, true, controle);
+		}
+	}
+	else
+	{
+		const size_t taille = 4 << 20;
+		using synth::Option;
+		chaines<Historique<1>>("historique BASE", flux({Option::BASE, 1, false}, taille), true, controle);
+		chaines<Historique<1>>("historique HC", flux({Option::HC, 1, false}, taille), true, controle);
+		chaines<Historique<1>>("historique EJP", flux({Option::EJP, 1, false}, taille), true, controle);
+		chaines<Historique<1>>("historique Tempo", flux({Option::TEMPO, 1, false}, taille), true, controle);
+		chaines<Historique<3>>("historique tri HC", flux({Option::HC, 3, false, 30, 4500}, taille), true, controle);
+		chaines<Standard<1>>("standard HC", flux({Option::HC, 1, true}, taille), false, controle);
+		chaines<Standard<3>>("standard tri Tempo", flux({Option::TEMPO, 3, true, 30, 4500}, taille), false, controle);
+	}
+	printf("(contrôle %llu)\n", static_cast<unsigned long long>(controle));
+	return 0;
+}
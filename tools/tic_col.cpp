@@ -0,0 +1,198 @@
+// Lecture des fichiers en colonnes (tools/tic_colonnes.h) écrits par tic_decode -f col et ticd -c.
+//
+//   g++ -O2 -std=c++17 -I components/tic tools/tic_col.cpp -o tic_col
+//   ./tic_col historique.tcol                     # résumé : trames, période, octets par colonne
+//   ./tic_col -e PAPP,PTEC historique.tcol        # table CSV : instant (ms) puis les étiquettes
+//   ./tic_col -s PAPP -w 6000 historique.tcol     # min, max, moyenne, trames au-dessus de 6000
+//
+// -s ne décode que la colonne demandée ; avec -w, les blocs dont le max est sous le seuil sont
+// comptés sans être lus. Le temps de parcours est affiché sur stderr.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_colonnes.h"
+
+using namespace teleinfo;
+
+static bool etiquette(const char *nom, size_t n, Label &label)
+{
+	for (uint8_t i = 0; i < NB_ETIQUETTES; i++)
+		if (strlen(NOMS[i]) == n && strncmp(NOMS[i], nom, n) == 0)
+		{
+			label = static_cast<Label>(i);
+			return true;
+		}
+	return false;
+}
+
+static int resumer(colonnes::Fichier &f)
+{
+	std::vector<uint64_t> octets(__builtin_popcountll(f.etiquettes()));
+	uint64_t trames = 0, blocs = 0, instants = 0, t_min = UINT64_MAX, t_max = 0;
+	colonnes::Fichier::Bloc b;
+	while (f.suivant(b))
+	{
+		blocs++;
+		trames += b.entete->trames;
+		t_min = std::min(t_min, b.entete->t_min);
+		t_max = std::max(t_max, b.entete->t_max);
+		instants += octets.empty() ? b.entete->taille : b.index[0].position;
+		for (size_t c = 0; c < octets.size(); c++)
+			octets[c] += (c + 1 < octets.size() ? b.index[c + 1].position : b.entete->taille) - b.index[c].position;
+	}
+	if (trames == 0)
+	{
+		printf("aucune trame\n");
+		return 0;
+	}
+	printf("%llu trames en %llu blocs, %.1f jours, %zu octets (%.2f par trame)\n", (unsigned long long) trames,
+		(unsigned long long) blocs, (t_max - t_min) / 86400e3, f.taille(), (double) f.taille() / trames);
+	printf("%-10s %12s %9s\n", "colonne", "octets", "/trame");
+	printf("%-10s %12llu %9.3f\n", "instant", (unsigned long long) instants, (double) instants / trames);
+	size_t c = 0;
+	for (uint8_t i = 0; i < NB_ETIQUETTES; i++)
+		if (f.etiquettes() & (uint64_t(1) << i))
+		{
+			printf("%-10s %12llu %9.3f\n", NOMS[i], (unsigned long long) octets[c], (double) octets[c] / trames);
+			c++;
+		}
+	return 0;
+}
+
+static int exporter(colonnes::Fichier &f, const std::vector<Label> &labels)
+{
+	printf("t");
+	for (Label l : labels)
+		printf(",%s", NOMS[static_cast<uint8_t>(l)]);
+	printf("\n");
+	colonnes::Fichier::Bloc b;
+	std::vector<uint64_t> instants;
+	std::vector<std::vector<std::string>> cellules(labels.size());
+	while (f.suivant(b))
+	{
+		instants.assign(b.entete->trames, 0);
+		f.instants(b, [&](uint32_t i, uint64_t t) { instants[i] = t; });
+		for (size_t c = 0; c < labels.size(); c++)
+		{
+			std::vector<std::string> &col = cellules[c];
+			col.assign(b.entete->trames, std::string());
+			int rang = f.colonne(labels[c]);
+			if (rang < 0)
+				continue;
+			if (TEXTES & bit(labels[c]))
+				f.textes(b, rang, [&](uint32_t i, const char *t, uint8_t n) { col[i].assign(t, n); });
+			else
+				f.valeurs(b, rang, [&](uint32_t i, uint32_t v) { col[i] = std::to_string(v); });
+		}
+		for (uint32_t i = 0; i < b.entete->trames; i++)
+		{
+			printf("%llu", (unsigned long long) instants[i]);
+			for (auto &col : cellules)
+				printf(",%s", col[i].c_str());
+			printf("\n");
+		}
+	}
+	return 0;
+}
+
+static int statistiques(colonnes::Fichier &f, Label label, long seuil)
+{
+	int rang = f.colonne(label);
+	if (rang < 0 || (TEXTES & bit(label)))
+	{
+		fprintf(stderr, "%s : pas de colonne numérique\n", NOMS[static_cast<uint8_t>(label)]);
+		return 1;
+	}
+	auto debut = std::chrono::steady_clock::now();
+	uint64_t n = 0, somme = 0, dessus = 0, blocs = 0, sautes = 0;
+	uint32_t min = UINT32_MAX, max = 0;
+	colonnes::Fichier::Bloc b;
+	while (f.suivant(b))
+	{
+		blocs++;
+		if (seuil >= 0 && static_cast<long>(b.index[rang].max) < seuil)
+		{
+			sautes++;
+			continue;
+		}
+		f.valeurs(b, rang, [&](uint32_t, uint32_t v) {
+			n++;
+			somme += v;
+			min = v < min ? v : min;
+			max = v > max ? v : max;
+			dessus += seuil >= 0 && v >= seuil;
+		});
+	}
+	double secondes = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+	const char *nom = NOMS[static_cast<uint8_t>(label)];
+	if (seuil >= 0)
+		printf("%s >= %ld : %llu trames (%llu blocs sur %llu sautés)\n", nom, seuil, (unsigned long long) dessus,
+			(unsigned long long) sautes, (unsigned long long) blocs);
+	else if (n != 0)
+		printf("%s : %llu valeurs, min %u, max %u, moyenne %.1f\n", nom, (unsigned long long) n, min, max,
+			(double) somme / n);
+	fprintf(stderr, "parcours : %.3f s\n", secondes);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<Label> exportees;
+	bool stats = false;
+	Label label = Label::PAPP;
+	long seuil = -1;
+	int c;
+	while ((c = getopt(argc, argv, "e:s:w:")) != -1)
+	{
+		switch (c)
+		{
+			case 'e':
+				for (const char *p = optarg; *p != '\0';)
+				{
+					size_t n = strcspn(p, ",");
+					Label l;
+					if (!etiquette(p, n, l))
+					{
+						fprintf(stderr, "étiquette inconnue : %.*s\n", (int) n, p);
+						return 2;
+					}
+					exportees.push_back(l);
+					p += n + (p[n] == ',');
+				}
+				break;
+			case 's':
+				stats = true;
+				if (!etiquette(optarg, strlen(optarg), label))
+				{
+					fprintf(stderr, "étiquette inconnue : %s\n", optarg);
+					return 2;
+				}
+				break;
+			case 'w': seuil = atol(optarg); break;
+			default: optind = argc + 1; break;
+		}
+	}
+	if (optind != argc - 1)
+	{
+		fprintf(stderr, "usage : %s [-e ETIQ,...] [-s ETIQ [-w seuil]] fichier.tcol\n", argv[0]);
+		return 2;
+	}
+	colonnes::Fichier f;
+	if (!f.ouvrir(argv[optind]))
+	{
+		fprintf(stderr, "%s : fichier absent ou format inconnu\n", argv[optind]);
+		return 1;
+	}
+	if (stats)
+		return statistiques(f, label, seuil);
+	if (!exportees.empty())
+		return exporter(f, exportees);
+	return resumer(f);
+}
@@ -0,0 +1,445 @@
+#pragma once
+
+// Historique des trames décodées en colonnes (fichiers .tcol) : écrit par tic_decode (-f col) et
+// ticd (-c), lu par tic_col. Une colonne par étiquette, encodée selon la façon dont elle varie, et
+// un index min/max par bloc : un an de trames tient en quelques dizaines de Mo et une étiquette se
+// parcourt sans lire les autres.
+//
+// fichier : en-tête { "TCOL", version, masque des étiquettes } suivi de blocs indépendants ; des
+// blocs ajoutés en fin de fichier forment toujours un fichier valide (ticd ajoute à l'existant).
+// bloc : en-tête { "BLOC", trames, taille des données, instants min et max }, puis pour chaque
+// étiquette du masque { position de sa colonne dans les données, valeur min, valeur max }, puis les
+// données : colonne des instants, puis une colonne par étiquette dans l'ordre du masque.
+// colonne d'étiquette : longueur de la présence, présence, valeurs des trames où elle est présente.
+//  - présence : longueurs des plages alternées présente / absente, en commençant par présente ;
+//  - instants (ms) et valeurs numériques : écart à la valeur précédente (0 en début de bloc) en
+//    zig-zag, par plages d'écarts égaux { répétitions, écart } : un index immobile, ISOUSC ou des
+//    trames à intervalle régulier ne coûtent que quelques octets par bloc ;
+//  - textes : plages de valeurs égales { répétitions, longueur, caractères } (ADCO, OPTARIF, PTEC).
+// Entiers en varint (LEB128), en-têtes en petit boutiste (x86, ARM).
+
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_parser.h"
+
+namespace colonnes {
+
+constexpr uint32_t MAGIE = 0x4C4F4354;		// "TCOL"
+constexpr uint32_t MAGIE_BLOC = 0x434F4C42;	// "BLOC"
+constexpr uint32_t VERSION = 1;
+
+struct EnteteFichier {
+	uint32_t magie;
+	uint32_t version;
+	uint64_t etiquettes;
+};
+
+struct EnteteBloc {
+	uint32_t magie;
+	uint32_t trames;
+	uint32_t taille;	// données, après l'index des colonnes
+	uint32_t reserve;
+	uint64_t t_min;
+	uint64_t t_max;
+};
+
+struct IndexColonne {
+	uint32_t position;	// dans les données du bloc
+	uint32_t min;		// valeurs numériques présentes dans le bloc (0 pour un texte)
+	uint32_t max;
+};
+
+inline void varint(std::string &s, uint64_t v)
+{
+	while (v >= 0x80)
+	{
+		s += static_cast<char>(v | 0x80);
+		v >>= 7;
+	}
+	s += static_cast<char>(v);
+}
+
+// 0 au-delà de fin (fichier tronqué ou corrompu)
+inline uint64_t lire_varint(const uint8_t *&p, const uint8_t *fin)
+{
+	uint64_t v = 0;
+	for (int decalage = 0; p < fin && decalage < 64; decalage += 7)
+	{
+		uint8_t o = *p++;
+		v |= uint64_t(o & 0x7F) << decalage;
+		if (!(o & 0x80))
+			break;
+	}
+	return v;
+}
+
+inline uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+inline int64_t dezigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+inline void entete(std::string &sortie, uint64_t etiquettes)
+{
+	EnteteFichier e = {MAGIE, VERSION, etiquettes};
+	sortie.append(reinterpret_cast<const char *>(&e), sizeof(e));
+}
+
+// Encodeur : les trames ajoutées sont accumulées en colonnes, chaque bloc terminé est ajouté à
+// sortie (sans l'en-tête du fichier), que l'appelant écrit puis vide.
+class Ecrivain {
+ public:
+	explicit Ecrivain(uint64_t etiquettes, uint32_t trames_par_bloc = 4096)
+		: etiquettes_(etiquettes), trames_par_bloc_(trames_par_bloc)
+	{
+		for (uint8_t i = 0; i < teleinfo::NB_ETIQUETTES; i++)
+			if (etiquettes & (uint64_t(1) << i))
+				colonnes_.emplace_back(static_cast<teleinfo::Label>(i));
+	}
+
+	std::string sortie;
+
+	void ajouter(uint64_t instant_ms, const teleinfo::Trame &trame)
+	{
+		if (trames_ == 0)
+			t_min_ = t_max_ = instant_ms;
+		t_min_ = instant_ms < t_min_ ? instant_ms : t_min_;
+		t_max_ = instant_ms > t_max_ ? instant_ms : t_max_;
+		instants_.ajouter(instant_ms);
+		for (Colonne &c : colonnes_)
+			c.ajouter(trame);
+		if (++trames_ == trames_par_bloc_)
+			terminer();
+	}
+
+	// termine le bloc en cours (fin de fichier, arrêt)
+	void terminer()
+	{
+		if (trames_ == 0)
+			return;
+		std::string donnees;
+		instants_.terminer(donnees);
+		std::vector<IndexColonne> index;
+		for (Colonne &c : colonnes_)
+		{
+			// colonne sans valeur numérique : min = max = 0
+			index.push_back({static_cast<uint32_t>(donnees.size()), c.min > c.max ? 0 : c.min, c.max});
+			c.terminer(donnees);
+		}
+		EnteteBloc e = {MAGIE_BLOC, trames_, static_cast<uint32_t>(donnees.size()), 0, t_min_, t_max_};
+		sortie.append(reinterpret_cast<const char *>(&e), sizeof(e));
+		sortie.append(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(IndexColonne));
+		sortie += donnees;
+		trames_ = 0;
+	}
+
+	uint64_t etiquettes() const { return etiquettes_; }
+
+ protected:
+	// écarts successifs par plages d'écarts égaux
+	struct Ecarts {
+		std::string octets;
+		uint64_t precedent = 0;
+		uint64_t ecart = 0;
+		uint32_t repetitions = 0;
+
+		void ajouter(uint64_t v)
+		{
+			uint64_t e = zigzag(static_cast<int64_t>(v - precedent));
+			precedent = v;
+			if (repetitions != 0 && e == ecart)
+			{
+				repetitions++;
+				return;
+			}
+			vider();
+			ecart = e;
+			repetitions = 1;
+		}
+
+		void vider()
+		{
+			if (repetitions == 0)
+				return;
+			varint(octets, repetitions);
+			varint(octets, ecart);
+			repetitions = 0;
+		}
+
+		void terminer(std::string &donnees)
+		{
+			vider();
+			donnees += octets;
+			octets.clear();
+			precedent = 0;
+		}
+	};
+
+	struct Colonne {
+		explicit Colonne(teleinfo::Label label) : label(label), texte(teleinfo::TEXTES & teleinfo::bit(label)) {}
+
+		teleinfo::Label label;
+		bool texte;
+		uint32_t min = UINT32_MAX;
+		uint32_t max = 0;
+		// présence
+		std::string presence;
+		bool presente = true;
+		uint32_t plage = 0;
+		// valeurs
+		Ecarts ecarts;
+		std::string textes;
+		char courant[teleinfo::TAILLE_TEXTE + 1] = {};
+		uint32_t repetitions = 0;
+
+		void ajouter(const teleinfo::Trame &trame)
+		{
+			bool p = trame.presente(label);
+			if (p != presente)
+			{
+				varint(presence, plage);
+				presente = p;
+				plage = 0;
+			}
+			plage++;
+			if (!p)
+				return;
+			if (!texte)
+			{
+				uint32_t v = trame.valeur(label);
+				min = v < min ? v : min;
+				max = v > max ? v : max;
+				ecarts.ajouter(v);
+				return;
+			}
+			const char *t = trame.texte(label);
+			if (repetitions != 0 && strcmp(t, courant) == 0)
+			{
+				repetitions++;
+				return;
+			}
+			vider_texte();
+			strcpy(courant, t);
+			repetitions = 1;
+		}
+
+		void vider_texte()
+		{
+			if (repetitions == 0)
+				return;
+			varint(textes, repetitions);
+			size_t n = strlen(courant);
+			textes += static_cast<char>(n);
+			textes.append(courant, n);
+			repetitions = 0;
+		}
+
+		void terminer(std::string &donnees)
+		{
+			varint(presence, plage);
+			varint(donnees, presence.size());
+			donnees += presence;
+			if (texte)
+			{
+				vider_texte();
+				donnees += textes;
+				textes.clear();
+			}
+			else
+				ecarts.terminer(donnees);
+			presence.clear();
+			presente = true;
+			plage = 0;
+			min = UINT32_MAX;
+			max = 0;
+		}
+	};
+
+	uint64_t etiquettes_;
+	uint32_t trames_par_bloc_;
+	uint32_t trames_ = 0;
+	uint64_t t_min_ = 0;
+	uint64_t t_max_ = 0;
+	Ecarts instants_;
+	std::vector<Colonne> colonnes_;
+};
+
+// Lecture d'un fichier projeté en mémoire : parcours des blocs, puis décodage des seules colonnes
+// utiles. Les rappels reçoivent le rang de la trame dans le bloc.
+class Fichier {
+ public:
+	struct Bloc {
+		const EnteteBloc *entete = nullptr;
+		const IndexColonne *index = nullptr;
+		const uint8_t *donnees = nullptr;
+	};
+
+	~Fichier()
+	{
+		if (base_ != nullptr)
+			munmap(const_cast<uint8_t *>(base_), taille_);
+	}
+
+	bool ouvrir(const char *chemin)
+	{
+		int fd = open(chemin, O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat st;
+		void *p = fstat(fd, &st) == 0 && st.st_size >= (off_t) sizeof(EnteteFichier)
+			? mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+		close(fd);
+		if (p == MAP_FAILED)
+			return false;
+		base_ = static_cast<const uint8_t *>(p);
+		taille_ = st.st_size;
+		madvise(p, taille_, MADV_SEQUENTIAL);
+		EnteteFichier e;
+		memcpy(&e, base_, sizeof(e));
+		if (e.magie != MAGIE || e.version != VERSION)
+			return false;
+		etiquettes_ = e.etiquettes;
+		nb_colonnes_ = __builtin_popcountll(etiquettes_);
+		position_ = sizeof(EnteteFichier);
+		return true;
+	}
+
+	uint64_t etiquettes() const { return etiquettes_; }
+	size_t taille() const { return taille_; }
+
+	// rang de la colonne d'une étiquette, -1 si absente du fichier
+	int colonne(teleinfo::Label label) const
+	{
+		if (!(etiquettes_ & teleinfo::bit(label)))
+			return -1;
+		return __builtin_popcountll(etiquettes_ & (teleinfo::bit(label) - 1));
+	}
+
+	// bloc suivant ; false à la fin du fichier ou sur un bloc tronqué
+	bool suivant(Bloc &b)
+	{
+		size_t index = sizeof(EnteteBloc) + nb_colonnes_ * sizeof(IndexColonne);
+		if (taille_ - position_ < index)
+			return false;
+		b.entete = reinterpret_cast<const EnteteBloc *>(base_ + position_);
+		if (b.entete->magie != MAGIE_BLOC || taille_ - position_ - index < b.entete->taille)
+			return false;
+		b.index = reinterpret_cast<const IndexColonne *>(base_ + position_ + sizeof(EnteteBloc));
+		b.donnees = base_ + position_ + index;
+		position_ += index + b.entete->taille;
+		return true;
+	}
+
+	void rembobiner() { position_ = sizeof(EnteteFichier); }
+	// fin du dernier bloc lu par suivant() : après un arrêt brutal, la suite est un bloc incomplet
+	size_t position() const { return position_; }
+
+	// rappel(rang, instant_ms)
+	template<typename RAPPEL>
+	void instants(const Bloc &b, RAPPEL &&rappel) const
+	{
+		const uint8_t *p = b.donnees;
+		const uint8_t *fin = b.donnees + (nb_colonnes_ != 0 ? b.index[0].position : b.entete->taille);
+		uint64_t v = 0;
+		for (uint32_t i = 0; i < b.entete->trames && p < fin;)
+		{
+			uint32_t n = lire_varint(p, fin);
+			int64_t e = dezigzag(lire_varint(p, fin));
+			for (uint32_t k = 0; k < n && i < b.entete->trames; k++, i++)
+			{
+				v += e;
+				rappel(i, v);
+			}
+		}
+	}
+
+	// rappel(rang, valeur) pour chaque trame où l'étiquette numérique est présente
+	template<typename RAPPEL>
+	void valeurs(const Bloc &b, int colonne, RAPPEL &&rappel) const
+	{
+		const uint8_t *pv, *fin;
+		uint32_t repetitions = 0;
+		int64_t ecart = 0;
+		uint64_t v = 0;
+		parcourir(b, colonne, pv, fin, [&](uint32_t i, uint32_t n) {
+			for (uint32_t k = 0; k < n; k++)
+			{
+				if (repetitions == 0)
+				{
+					repetitions = lire_varint(pv, fin);
+					ecart = dezigzag(lire_varint(pv, fin));
+					if (repetitions == 0)
+						return;
+				}
+				repetitions--;
+				v += ecart;
+				rappel(i + k, static_cast<uint32_t>(v));
+			}
+		});
+	}
+
+	// rappel(rang, texte, longueur) pour chaque trame où l'étiquette texte est présente
+	template<typename RAPPEL>
+	void textes(const Bloc &b, int colonne, RAPPEL &&rappel) const
+	{
+		const uint8_t *pv, *fin;
+		const char *texte = "";
+		uint8_t longueur = 0;
+		uint32_t repetitions = 0;
+		parcourir(b, colonne, pv, fin, [&](uint32_t i, uint32_t n) {
+			for (uint32_t k = 0; k < n; k++)
+			{
+				if (repetitions == 0)
+				{
+					repetitions = lire_varint(pv, fin);
+					longueur = pv < fin ? *pv++ : 0;
+					if (repetitions == 0 || longueur > fin - pv)
+						return;
+					texte = reinterpret_cast<const char *>(pv);
+					pv += longueur;
+				}
+				repetitions--;
+				rappel(i + k, texte, longueur);
+			}
+		});
+	}
+
+ protected:
+	// découpe la colonne en présence et valeurs, puis appelle plage(rang, n) pour chaque plage de
+	// trames où l'étiquette est présente
+	template<typename PLAGE>
+	void parcourir(const Bloc &b, int colonne, const uint8_t *&valeurs, const uint8_t *&fin, PLAGE &&plage) const
+	{
+		valeurs = fin = b.donnees;
+		const uint8_t *p = b.donnees + b.index[colonne].position;
+		fin = b.donnees + (colonne + 1 < nb_colonnes_ ? b.index[colonne + 1].position : b.entete->taille);
+		if (p > fin || fin > b.donnees + b.entete->taille)
+			return;
+		uint64_t taille_presence = lire_varint(p, fin);
+		if (taille_presence > static_cast<uint64_t>(fin - p))
+			return;
+		const uint8_t *fin_presence = p + taille_presence;
+		valeurs = fin_presence;
+		bool presente = true;
+		for (uint32_t i = 0; i < b.entete->trames && p < fin_presence; presente = !presente)
+		{
+			uint32_t n = lire_varint(p, fin_presence);
+			n = n < b.entete->trames - i ? n : b.entete->trames - i;
+			if (presente && n != 0)
+				plage(i, n);
+			i += n;
+		}
+	}
+
+	const uint8_t *base_ = nullptr;
+	size_t taille_ = 0;
+	size_t position_ = 0;
+	uint64_t etiquettes_ = 0;
+	int nb_colonnes_ = 0;
+};
+
+}  // namespace colonnes
@@ -0,0 +1,219 @@
+// Coupures de courant simulées sur le journal de tic_log (components/tic/tic_journal.h) : le
+// support de fichiers POSIX est enveloppé pour que l'alimentation tombe au milieu d'une opération
+// sur la flash (écriture à moitié faite, troncature, suppression ou renommage d'une compaction qui
+// n'ont pas lieu), puis le journal est rouvert comme au redémarrage de l'ESP et l'écriture reprend
+// à partir de l'échantillon retrouvé.
+//
+//   g++ -O2 -std=c++17 -I components/tic tools/tic_coupures.cpp -o tic_coupures
+//   ./tic_coupures                      # 40 coupures dans /tmp/tic_coupures (vidé au départ)
+//   ./tic_coupures -n 1000 -g 7 /tmp/j
+//
+// Vérifié après chaque redémarrage :
+//  - reprise : l'échantillon retrouvé est au moins le dernier d'un vidage réussi et au plus le
+//    dernier ajouté (rien de perdu après un vidage, rien d'inventé) ;
+//  - tout le journal : échantillons lisibles, dans l'ordre, valeurs intactes.
+// Code de sortie 1 au premier écart.
+//
+// options :
+//   -n N        nombre de coupures (40)
+//   -g GRAINE
+//   -s OCTETS   taille d'un segment (16384) ; la compaction commence au-delà de 4 segments
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+#include "tic_fichiers.h"
+#include "tic_journal.h"
+#include "tic_parser.h"
+
+using namespace teleinfo;
+
+static constexpr uint8_t ECHANTILLON = 1;	// cf. TicLog
+
+// charge d'un enregistrement, comme TicLog::Echantillon avec une colonne
+struct Echantillon {
+	uint32_t horodatage;
+	uint32_t secondes;
+	uint32_t valeur;
+};
+
+static uint32_t valeur_attendue(uint32_t horodatage) { return horodatage * 7 + 12345; }
+
+// Support qui perd l'alimentation à la coupure-ième opération d'écriture : une écriture n'en fait
+// qu'une partie tirée au hasard, les autres opérations n'ont pas lieu ; ensuite plus rien n'est écrit.
+class SupportCoupe : public journal::FichiersPosix {
+ public:
+	enum Operation : uint8_t { ECRITURE, TRONCATURE, SUPPRESSION, RENOMMAGE };
+	static constexpr const char *NOMS_OPERATIONS[] = {"écriture partielle", "troncature", "suppression", "renommage"};
+
+	SupportCoupe(std::mt19937 &alea, uint32_t coupure) : alea_(alea), restantes_(coupure) {}
+
+	bool coupe() const { return coupe_; }
+	Operation operation() const { return operation_; }
+
+	bool ajouter(const char *nom, const uint8_t *data, size_t n)
+	{
+		if (!passe(ECRITURE))
+		{
+			if (!coupe_apres_ || n < 2)
+				return false;
+			// écriture interrompue : une partie seulement atteint la flash
+			FichiersPosix::ajouter(nom, data, 1 + alea_() % (n - 1));
+			coupe_apres_ = false;
+			return false;
+		}
+		return FichiersPosix::ajouter(nom, data, n);
+	}
+	bool tronquer(const char *nom, size_t taille) { return passe(TRONCATURE) && FichiersPosix::tronquer(nom, taille); }
+	bool supprimer(const char *nom) { return passe(SUPPRESSION) && FichiersPosix::supprimer(nom); }
+	bool renommer(const char *ancien, const char *nouveau)
+	{
+		return passe(RENOMMAGE) && FichiersPosix::renommer(ancien, nouveau);
+	}
+
+ protected:
+	// false si l'opération n'a pas lieu ; coupe_apres_ : c'est celle de la coupure
+	bool passe(Operation o)
+	{
+		if (coupe_)
+			return false;
+		if (--restantes_ > 0)
+			return true;
+		coupe_ = coupe_apres_ = true;
+		operation_ = o;
+		return false;
+	}
+
+	std::mt19937 &alea_;
+	uint32_t restantes_;
+	bool coupe_ = false;
+	bool coupe_apres_ = false;
+	Operation operation_ = ECRITURE;
+};
+
+static uint32_t groupe_heure(uint8_t, const uint8_t *charge, uint8_t)
+{
+	uint32_t horodatage;
+	memcpy(&horodatage, charge, 4);
+	return horodatage / 3600;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned coupures = 40, graine = 1;
+	size_t segment = 16384;
+	int c;
+	while ((c = getopt(argc, argv, "n:g:s:")) != -1)
+	{
+		switch (c)
+		{
+			case 'n':
+				coupures = atoi(optarg);
+				break;
+			case 'g':
+				graine = atoi(optarg);
+				break;
+			case 's':
+				segment = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage : %s [-n coupures] [-g graine] [-s segment] [dossier]\n", argv[0]);
+				return 2;
+		}
+	}
+	std::string dossier = optind < argc ? argv[optind] : "/tmp/tic_coupures";
+	journal::FichiersPosix nettoyage;
+	if (!nettoyage.ouvrir(dossier.c_str()))
+	{
+		fprintf(stderr, "%s : dossier inaccessible\n", dossier.c_str());
+		return 1;
+	}
+	nettoyage.lister([&](const char *nom, size_t) { nettoyage.supprimer(nom); });
+
+	std::mt19937 alea(graine);
+	const uint8_t definition[] = {static_cast<uint8_t>(Label::PAPP)};
+	uint32_t horodatage = 1760000000;	// dernier échantillon ajouté
+	uint32_t confirme = 0;				// dernier échantillon d'un vidage réussi
+	unsigned par_operation[4] = {};
+	size_t tronques = 0, ajoutes = 0;
+
+	for (unsigned coupure = 0; coupure <= coupures; coupure++)
+	{
+		// redémarrage ; après la dernière coupure, le support ne coupe plus (vérification finale)
+		SupportCoupe support(alea, coupure < coupures ? 1 + alea() % 400 : UINT32_MAX);
+		support.ouvrir(dossier.c_str());
+		journal::Journal<SupportCoupe> j(support);
+		j.configurer(segment, 4 * segment);
+		j.set_definition(definition, sizeof(definition));
+		Echantillon reprise = {};
+		bool repris = false;
+		j.ouvrir([&](uint8_t type, const uint8_t *charge, uint8_t n) {
+			if (type == ECHANTILLON && n == sizeof(Echantillon))
+			{
+				memcpy(&reprise, charge, n);
+				repris = true;
+			}
+		});
+		tronques = j.tronques();
+		if (confirme != 0 && (!repris || reprise.horodatage < confirme || reprise.horodatage > horodatage ||
+			reprise.valeur != valeur_attendue(reprise.horodatage)))
+		{
+			printf("coupure %u : reprise à %u, attendue entre %u et %u\n", coupure, repris ? reprise.horodatage : 0,
+				confirme, horodatage);
+			return 1;
+		}
+		if (repris)
+			horodatage = reprise.horodatage;
+
+		// vérification de tout le journal
+		uint32_t precedent = 0;
+		size_t lus = 0;
+		bool ecart = false;
+		j.parcourir([&](uint32_t, uint8_t type, const uint8_t *charge, uint8_t n) {
+			if (type != ECHANTILLON)
+				return;
+			Echantillon e;
+			if (n != sizeof(e))
+			{
+				ecart = true;
+				return;
+			}
+			memcpy(&e, charge, n);
+			ecart |= e.horodatage <= precedent || e.valeur != valeur_attendue(e.horodatage);
+			precedent = e.horodatage;
+			lus++;
+		});
+		if (ecart)
+		{
+			printf("coupure %u : journal incohérent\n", coupure);
+			return 1;
+		}
+		if (coupure == coupures)
+		{
+			printf("%u coupures (", coupures);
+			for (uint8_t o = 0; o < 4; o++)
+				printf("%s%u %s", o == 0 ? "" : ", ", par_operation[o], SupportCoupe::NOMS_OPERATIONS[o]);
+			printf(") : %zu échantillons ajoutés, %zu dans le journal, %u segments, %zu octets, "
+				"%zu octets tronqués au dernier démarrage, aucun écart\n", ajoutes, lus, j.segments(), j.total(), tronques);
+			return 0;
+		}
+
+		// un échantillon par minute, vidé toutes les 5 minutes, jusqu'à la coupure
+		for (uint32_t k = 1; !support.coupe(); k++)
+		{
+			horodatage += 60;
+			Echantillon e = {horodatage, k * 60, valeur_attendue(horodatage)};
+			j.ajouter(ECHANTILLON, reinterpret_cast<const uint8_t *>(&e), sizeof(e));
+			ajoutes++;
+			if (k % 5 == 0 && j.vider())
+				confirme = horodatage;
+			j.compacter(groupe_heure);
+		}
+		par_operation[support.operation()]++;
+	}
+	return 0;
+}
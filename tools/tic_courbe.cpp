@@ -0,0 +1,162 @@
+// Vérification de la courbe de charge (components/tic/tic_courbe.h, tic_load_curve), sur PC.
+//
+//   g++ -O2 -std=c++17 -I components/tic tools/tic_courbe.cpp -o tic_courbe
+//   ./tic_courbe                 # 30 jours
+//   ./tic_courbe -j 365 -g 7
+//
+// Un compteur simulé consomme une puissance qui change à des secondes entières (200 à 6000 W,
+// paliers de 1 s à 10 min) : l'énergie de chaque demi-heure est connue exactement. Ses trames
+// (index en Wh entiers) sont vues par update() toutes les 1 ou 2 s, à la seconde près comme l'heure
+// de time_id, avec des trames perdues (5 s à 4 min, 3 fois par heure) et des coupures de 1 à
+// 20 minutes. Vérifié :
+//  - chaque point publié (ajouter() == true, dernier()) est la puissance moyenne exacte de sa
+//    demi-heure, à l'interpolation des bornes près. Par borne : 2 Wh (index entiers, division
+//    entière) et l'écart de puissance entre les deux trames qui l'encadrent sur leur intervalle
+//    (linéarisation), soit 8 W pour une demi-heure à puissance stable autour de ses bornes ;
+//  - il n'y a de point que si les deux bornes de la demi-heure tombent entre deux trames espacées
+//    d'au plus ECART_MAX : pas de point pour la première demi-heure ni autour d'une coupure ;
+//  - à la fin, derniers() relit l'anneau (7 jours) : mêmes points, demi-heures absentes comprises.
+// Code de sortie 1 au premier écart.
+//
+// options :
+//   -j JOURS    durée simulée (30)
+//   -c N        coupures par jour en moyenne (1)
+//   -g GRAINE
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <unistd.h>
+
+#include "tic_courbe.h"
+
+using namespace teleinfo;
+
+static constexpr size_t POINTS = 7 * courbe::POINTS_PAR_JOUR;
+
+int main(int argc, char **argv)
+{
+	unsigned jours = 30, graine = 1;
+	double coupures = 1;
+	int c;
+	while ((c = getopt(argc, argv, "j:c:g:")) != -1)
+	{
+		switch (c)
+		{
+			case 'j': jours = atoi(optarg); break;
+			case 'c': coupures = atof(optarg); break;
+			case 'g': graine = atoi(optarg); break;
+			default:
+				fprintf(stderr, "usage : %s [-j jours] [-c coupures par jour] [-g graine]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	std::mt19937 alea(graine);
+	const uint32_t debut = 1760000000 + alea() % courbe::PAS, duree = jours * 86400;
+	const uint32_t index_initial = 12345678;
+
+	// par borne de demi-heure : énergie exacte (Wh) ; borne franchie entre deux trames, connue si
+	// elles sont assez proches, avec l'erreur permise sur son index (Wh) ; une borne sautée pendant
+	// une coupure est absente
+	struct Borne {
+		bool connue;
+		double tolerance;
+	};
+	std::map<uint32_t, double> energies;
+	std::map<uint32_t, Borne> bornes;
+	courbe::Courbe<POINTS> courbe;
+	size_t trames = 0, points = 0, absents = 0, ecarts = 0;
+	double erreur_max = 0, erreur_totale = 0, rapport_max = 0;
+
+	// compter : point publié (statistiques d'erreur), sinon relecture de l'anneau
+	auto verifier = [&](uint32_t k, uint16_t w, bool compter) {
+		auto a = bornes.find(k), b = bornes.find(k + 1);
+		bool present = a != bornes.end() && b != bornes.end() && a->second.connue && b->second.connue;
+		if (present != (w != courbe::ABSENT))
+		{
+			if (ecarts++ < 10)
+				printf("demi-heure %u : %s, attendue %s\n", k, w != courbe::ABSENT ? "point" : "absente",
+					present ? "avec point" : "absente");
+			return;
+		}
+		if (!present)
+			return;
+		double reference = (energies[k + 1] - energies[k]) * 3600 / courbe::PAS;
+		double erreur = std::fabs(w - reference);
+		double tolerance = (a->second.tolerance + b->second.tolerance) * 3600 / courbe::PAS;
+		if (compter)
+		{
+			erreur_max = std::max(erreur_max, erreur);
+			erreur_totale += erreur;
+			rapport_max = std::max(rapport_max, erreur / tolerance);
+		}
+		if (erreur > tolerance && ecarts++ < 10)
+			printf("demi-heure %u : %u W, attendu %.1f W à %.1f W près\n", k, w, reference, tolerance);
+	};
+
+	// la puissance change aux secondes entières : e est l'énergie exacte au début de la seconde s
+	double e = 0;
+	uint32_t p = 0, palier = 0, t = 0, precedent = 0, dernier_point = 0;
+	uint32_t p_min = UINT32_MAX, p_max = 0;		// depuis la trame précédente
+	for (uint32_t s = 0; s < duree; s++, e += p / 3600.0)
+	{
+		if (palier-- == 0)
+		{
+			p = 200 + alea() % 5801;
+			palier = alea() % 600;
+		}
+		p_min = std::min(p_min, p);
+		p_max = std::max(p_max, p);
+		if ((debut + s) % courbe::PAS == 0)
+			energies[(debut + s) / courbe::PAS] = e;
+		// trame vue au début de cette seconde
+		if (s == t)
+		{
+			uint32_t instant = debut + s, index = index_initial + static_cast<uint32_t>(e);
+			if (trames != 0 && instant / courbe::PAS != precedent / courbe::PAS)
+				bornes[instant / courbe::PAS] = {instant - precedent <= courbe::ECART_MAX,
+					2 + double(p_max - p_min) * (instant - precedent) / 3600};
+			precedent = instant;
+			p_min = p_max = p;
+			trames++;
+			t += 1 + alea() % 2;
+			if (alea() % 1000 < 2)
+				t += 5 + alea() % 236;
+			if (alea() % 1000000 < coupures * 1000000 / (86400 / 1.5))
+				t += 60 + alea() % 1141;
+			if (!courbe.ajouter(instant, index))
+				continue;
+			uint32_t d;
+			uint16_t w;
+			courbe.dernier(d, w);
+			// demi-heures sautées (sans point) depuis le point précédent
+			for (uint32_t k = dernier_point != 0 ? dernier_point + 1 : d / courbe::PAS; k < d / courbe::PAS; k++, absents++)
+				verifier(k, courbe::ABSENT, false);
+			verifier(d / courbe::PAS, w, true);
+			dernier_point = d / courbe::PAS;
+			points++;
+		}
+	}
+
+	// relecture de l'anneau
+	size_t relus = 0, relus_absents = 0;
+	courbe.derniers(POINTS, [&](uint32_t d, uint16_t w) {
+		verifier(d / courbe::PAS, w, false);
+		relus++;
+		relus_absents += w == courbe::ABSENT;
+	});
+	ecarts += relus != POINTS;
+
+	size_t bornes_perdues = 0;
+	for (const auto &b : bornes)
+		bornes_perdues += !b.second.connue;
+	printf("%u jours, %zu trames, %zu bornes dans une coupure : %zu points publiés, %zu demi-heures absentes\n", jours,
+		trames, bornes_perdues, points, absents);
+	printf("erreur max %.2f W, moyenne %.3f W, au plus %.0f %% de la tolérance ; anneau de %zu points (%zu octets) "
+		"relu : %zu demi-heures dont %zu absentes ; %zu écarts\n", erreur_max, points ? erreur_totale / points : 0.0,
+		rapport_max * 100, POINTS, sizeof(courbe), relus, relus_absents, ecarts);
+	return ecarts == 0 ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+// Vérification des périodes tarifaires et des coûts (components/tic/tic_tarif.h, tic_cost), sur PC.
+//
+//   g++ -O2 -std=c++17 -I components/tic tools/tic_couts.cpp -o tic_couts
+//   ./tic_couts                  # 30 jours de trames synthétiques par option (tools/tic_synth.h)
+//   ./tic_couts -j 8 -g 3
+//
+// Les trames de chaque option (BASE, HC, EJP, Tempo en historique ; HC et Tempo en standard) sont
+// décodées par teleinfo::Lecteur et passées à tarif::Couts comme le fait tic_cost, qui sauvegarde
+// ses totaux toutes les 15 minutes (save_interval). L'ESP redémarre au hasard, une à deux fois par
+// jour : les totaux de la dernière sauvegarde sont restaurés et les trames reçues depuis, ainsi
+// que celles des 1 à 30 minutes d'arrêt, sont perdues. Vérifié :
+//  - le coût de chaque index est exactement son accroissement total multiplié par son prix, malgré
+//    les redémarrages (l'énergie consommée pendant l'arrêt est comptée à la reprise ; seule celle
+//    d'un index pas encore sauvegardé est perdue) ;
+//  - l'index qui avance d'une trame à l'autre est toujours celui de la période en cours
+//    (index_en_cours : PTEC ou NTARF, NTARF 1 à 10 pour EASF01 à EASF10) ;
+//  - le nom de la période (nom de l'index en historique, LTARF en standard) est celui de la même
+//    option en historique : "HC bleu", "pointe mobile"... ;
+//  - Tempo : la couleur du jour (PTEC ou STGE) est celle que DEMAIN ou STGE annonçait la veille.
+// Code de sortie 1 au premier écart.
+//
+// options :
+//   -j JOURS    durée simulée par option (30 : un cycle de couleurs Tempo de tic_synth.h)
+//   -g GRAINE
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_parser.h"
+#include "tic_synth.h"
+#include "tic_tarif.h"
+
+using namespace teleinfo;
+
+static constexpr uint8_t INDEX_MAX = 6;
+static constexpr double SAUVEGARDE = 900;	// s, save_interval par défaut de tic_cost
+
+struct Cas {
+	const char *nom;
+	synth::Profil profil;
+	std::vector<std::pair<Label, uint32_t>> prix;	// PRIX_UNITE
+};
+
+// noms des périodes en historique (tarif::nom_periode), sans ceux des index du mode standard
+static bool nom_connu(const char *nom)
+{
+	static constexpr Label HISTORIQUE[] = {Label::BASE, Label::HCHC, Label::HCHP, Label::EJPHN, Label::EJPHPM,
+		Label::BBRHCJB, Label::BBRHPJB, Label::BBRHCJW, Label::BBRHPJW, Label::BBRHCJR, Label::BBRHPJR};
+	// LTARF dit "heure(s) creuse(s)" en toutes lettres
+	static constexpr const char *STANDARD[] = {"heure creuse", "heure pleine", "heure normale"};
+	for (Label l : HISTORIQUE)
+		if (strcmp(nom, tarif::nom_periode(l)) == 0)
+			return true;
+	for (const char *s : STANDARD)
+		if (strcmp(nom, s) == 0)
+			return true;
+	return false;
+}
+
+// NTARF 1 à 10 : EASF01 à EASF10 (EASF07 à EASF10 ne suivent pas EASF06 dans l'enum)
+static size_t verifier_ntarf()
+{
+	size_t ecarts = 0;
+	for (uint32_t n = 0; n <= 11; n++)
+	{
+		char valeur[3];
+		snprintf(valeur, sizeof(valeur), "%02u", static_cast<unsigned>(n));
+		std::string t = "\x02\n" + synth::groupe("NTARF", valeur, true) + "\r\x03";
+		Trame trame;
+		Lecteur<Standard<1>> lecteur(trame);
+		lecteur.pousser(reinterpret_cast<const uint8_t *>(t.data()), t.size(), [](Evenement, const Groupe &, bool) {});
+		char attendu[] = "EASF00";
+		attendu[4] = '0' + n / 10;
+		attendu[5] = '0' + n % 10;
+		Label index = tarif::index_en_cours(trame);
+		const char *nom = index == Label::INCONNUE ? "INCONNUE" : NOMS[static_cast<uint8_t>(index)];
+		if (strcmp(nom, n >= 1 && n <= 10 ? attendu : "INCONNUE") != 0 && ecarts++ < 10)
+			printf("NTARF %u : %s\n", static_cast<unsigned>(n), nom);
+	}
+	return ecarts;
+}
+
+template<uint8_t N>
+static bool verifier(const Cas &cas, uint32_t jours, std::mt19937 &alea)
+{
+	auto configurer = [&](tarif::Couts<N> &c) {
+		for (uint8_t i = 0; i < N; i++)
+			c.configurer(i, cas.prix[i].first, cas.prix[i].second);
+	};
+	tarif::Couts<N> couts;
+	configurer(couts);
+	typename tarif::Couts<N>::Totaux sauvegarde = couts.totaux();
+
+	synth::Generateur gen(cas.profil);
+	Trame trame, precedente;
+	Lecteur<Auto<3>> lecteur(trame);
+	uint32_t premier[N] = {}, dernier[N] = {};
+	std::map<uint32_t, tarif::Couleur> annonces;
+	size_t trames = 0, redemarrages = 0, perdues = 0, periodes = 0, couleurs = 0, ecarts = 0;
+	double derniere_sauvegarde = 0, arret = 0;
+	bool precedente_connue = false;
+	// jusqu'à la reprise de l'ESP si la fin tombe pendant un arrêt
+	while (gen.secondes() < jours * 86400.0 || gen.secondes() < arret)
+	{
+		// jour de la trame, avant que le générateur n'avance
+		uint32_t jour = static_cast<uint32_t>(gen.secondes() / 86400);
+		std::string t = gen.trame();
+		lecteur.pousser(reinterpret_cast<const uint8_t *>(t.data()), t.size(), [](Evenement, const Groupe &, bool) {});
+		trames++;
+
+		// période : seul l'index en cours avance
+		Label en_cours = tarif::index_en_cours(trame);
+		if (precedente_connue)
+			for (uint8_t i = 0; i < N; i++)
+			{
+				Label l = cas.prix[i].first;
+				if (trame.valeur(l) != precedente.valeur(l) && l != en_cours && ecarts++ < 10)
+					printf("%s : %s avance pendant la période %s\n", cas.nom, NOMS[static_cast<uint8_t>(l)],
+						tarif::nom_periode(en_cours));
+			}
+		periodes += en_cours != Label::INCONNUE;
+		precedente = trame;
+		precedente_connue = true;
+
+		// nom de la période : LTARF en standard, comme en historique
+		char nom[TAILLE_TEXTE + 1];
+		tarif::nom_periode(trame, nom);
+		if (en_cours != Label::INCONNUE && !nom_connu(nom) && ecarts++ < 10)
+			printf("%s : période \"%s\" (%s)\n", cas.nom, nom, NOMS[static_cast<uint8_t>(en_cours)]);
+
+		// Tempo : couleur annoncée la veille
+		tarif::Couleur demain = tarif::couleur_demain(trame);
+		if (demain != tarif::Couleur::INCONNUE)
+			annonces[jour + 1] = demain;
+		tarif::Couleur couleur = tarif::couleur_jour(trame);
+		auto annonce = annonces.find(jour);
+		if (couleur != tarif::Couleur::INCONNUE && annonce != annonces.end())
+		{
+			couleurs++;
+			if (couleur != annonce->second && ecarts++ < 10)
+				printf("%s : jour %u %s, annoncé %s\n", cas.nom, jour, tarif::NOMS_COULEURS[static_cast<uint8_t>(couleur)],
+					tarif::NOMS_COULEURS[static_cast<uint8_t>(annonce->second)]);
+		}
+
+		// ESP arrêté : trames perdues
+		if (gen.secondes() < arret)
+		{
+			perdues++;
+			continue;
+		}
+		couts.ajouter(trame);
+		for (uint8_t i = 0; i < N; i++)
+			if (trame.recue(cas.prix[i].first))
+			{
+				dernier[i] = trame.valeur(cas.prix[i].first);
+				premier[i] = premier[i] != 0 ? premier[i] : dernier[i];
+			}
+		if (gen.secondes() - derniere_sauvegarde >= SAUVEGARDE)
+		{
+			sauvegarde = couts.totaux();
+			derniere_sauvegarde = gen.secondes();
+		}
+		// redémarrage : reprise sur la dernière sauvegarde
+		if (alea() % 57600 == 0)
+		{
+			couts = tarif::Couts<N>();
+			configurer(couts);
+			couts.restaurer(sauvegarde);
+			// index jamais sauvegardé : l'énergie depuis son premier relevé est perdue
+			for (uint8_t i = 0; i < N; i++)
+				if (sauvegarde.index[i] == 0)
+					premier[i] = 0;
+			arret = gen.secondes() + 60 + alea() % 1741;
+			redemarrages++;
+		}
+	}
+
+	uint64_t attendu_total = 0;
+	double kwh = 0;
+	for (uint8_t i = 0; i < N; i++)
+	{
+		uint64_t attendu = uint64_t(dernier[i] - premier[i]) * cas.prix[i].second;
+		attendu_total += attendu;
+		kwh += (dernier[i] - premier[i]) / 1000.0;
+		if (couts.cout(i) != attendu && ecarts++ < 10)
+			printf("%s : %s coûte %.4f €, attendu %.4f €\n", cas.nom, NOMS[static_cast<uint8_t>(cas.prix[i].first)],
+				couts.cout(i) * tarif::COUT_UNITE, attendu * tarif::COUT_UNITE);
+	}
+	ecarts += couts.cout_total() != attendu_total;
+	printf("%-18s %8zu %6zu %7zu %10.3f %10.4f %10zu %8zu %6zu\n", cas.nom, trames, redemarrages, perdues, kwh,
+		couts.cout_total() * tarif::COUT_UNITE, periodes, couleurs, ecarts);
+	return ecarts == 0;
+}
+
+static bool verifier(const Cas &cas, uint32_t jours, std::mt19937 &alea)
+{
+	switch (cas.prix.size())
+	{
+		case 1: return verifier<1>(cas, jours, alea);
+		case 2: return verifier<2>(cas, jours, alea);
+		default: return verifier<INDEX_MAX>(cas, jours, alea);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	unsigned jours = 30, graine = 1;
+	int c;
+	while ((c = getopt(argc, argv, "j:g:")) != -1)
+	{
+		switch (c)
+		{
+			case 'j': jours = atoi(optarg); break;
+			case 'g': graine = atoi(optarg); break;
+			default:
+				fprintf(stderr, "usage : %s [-j jours] [-g graine]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	using synth::Option;
+	const std::vector<std::pair<Label, uint32_t>> TEMPO = {{Label::BBRHCJB, 1296}, {Label::BBRHPJB, 1609},
+		{Label::BBRHCJW, 1486}, {Label::BBRHPJW, 1894}, {Label::BBRHCJR, 1568}, {Label::BBRHPJR, 7562}};
+	const std::vector<std::pair<Label, uint32_t>> TEMPO_STANDARD = {{Label::EASF01, 1296}, {Label::EASF02, 1609},
+		{Label::EASF03, 1486}, {Label::EASF04, 1894}, {Label::EASF05, 1568}, {Label::EASF06, 7562}};
+	const Cas CAS[] = {
+		{"historique BASE", {Option::BASE}, {{Label::BASE, 2516}}},
+		{"historique HC", {Option::HC}, {{Label::HCHC, 2068}, {Label::HCHP, 2700}}},
+		{"historique EJP", {Option::EJP}, {{Label::EJPHN, 1970}, {Label::EJPHPM, 10000}}},
+		{"historique Tempo", {Option::TEMPO}, TEMPO},
+		{"standard HC", {Option::HC, 1, true}, {{Label::EASF01, 2068}, {Label::EASF02, 2700}}},
+		{"standard Tempo", {Option::TEMPO, 1, true}, TEMPO_STANDARD},
+	};
+
+	std::mt19937 alea(graine);
+	printf("%u jours par option, sauvegarde toutes les %.0f s\n", jours, SAUVEGARDE);
+	printf("%-18s %8s %6s %7s %10s %10s %10s %8s %6s\n", "option", "trames", "redém.", "perdues", "kWh", "coût €",
+		"périodes", "couleurs", "écarts");
+	bool ok = verifier_ntarf() == 0;
+	for (const Cas &cas : CAS)
+		ok &= verifier(cas, jours, alea);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,328 @@
+// Décodage en lot de captures TIC volumineuses (archives de diagnostic, plusieurs Go).
+//
+//   g++ -O2 -std=c++17 -I components/tic tools/tic_decode.cpp -o tic_decode -pthread
+//   ./tic_decode -m standard -p 3 capture.bin > capture.csv
+//   ./tic_decode -f col -o capture.tcol capture.bin   # format en colonnes, lu par tic_col
+//   ./tic_decode -n capture.bin                 # débit seul, sans écrire la table
+//
+// La capture (octets bruts de la liaison) est projetée en mémoire (mmap) et découpée en morceaux
+// d'environ 4 Mo, chacun commençant sur un STX : un morceau contient des trames entières et se
+// décode indépendamment des autres, avec son propre teleinfo::Lecteur (la chaîne du composant).
+// Les morceaux sont répartis entre les threads au fil de l'eau ; le thread principal écrit leurs
+// tables dans l'ordre de la capture, les threads ne prenant jamais plus de 4 morceaux par thread
+// d'avance sur l'écriture (mémoire bornée quelle que soit la taille de la capture). Le résultat est
+// identique à un décodage séquentiel (-j 1).
+//
+// Table CSV : une ligne par trame terminée par ETX, la position de son STX dans la capture puis
+// une colonne par étiquette du mode, vide si l'étiquette est absente de la trame.
+// Format en colonnes (-f col, tools/tic_colonnes.h) : chaque morceau est encodé en blocs par son
+// thread. Une capture brute n'est pas datée : l'instant d'une trame est celui de son STX au débit
+// de la liaison depuis le début de la capture (-t pour fixer ce début).
+//
+// options :
+//   -m historic|standard|auto   mode du compteur (historic par défaut)
+//   -p 1|3                      nombre de phases (1 par défaut)
+//   -j N                        threads (tous les cœurs par défaut)
+//   -c MO                       taille des morceaux (4)
+//   -f csv|col                  format de la table (csv par défaut)
+//   -o FICHIER                  table (sortie standard par défaut)
+//   -b BAUDS                    débit de la liaison pour dater les trames (celui du mode, 1200 en auto)
+//   -t SECONDES                 instant du début de la capture, en secondes depuis 1970 (0)
+//   -n                          décode sans écrire la table (mesure de débit)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_colonnes.h"
+#include "tic_parser.h"
+
+using namespace teleinfo;
+
+struct Options {
+	std::string mode = "historic";
+	int phases = 1;
+	unsigned threads = 0;
+	size_t morceau = 4 << 20;
+	const char *sortie = nullptr;
+	bool table = true;
+	bool colonnes = false;
+	uint32_t bauds = 0;
+	uint64_t debut_ms = 0;
+};
+
+struct Morceau {
+	size_t debut = 0;
+	size_t fin = 0;
+	std::string table;
+	Statistiques stats;
+	bool pret = false;
+};
+
+static char *decimal(char *p, uint64_t v)
+{
+	char t[20];
+	int n = 0;
+	do
+		t[n++] = '0' + v % 10;
+	while ((v /= 10) != 0);
+	while (n > 0)
+		*p++ = t[--n];
+	return p;
+}
+
+// les valeurs TIC sont des caractères imprimables : guillemets seulement si nécessaire
+static char *texte(char *p, const char *t)
+{
+	if (strpbrk(t, ",\"") == nullptr)
+	{
+		size_t n = strlen(t);
+		memcpy(p, t, n);
+		return p + n;
+	}
+	*p++ = '"';
+	for (; *t != '\0'; t++)
+	{
+		if (*t == '"')
+			*p++ = '"';
+		*p++ = *t;
+	}
+	*p++ = '"';
+	return p;
+}
+
+template<typename MODE>
+static void entete(std::string &table)
+{
+	table = "octet";
+	for (uint8_t i = 0; i < NB_ETIQUETTES; i++)
+		if (MODE::ETIQUETTES & (uint64_t(1) << i))
+			table.append(",").append(NOMS[i]);
+	table += '\n';
+}
+
+template<typename MODE>
+static void decoder(const uint8_t *capture, Morceau &m, const Options &opt)
+{
+	Trame trame;
+	Lecteur<MODE> lecteur(trame);
+	colonnes::Ecrivain ecrivain(MODE::ETIQUETTES);
+	size_t stx = m.debut;
+	// une ligne tient toujours : valeurs de 10 chiffres au plus, textes de TAILLE_TEXTE doublés au pire
+	char ligne[24 + NB_ETIQUETTES * (2 * TAILLE_TEXTE + 4)];
+	const uint8_t *p = capture + m.debut;
+	const uint8_t *fin = capture + m.fin;
+	while (p < fin)
+	{
+		// ni STX ni ETX dans le paquet : un seul appel pour tout le paquet
+		size_t len = std::min<size_t>(fin - p, 4096);
+		const uint8_t *etx = static_cast<const uint8_t *>(memchr(p, ETX, len));
+		const uint8_t *debut = static_cast<const uint8_t *>(memchr(p, STX, etx != nullptr ? etx - p : len));
+		if (debut != nullptr)
+			len = debut - p + 1;
+		else if (etx != nullptr)
+			len = etx - p + 1;
+		if (debut != nullptr)
+			stx = debut - capture;
+		lecteur.pousser(p, len, [&](Evenement e, const Groupe &, bool) {
+			if (e != Evenement::FIN_TRAME || !opt.table)
+				return;
+			if (opt.colonnes)
+			{
+				ecrivain.ajouter(opt.debut_ms + stx * 10000 / opt.bauds, trame);
+				return;
+			}
+			char *l = decimal(ligne, stx);
+			for (uint8_t i = 0; i < NB_ETIQUETTES; i++)
+			{
+				if (!(MODE::ETIQUETTES & (uint64_t(1) << i)))
+					continue;
+				*l++ = ',';
+				Label label = static_cast<Label>(i);
+				if (!trame.presente(label))
+					continue;
+				l = TEXTES & bit(label) ? texte(l, trame.texte(label)) : decimal(l, trame.valeur(label));
+			}
+			*l++ = '\n';
+			m.table.append(ligne, l - ligne);
+		});
+		p += len;
+	}
+	if (opt.colonnes)
+	{
+		ecrivain.terminer();
+		m.table.swap(ecrivain.sortie);
+	}
+	m.stats = lecteur.stats;
+}
+
+template<typename MODE>
+static int traiter(const uint8_t *capture, size_t taille, const Options &opt)
+{
+	// bornes des morceaux : chaque morceau commence sur un STX (le premier au début de la capture)
+	std::vector<Morceau> morceaux;
+	for (size_t debut = 0; debut < taille;)
+	{
+		size_t suivant = taille;
+		if (taille - debut > opt.morceau)
+		{
+			const void *stx = memchr(capture + debut + opt.morceau, STX, taille - debut - opt.morceau);
+			if (stx != nullptr)
+				suivant = static_cast<const uint8_t *>(stx) - capture;
+		}
+		morceaux.emplace_back();
+		morceaux.back().debut = debut;
+		morceaux.back().fin = suivant;
+		debut = suivant;
+	}
+
+	FILE *sortie = nullptr;
+	if (opt.table)
+	{
+		sortie = opt.sortie != nullptr ? fopen(opt.sortie, "w") : stdout;
+		if (sortie == nullptr)
+		{
+			perror(opt.sortie);
+			return 1;
+		}
+		std::string ligne;
+		if (opt.colonnes)
+			colonnes::entete(ligne, MODE::ETIQUETTES);
+		else
+			entete<MODE>(ligne);
+		fwrite(ligne.data(), 1, ligne.size(), sortie);
+	}
+
+	const unsigned nb = std::max(1u, opt.threads != 0 ? opt.threads : std::thread::hardware_concurrency());
+	const size_t avance = 4 * nb;
+	std::atomic<size_t> prochain{0};
+	size_t ecrits = 0;
+	std::mutex verrou;
+	std::condition_variable termine, libere;
+
+	auto debut = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < nb; t++)
+		threads.emplace_back([&] {
+			for (size_t i; (i = prochain++) < morceaux.size();)
+			{
+				{
+					std::unique_lock<std::mutex> l(verrou);
+					libere.wait(l, [&] { return i < ecrits + avance; });
+				}
+				decoder<MODE>(capture, morceaux[i], opt);
+				std::lock_guard<std::mutex> l(verrou);
+				morceaux[i].pret = true;
+				termine.notify_all();
+			}
+		});
+
+	Statistiques total;
+	uint64_t octets = 0, trames = 0, groupes = 0;
+	for (Morceau &m : morceaux)
+	{
+		{
+			std::unique_lock<std::mutex> l(verrou);
+			termine.wait(l, [&] { return m.pret; });
+		}
+		if (sortie != nullptr)
+			fwrite(m.table.data(), 1, m.table.size(), sortie);
+		std::string().swap(m.table);
+		octets += m.stats.octets;
+		trames += m.stats.trames;
+		groupes += m.stats.groupes;
+		total.interruptions += m.stats.interruptions;
+		total.erreurs_checksum += m.stats.erreurs_checksum;
+		total.erreurs_format += m.stats.erreurs_format;
+		total.debordements += m.stats.debordements;
+		std::lock_guard<std::mutex> l(verrou);
+		ecrits++;
+		libere.notify_all();
+	}
+	for (std::thread &t : threads)
+		t.join();
+	if (sortie != nullptr && (fflush(sortie) != 0 || (sortie != stdout && fclose(sortie) != 0)))
+	{
+		perror(opt.sortie != nullptr ? opt.sortie : "stdout");
+		return 1;
+	}
+	double secondes = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+
+	fprintf(stderr, "%llu octets en %zu morceaux sur %u threads : %.2f s, %.0f Mo/s\n", (unsigned long long) octets,
+		morceaux.size(), nb, secondes, octets / secondes / 1e6);
+	fprintf(stderr, "%llu trames, %llu groupes, %u interruptions, %u checksum, %u format, %u débordements\n",
+		(unsigned long long) trames, (unsigned long long) groupes, total.interruptions, total.erreurs_checksum,
+		total.erreurs_format, total.debordements);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	int c;
+	while ((c = getopt(argc, argv, "m:p:j:c:f:o:b:t:n")) != -1)
+	{
+		switch (c)
+		{
+			case 'm': opt.mode = optarg; break;
+			case 'p': opt.phases = atoi(optarg); break;
+			case 'j': opt.threads = atoi(optarg); break;
+			case 'c': opt.morceau = static_cast<size_t>(atof(optarg) * (1 << 20)); break;
+			case 'f': opt.colonnes = strcmp(optarg, "col") == 0; break;
+			case 'o': opt.sortie = optarg; break;
+			case 'b': opt.bauds = atoi(optarg); break;
+			case 't': opt.debut_ms = atoll(optarg) * 1000ULL; break;
+			case 'n': opt.table = false; break;
+			default: optind = argc + 1; break;
+		}
+	}
+	if (optind != argc - 1 || (opt.phases != 1 && opt.phases != 3) || opt.morceau == 0
+		|| (opt.mode != "historic" && opt.mode != "standard" && opt.mode != "auto"))
+	{
+		fprintf(stderr, "usage : %s [-m historic|standard|auto] [-p 1|3] [-j threads] [-c Mo] [-f csv|col] [-o table] [-b bauds] [-t s] [-n] capture\n",
+			argv[0]);
+		return 2;
+	}
+
+	int fd = open(argv[optind], O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) < 0)
+	{
+		perror(argv[optind]);
+		return 1;
+	}
+	size_t taille = st.st_size;
+	if (taille == 0)
+		return 0;
+	void *p = mmap(nullptr, taille, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED)
+	{
+		perror("mmap");
+		return 1;
+	}
+	madvise(p, taille, MADV_SEQUENTIAL);
+	const uint8_t *capture = static_cast<const uint8_t *>(p);
+
+	if (opt.bauds == 0)
+		opt.bauds = opt.mode == "standard" ? 9600 : 1200;
+
+	const bool tri = opt.phases == 3;
+	if (opt.mode == "standard")
+		return tri ? traiter<Standard<3>>(capture, taille, opt) : traiter<Standard<1>>(capture, taille, opt);
+	if (opt.mode == "auto")
+		return tri ? traiter<Auto<3>>(capture, taille, opt) : traiter<Auto<1>>(capture, taille, opt);
+	return tri ? traiter<Historique<3>>(capture, taille, opt) : traiter<Historique<1>>(capture, taille, opt);
+}
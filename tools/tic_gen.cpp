@@ -0,0 +1,264 @@
+// Générateur de flux TIC pour les essais de charge et d'endurance.
+//
+//   g++ -O2 -std=c++17 -I components/tic -I tools tools/tic_gen.cpp -o tic_gen -lutil
+//   ./tic_gen -t hc -d 86400 -x 0 > journee.bin            # une journée, sans cadence
+//   ./tic_gen -s -p 3 -o pty -l /tmp/tic-compteur           # au débit réel sur un pseudo-terminal
+//
+// Les trames (tools/tic_synth.h) sont émises au débit exact de la liaison (10 bits par caractère
+// en 7E1), ou N fois plus vite (-x N ; -x 0 = sans attente). Avec le firmware host (host.yaml)
+// ou tic_replay, on fait ainsi passer des jours de temps simulé en quelques minutes. En fin
+// d'émission, le générateur affiche les trames et groupes émis et ceux qu'il a corrompus, à
+// comparer aux compteurs du composant (checksum, format, trames perdues).
+//
+// options :
+//   -t base|hc|ejp|tempo   option tarifaire (base par défaut)
+//   -s                     mode standard (historique par défaut)
+//   -p 1|3                 nombre de phases
+//   -w VA                  puissance apparente moyenne (1500 par défaut)
+//   -a N                   dépassements de puissance souscrite (ADPS/ADIR), pour 10000 trames
+//   -e PPM                 inversion de bits : probabilité par octet, en millionièmes
+//   -z PPM                 bruit : octets parasites insérés, en millionièmes
+//   -g GRAINE              graine des valeurs et des erreurs
+//   -d SECONDES            durée simulée (infinie par défaut)
+//   -x FACTEUR             accélération (1 par défaut, 0 = aussi vite que possible)
+//   -o stdout|pty|FICHIER  sortie (stdout par défaut)
+//   -l LIEN                avec -o pty : lien symbolique vers le pseudo-terminal
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <pty.h>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+
+#include "tic_synth.h"
+
+struct Options {
+	synth::Profil profil;
+	uint32_t inversions = 0;	// ppm
+	uint32_t bruit = 0;		// ppm
+	double duree = 0;
+	double acceleration = 1;
+	std::string sortie = "stdout";
+	std::string lien;
+};
+
+struct Compteurs {
+	uint64_t octets = 0;
+	uint64_t trames = 0;
+	uint64_t groupes = 0;
+	uint64_t groupes_corrompus = 0;
+	uint64_t depassements = 0;	// trames émises pendant un dépassement
+};
+
+static volatile sig_atomic_t arret = 0;
+
+static void arreter(int) { arret = 1; }
+
+// xorshift indépendant de celui du générateur de trames : les erreurs ne changent pas les valeurs
+static uint32_t alea = 0x9E3779B9;
+
+static uint32_t hasard()
+{
+	alea ^= alea << 13;
+	alea ^= alea >> 17;
+	alea ^= alea << 5;
+	return alea;
+}
+
+static bool tirage(uint32_t ppm) { return ppm != 0 && hasard() % 1000000 < ppm; }
+
+// Altère la trame : bits inversés et octets parasites, en comptant les groupes touchés.
+// Un STX ou un ETX altéré fait perdre la trame entière côté lecteur.
+static std::string alterer(const std::string &trame, const Options &opt, Compteurs &c)
+{
+	if (opt.inversions == 0 && opt.bruit == 0)
+		return trame;
+	std::string t;
+	t.reserve(trame.size() + 8);
+	bool corrompu = false;
+	for (char o : trame)
+	{
+		if (o == '\n')
+			corrompu = false;
+		if (tirage(opt.bruit))
+		{
+			t += static_cast<char>(0x20 + hasard() % 0x5F);
+			corrompu = true;
+		}
+		if (tirage(opt.inversions))
+		{
+			o ^= static_cast<char>(1 << (hasard() % 7));
+			corrompu = true;
+		}
+		t += o;
+		if (o == '\r' && corrompu)
+			c.groupes_corrompus++;
+	}
+	return t;
+}
+
+static bool ecrire(int fd, const char *data, size_t len)
+{
+	while (len > 0)
+	{
+		ssize_t n = write(fd, data, len);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			// pseudo-terminal plein : le lecteur ne suit pas, on attend
+			if (errno == EAGAIN)
+			{
+				usleep(1000);
+				continue;
+			}
+			return false;
+		}
+		data += n;
+		len -= n;
+	}
+	return true;
+}
+
+static double maintenant()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void attendre_jusqu_a(double instant)
+{
+	struct timespec ts;
+	ts.tv_sec = static_cast<time_t>(instant);
+	ts.tv_nsec = static_cast<long>((instant - ts.tv_sec) * 1e9);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR && !arret)
+		;
+}
+
+static int ouvrir_sortie(const Options &opt)
+{
+	if (opt.sortie == "stdout")
+		return STDOUT_FILENO;
+	if (opt.sortie != "pty")
+		return open(opt.sortie.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	int maitre, esclave;
+	char nom[64];
+	if (openpty(&maitre, &esclave, nom, nullptr, nullptr) < 0)
+		return -1;
+	struct termios t;
+	tcgetattr(esclave, &t);
+	cfmakeraw(&t);
+	tcsetattr(esclave, TCSANOW, &t);
+	// l'esclave reste ouvert : le lecteur peut se connecter et se déconnecter sans erreur d'écriture
+	fprintf(stderr, "pseudo-terminal %s\n", nom);
+	if (!opt.lien.empty())
+	{
+		unlink(opt.lien.c_str());
+		if (symlink(nom, opt.lien.c_str()) < 0)
+			perror(opt.lien.c_str());
+	}
+	return maitre;
+}
+
+static synth::Option option(const char *nom)
+{
+	if (strcmp(nom, "hc") == 0)
+		return synth::Option::HC;
+	if (strcmp(nom, "ejp") == 0)
+		return synth::Option::EJP;
+	if (strcmp(nom, "tempo") == 0)
+		return synth::Option::TEMPO;
+	return synth::Option::BASE;
+}
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	int c;
+	while ((c = getopt(argc, argv, "t:sp:w:a:e:z:g:d:x:o:l:")) != -1)
+	{
+		switch (c)
+		{
+			case 't': opt.profil.option = option(optarg); break;
+			case 's': opt.profil.standard = true; break;
+			case 'p': opt.profil.phases = atoi(optarg); break;
+			case 'w': opt.profil.puissance = atoi(optarg); break;
+			case 'a': opt.profil.depassements = atoi(optarg); break;
+			case 'e': opt.inversions = atoi(optarg); break;
+			case 'z': opt.bruit = atoi(optarg); break;
+			case 'g': opt.profil.graine = atoi(optarg); alea ^= opt.profil.graine * 2654435761u; break;
+			case 'd': opt.duree = atof(optarg); break;
+			case 'x': opt.acceleration = atof(optarg); break;
+			case 'o': opt.sortie = optarg; break;
+			case 'l': opt.lien = optarg; break;
+			default:
+				fprintf(stderr, "usage : %s [-t base|hc|ejp|tempo] [-s] [-p 1|3] [-w VA] [-a N] [-e ppm] [-z ppm] "
+					"[-g graine] [-d s] [-x facteur] [-o stdout|pty|fichier] [-l lien]\n", argv[0]);
+				return 2;
+		}
+	}
+	if (opt.profil.phases != 1 && opt.profil.phases != 3)
+	{
+		fprintf(stderr, "1 ou 3 phases\n");
+		return 2;
+	}
+
+	int fd = ouvrir_sortie(opt);
+	if (fd < 0)
+	{
+		perror(opt.sortie.c_str());
+		return 1;
+	}
+	signal(SIGINT, arreter);
+	signal(SIGTERM, arreter);
+	signal(SIGPIPE, arreter);
+
+	synth::Generateur gen(opt.profil);
+	Compteurs compteurs;
+	const double octet = 10.0 / gen.bauds();
+	const double origine = maintenant();
+	// écriture par paquets d'environ 10 ms de liaison
+	const size_t paquet = gen.bauds() / 10 / 100 + 1;
+
+	while (!arret && (opt.duree == 0 || gen.secondes() < opt.duree))
+	{
+		const double debut = gen.secondes();
+		std::string t = gen.trame();
+		compteurs.trames++;
+		compteurs.depassements += gen.depassement();
+		for (char o : t)
+			compteurs.groupes += o == '\n';
+		t = alterer(t, opt, compteurs);
+
+		for (size_t pos = 0; pos < t.size() && !arret; pos += paquet)
+		{
+			size_t n = std::min(paquet, t.size() - pos);
+			if (opt.acceleration > 0)
+				attendre_jusqu_a(origine + (debut + (pos + n) * octet) / opt.acceleration);
+			if (!ecrire(fd, t.data() + pos, n))
+			{
+				arret = 1;
+				break;
+			}
+			compteurs.octets += n;
+		}
+	}
+
+	fprintf(stderr, "%.0f s simulées en %.1f s : %llu octets, %llu trames (%llu en dépassement), "
+		"%llu groupes dont %llu corrompus\n", gen.secondes(), maintenant() - origine,
+		(unsigned long long) compteurs.octets, (unsigned long long) compteurs.trames,
+		(unsigned long long) compteurs.depassements, (unsigned long long) compteurs.groupes,
+		(unsigned long long) compteurs.groupes_corrompus);
+	if (!opt.lien.empty())
+		unlink(opt.lien.c_str());
+	return 0;
+}
@@ -0,0 +1,93 @@
+// Lecture d'un journal tic_log (components/tic/tic_journal.h) copié depuis la flash de l'ESP ou
+// écrit par la plateforme host : vérifie la reprise comme au démarrage de l'ESP puis affiche les
+// échantillons en CSV.
+//
+//   g++ -O2 -std=c++17 -I components/tic tools/tic_journal.cpp -o tic_journal
+//   ./tic_journal tic/                 # horodatage, secondes depuis le démarrage, étiquettes
+//   ./tic_journal -r tic/              # résumé : segments, compactés, octets, enregistrements
+//
+// Attention : comme au démarrage de l'ESP, une fin de dernier segment invalide est tronquée et un
+// fichier .tmp est supprimé.
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_fichiers.h"
+#include "tic_journal.h"
+#include "tic_parser.h"
+
+using namespace teleinfo;
+
+static constexpr uint8_t ECHANTILLON = 1;	// cf. TicLog
+
+int main(int argc, char **argv)
+{
+	bool resume = false;
+	int c;
+	while ((c = getopt(argc, argv, "r")) != -1)
+	{
+		if (c == 'r')
+			resume = true;
+		else
+			optind = argc + 1;
+	}
+	if (optind != argc - 1)
+	{
+		fprintf(stderr, "usage : %s [-r] dossier\n", argv[0]);
+		return 2;
+	}
+	journal::FichiersPosix fichiers;
+	if (!fichiers.ouvrir(argv[optind]))
+	{
+		fprintf(stderr, "%s : dossier inaccessible\n", argv[optind]);
+		return 1;
+	}
+	journal::Journal<journal::FichiersPosix> j(fichiers);
+	j.ouvrir([](uint8_t, const uint8_t *, uint8_t) {});
+
+	std::vector<uint8_t> labels;
+	uint64_t enregistrements = 0, echantillons = 0, compactes = 0;
+	uint32_t segment = 0;
+	j.parcourir([&](uint32_t s, uint8_t type, const uint8_t *charge, uint8_t n) {
+		enregistrements++;
+		if (s != segment)
+		{
+			segment = s;
+			journal::Lecture<journal::FichiersPosix> l(fichiers);
+			journal::EnteteSegment e;
+			l.ouvrir(s);
+			compactes += l.entete(e) && (e.drapeaux & journal::COMPACTE);
+		}
+		if (type == journal::DEFINITION)
+		{
+			std::vector<uint8_t> d(charge, charge + n);
+			if (d != labels && !resume)
+			{
+				printf("horodatage,secondes");
+				for (uint8_t l : d)
+					printf(",%s", l < NB_ETIQUETTES ? NOMS[l] : "?");
+				printf("\n");
+			}
+			labels = d;
+			return;
+		}
+		if (type != ECHANTILLON || n != 8 + 4 * labels.size())
+			return;
+		echantillons++;
+		if (resume)
+			return;
+		uint32_t v[2 + 8];
+		memcpy(v, charge, n);
+		printf("%u,%u", v[0], v[1]);
+		for (size_t i = 0; i < labels.size(); i++)
+			printf(",%u", v[2 + i]);
+		printf("\n");
+	});
+	if (resume)
+		printf("%u segments (%llu compactés), %zu octets de flash, %llu enregistrements dont %llu échantillons, "
+			"%zu octets tronqués\n", j.segments(), (unsigned long long) compactes, j.total(),
+			(unsigned long long) enregistrements, (unsigned long long) echantillons, j.tronques());
+	return 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Trame en une ligne JSON (ticd, tic_shm) :
+//   {"port":"/dev/ttyUSB0","t":1760000000123,"ADCO":"021861348497","BASE":12345678,"PAPP":1200}
+// seules les étiquettes présentes dans la trame sont écrites.
+
+#include <cstdint>
+#include <cstdio>
+
+#include "tic_parser.h"
+
+// retourne la longueur écrite, fin de ligne comprise ; la ligne est tronquée si taille est trop petite
+inline int trame_json(char *ligne, size_t taille, const char *port, uint64_t instant_ms, const teleinfo::Trame &trame)
+{
+	using namespace teleinfo;
+	int n = snprintf(ligne, taille, "{\"port\":\"%s\",\"t\":%llu", port, (unsigned long long) instant_ms);
+	for (uint8_t i = 0; i < NB_ETIQUETTES && n < (int) taille - 64; i++)
+	{
+		Label l = static_cast<Label>(i);
+		if (!trame.presente(l))
+			continue;
+		if (TEXTES & bit(l))
+		{
+			n += snprintf(ligne + n, taille - n, ",\"%s\":\"", NOMS[i]);
+			// les valeurs TIC sont des caractères imprimables, seuls " et \ sont à échapper
+			for (const char *c = trame.texte(l); *c != '\0' && n < (int) taille - 8; c++)
+			{
+				if (*c == '"' || *c == '\\')
+					ligne[n++] = '\\';
+				ligne[n++] = *c;
+			}
+			ligne[n++] = '"';
+		}
+		else
+			n += snprintf(ligne + n, taille - n, ",\"%s\":%u", NOMS[i], trame.valeur(l));
+	}
+	n += snprintf(ligne + n, taille - n, "}\n");
+	return n;
+}
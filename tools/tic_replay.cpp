@@ -0,0 +1,220 @@
+// Rejeu d'une capture TIC dans le composant ESPhome, sur PC.
+//
+//   g++ -O2 -std=c++17 -I components/tic -I tools/host tools/tic_replay.cpp -o tic_replay
+//   ./tic_replay [options] capture.bin
+//
+// my_tic_component.h est compilé tel quel contre les bouchons de tools/host (PollingComponent,
+// UARTDevice, Sensor, TextSensor) : update(), processBytes() et processCommand() sont ceux du
+// firmware. La capture (octets bruts de la liaison, "-" = entrée standard) est délivrée à l'UART
+// au débit de la liaison sur une horloge virtuelle, update() étant appelé à chaque intervalle.
+// Une capture horodatée (.ticc, components/tic/tic_capture.h, téléchargée depuis tic_capture) est
+// délivrée avec sa propre chronologie : chaque paquet arrive à l'instant où l'ESP l'avait lu, et
+// les anomalies de réception enregistrées sont comptées.
+//
+// options :
+//   -m historic|standard|auto   mode du compteur (historic par défaut)
+//   -p 1|3                      nombre de phases (1 par défaut)
+//   -i MS                       intervalle de update() en ms (1000 par défaut)
+//   -b BAUDS                    débit de la liaison (celui du mode par défaut)
+//   -n N                        rejoue N fois la capture (mesure de débit)
+//   -r FICHIER                  enregistre ce que lit update() en capture horodatée (.ticc)
+//   -v                          affiche les journaux du composant (-vv : niveau DEBUG)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "my_tic_component.h"
+
+namespace esphome {
+int log_niveau = 0;
+static uint64_t horloge_us = 0;
+uint32_t millis() { return horloge_us / 1000; }
+uint32_t micros() { return horloge_us; }
+}  // namespace esphome
+
+using namespace esphome;
+using teleinfo::Label;
+
+struct Options {
+	std::string mode = "historic";
+	int phases = 1;
+	uint32_t intervalle = 1000;
+	uint32_t bauds = 0;
+	int tours = 1;
+	const char *enregistrement = nullptr;
+};
+
+static bool lire(const char *chemin, std::vector<uint8_t> &capture)
+{
+	FILE *f = strcmp(chemin, "-") == 0 ? stdin : fopen(chemin, "rb");
+	if (f == nullptr)
+		return false;
+	uint8_t buff[4096];
+	size_t n;
+	while ((n = fread(buff, 1, sizeof(buff), f)) > 0)
+		capture.insert(capture.end(), buff, buff + n);
+	if (f != stdin)
+		fclose(f);
+	return true;
+}
+
+template<typename MODE>
+static int rejouer(const std::vector<uint8_t> &capture, const Options &opt)
+{
+	// toutes les étiquettes du mode sont décodées et publiées
+	static tic::MyTicComponent<MODE, MODE::ETIQUETTES, MODE::ETIQUETTES> compteur;
+	uart::UARTComponent uart;
+	compteur.set_uart_parent(&uart);
+	compteur.set_update_interval(opt.intervalle);
+	compteur.setup();
+
+	// enregistrement : anneau assez grand pour ne rien écraser
+	const uint64_t intervalle_us = opt.intervalle * 1000ULL;
+	std::vector<uint8_t> zone;
+	teleinfo::capture::Anneau anneau;
+	if (opt.enregistrement != nullptr)
+	{
+		zone.resize(2 * capture.size() * opt.tours + 4096);
+		anneau.attribuer(zone.data(), zone.size(), opt.bauds);
+		compteur.set_capture(&anneau);
+	}
+
+	// 7E1 : 10 bits par caractère
+	const uint32_t bauds = opt.bauds != 0 ? opt.bauds : (MODE::BAUDS != 0 ? MODE::BAUDS : 1200);
+	const uint64_t octets_par_intervalle = std::max<uint64_t>(1, uint64_t(bauds) / 10 * opt.intervalle / 1000);
+	uint32_t appels = 0;
+	size_t attente_max = 0;
+	uint32_t paquets = 0, drapeaux[4] = {};
+
+	const bool horodatee = capture.size() >= sizeof(teleinfo::capture::Entete)
+		&& memcmp(capture.data(), &teleinfo::capture::MAGIE, 4) == 0;
+	auto debut = std::chrono::steady_clock::now();
+	for (int t = 0; t < opt.tours; t++)
+	{
+		if (horodatee)
+		{
+			// chaque paquet arrive à son instant de lecture, update() à chaque intervalle
+			const uint8_t *p = capture.data() + sizeof(teleinfo::capture::Entete);
+			const uint8_t *fin = capture.data() + capture.size();
+			uint64_t instant = esphome::horloge_us;
+			uint64_t prochain = esphome::horloge_us + intervalle_us;
+			teleinfo::capture::Enregistrement e;
+			while (teleinfo::capture::lire(p, fin, e))
+			{
+				instant += e.ecart_us;
+				for (; prochain <= instant; prochain += intervalle_us, appels++)
+				{
+					esphome::horloge_us = prochain;
+					compteur.update();
+				}
+				uart.ecrire(e.octets, e.longueur);
+				attente_max = std::max(attente_max, uart.rx.size());
+				paquets++;
+				for (int b = 0; b < 4; b++)
+					drapeaux[b] += (e.drapeaux >> b) & 1;
+			}
+			esphome::horloge_us = prochain;
+			compteur.update();
+			appels++;
+			continue;
+		}
+		for (size_t pos = 0; pos < capture.size();)
+		{
+			size_t n = std::min<size_t>(octets_par_intervalle, capture.size() - pos);
+			uart.ecrire(&capture[pos], n);
+			pos += n;
+			attente_max = std::max(attente_max, uart.rx.size());
+			esphome::horloge_us += intervalle_us;
+			compteur.update();
+			appels++;
+		}
+	}
+	std::chrono::duration<double, std::nano> duree = std::chrono::steady_clock::now() - debut;
+
+	if (opt.enregistrement != nullptr)
+	{
+		std::vector<uint8_t> ticc(anneau.taille_export());
+		anneau.exporter(ticc.data(), ticc.size(), 0);
+		FILE *f = fopen(opt.enregistrement, "wb");
+		if (f == nullptr || fwrite(ticc.data(), 1, ticc.size(), f) != ticc.size() || fclose(f) != 0)
+			perror(opt.enregistrement);
+	}
+	if (horodatee)
+		printf("capture horodatée : %u paquets, tampon plein %u, échec de lecture %u, perte %u, réception coupée %u\n",
+			paquets, drapeaux[0], drapeaux[1], drapeaux[2], drapeaux[3]);
+
+	const teleinfo::Statistiques &s = compteur.get_stats();
+	printf("octets %u, trames %u, groupes %u, checksum %u, format %u, débordements %u, interruptions %u\n",
+		s.octets, s.trames, s.groupes, s.erreurs_checksum, s.erreurs_format, s.debordements, s.interruptions);
+	printf("temps simulé %.1f s, %u appels à update(), %zu octets au plus en attente dans l'UART\n",
+		esphome::horloge_us / 1e6, appels, attente_max);
+	printf("temps réel %.3f ms, %.1f ns/octet\n", duree.count() / 1e6, s.octets != 0 ? duree.count() / s.octets : 0.0);
+
+	printf("\n%-10s %8s  %s\n", "étiquette", "publiés", "dernière valeur");
+	for (uint8_t i = 0; i < teleinfo::NB_ETIQUETTES; i++)
+	{
+		Label l = static_cast<Label>(i);
+		if ((MODE::ETIQUETTES & teleinfo::bit(l)) == 0)
+			continue;
+		if (teleinfo::TEXTES & teleinfo::bit(l))
+		{
+			text_sensor::TextSensor *ts = compteur.get_text_sensor(l);
+			if (ts->publications != 0)
+				printf("%-10s %8u  %s\n", teleinfo::NOMS[i], ts->publications, ts->state.c_str());
+		}
+		else
+		{
+			sensor::Sensor *se = compteur.get_sensor(l);
+			if (se->publications != 0)
+				printf("%-10s %8u  %g\n", teleinfo::NOMS[i], se->publications, se->state);
+		}
+	}
+	return s.trames != 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	int c;
+	while ((c = getopt(argc, argv, "m:p:i:b:n:r:v")) != -1)
+	{
+		switch (c)
+		{
+			case 'm': opt.mode = optarg; break;
+			case 'p': opt.phases = atoi(optarg); break;
+			case 'i': opt.intervalle = atoi(optarg); break;
+			case 'b': opt.bauds = atoi(optarg); break;
+			case 'n': opt.tours = atoi(optarg); break;
+			case 'r': opt.enregistrement = optarg; break;
+			case 'v': esphome::log_niveau += 2; break;
+			default: return 2;
+		}
+	}
+	if (optind != argc - 1 || opt.intervalle == 0 || opt.tours < 1 || (opt.phases != 1 && opt.phases != 3))
+	{
+		fprintf(stderr, "usage : %s [-m historic|standard|auto] [-p 1|3] [-i ms] [-b bauds] [-n tours] [-r sortie.ticc] [-v] capture\n", argv[0]);
+		return 2;
+	}
+
+	std::vector<uint8_t> capture;
+	if (!lire(argv[optind], capture))
+	{
+		perror(argv[optind]);
+		return 2;
+	}
+
+	bool tri = opt.phases == 3;
+	if (opt.mode == "historic")
+		return tri ? rejouer<teleinfo::Historique<3>>(capture, opt) : rejouer<teleinfo::Historique<1>>(capture, opt);
+	if (opt.mode == "standard")
+		return tri ? rejouer<teleinfo::Standard<3>>(capture, opt) : rejouer<teleinfo::Standard<1>>(capture, opt);
+	if (opt.mode == "auto")
+		return tri ? rejouer<teleinfo::Auto<3>>(capture, opt) : rejouer<teleinfo::Auto<1>>(capture, opt);
+	fprintf(stderr, "mode inconnu : %s\n", opt.mode.c_str());
+	return 2;
+}
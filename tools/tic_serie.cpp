@@ -0,0 +1,375 @@
+// Vérification de la série compressée (components/tic/tic_serie.h) et de son export CSV/JSON
+// (tic_series, tic_export), sur PC.
+//
+//   g++ -O2 -std=c++17 -I components/tic tools/tic_serie.cpp -o tic_serie
+//   ./tic_serie                                    # trames synthétiques (tools/tic_synth.h)
+//                                                  # et PAPP en marche aléatoire
+//   ./tic_serie -z 65536 -n 200000
+//   ./tic_serie -m standard -e SINSTS,EAST capture.bin
+//
+// Chaque trame décodée par teleinfo::Lecteur est ajoutée à une Serie comme le fait tic_series, à
+// l'instant où update() l'aurait vue (intervalle -i). Puis, pour les échantillons encore présents
+// dans la zone :
+//  - relecture : chacun est comparé à la trame d'origine (instant à 100 ms près, valeurs exactes) ;
+//  - export : le CSV de serie::Export, produit en morceaux de taille aléatoire comme le tampon
+//    d'envoi du serveur web, est relu et comparé de même, ainsi qu'un export d'une colonne sur la
+//    seconde moitié de la période (from, labels) ;
+//  - octets par échantillon, durée gardée dans la zone, débit de l'export CSV et JSON.
+// Code de sortie 1 au premier écart.
+//
+// options :
+//   -n N           trames synthétiques par flux (100000)
+//   -z OCTETS      taille de la zone (4096, celle de tic_series par défaut)
+//   -i MS          intervalle d'update() (1000)
+//   -m historic|standard   mode des captures (historic), qui donne le débit de la liaison
+//   -e A,B...      étiquettes des captures, 4 au plus (PAPP,IINST ; SINSTS,IRMS1 en standard)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_parser.h"
+#include "tic_serie.h"
+#include "tic_synth.h"
+
+using namespace teleinfo;
+
+static constexpr uint8_t COLONNES_MAX = 4;
+
+struct Echantillon {
+	uint64_t instant_ms;
+	uint32_t valeurs[COLONNES_MAX];
+};
+
+struct Flux {
+	std::string nom;
+	std::vector<Echantillon> echantillons;
+	std::vector<Label> labels;
+};
+
+static bool etiquettes(const char *liste, std::vector<Label> &labels)
+{
+	labels.clear();
+	while (*liste != '\0')
+	{
+		const char *fin = strchr(liste, ',');
+		size_t n = fin != nullptr ? static_cast<size_t>(fin - liste) : strlen(liste);
+		uint8_t i = 0;
+		while (i < NB_ETIQUETTES && !(strlen(NOMS[i]) == n && strncmp(NOMS[i], liste, n) == 0))
+			i++;
+		if (i == NB_ETIQUETTES || labels.size() == COLONNES_MAX)
+			return false;
+		labels.push_back(static_cast<Label>(i));
+		liste += fin != nullptr ? n + 1 : n;
+	}
+	return !labels.empty();
+}
+
+// décodage d'un flux : une ligne par trame complète, vue au update() qui suit la fin de la trame
+template<typename MODE>
+static void decoder(const std::string &octets, uint32_t bauds, uint32_t intervalle, Flux &f)
+{
+	Trame trame;
+	Lecteur<MODE> l(trame);
+	size_t position = 0;
+	const uint8_t *p = reinterpret_cast<const uint8_t *>(octets.data());
+	for (; position < octets.size(); position++)
+		l.pousser(p + position, 1, [&](Evenement e, const Groupe &, bool) {
+			if (e != Evenement::FIN_TRAME)
+				return;
+			// 7E1 : 10 bits par octet
+			uint64_t fin_ms = (position + 1) * 10000ULL / bauds;
+			Echantillon s = {(fin_ms / intervalle + 1) * intervalle, {}};
+			for (size_t c = 0; c < f.labels.size(); c++)
+				s.valeurs[c] = trame.valeur(f.labels[c]);
+			f.echantillons.push_back(s);
+		});
+}
+
+// trames synthétiques ; les instants suivent l'horloge du générateur (intervalle entre trames compris)
+static Flux synthetique(const char *nom, const synth::Profil &profil, const char *liste, uint32_t trames,
+	uint32_t intervalle)
+{
+	Flux f;
+	f.nom = nom;
+	etiquettes(liste, f.labels);
+	synth::Generateur gen(profil);
+	Trame trame;
+	Lecteur<Auto<3>> l(trame);
+	for (uint32_t i = 0; i < trames; i++)
+	{
+		std::string t = gen.trame();
+		l.pousser(reinterpret_cast<const uint8_t *>(t.data()), t.size(), [](Evenement, const Groupe &, bool) {});
+		uint64_t fin_ms = static_cast<uint64_t>(gen.secondes() * 1000);
+		Echantillon s = {(fin_ms / intervalle + 1) * intervalle, {}};
+		for (size_t c = 0; c < f.labels.size(); c++)
+			s.valeurs[c] = trame.valeur(f.labels[c]);
+		f.echantillons.push_back(s);
+	}
+	return f;
+}
+
+// PAPP en marche aléatoire, plus régulière que le bruit de tic_synth.h (comme un compteur dont la
+// charge change peu) : pas de 10 à 100 VA sur 3 trames sur 10, une trame toutes les 1,5 s ; IINST et
+// BASE en découlent. colonnes : les premières de PAPP, IINST, BASE (tableau du README)
+static Flux marche(uint8_t colonnes, uint32_t trames, uint32_t intervalle)
+{
+	Flux f;
+	f.nom = "marche aléatoire";
+	etiquettes("PAPP,IINST,BASE", f.labels);
+	f.labels.resize(colonnes);
+	std::mt19937 alea(1);
+	uint32_t papp = 450, base = 12345678;
+	double wh = 0;
+	for (uint32_t i = 0; i < trames; i++)
+	{
+		if (alea() % 10 < 3)
+		{
+			int32_t pas = (static_cast<int32_t>(alea() % 21) - 10) * 10;
+			if (static_cast<int32_t>(papp) + pas > 100)
+				papp += pas;
+		}
+		wh += papp * 1.5 / 3600;
+		base += static_cast<uint32_t>(wh);
+		wh -= static_cast<uint32_t>(wh);
+		uint64_t fin_ms = 1000 + i * 1500ULL;
+		f.echantillons.push_back({(fin_ms / intervalle + 1) * intervalle, {papp, (papp + 115) / 230, base}});
+	}
+	return f;
+}
+
+static bool meme_instant(uint64_t lu, uint64_t attendu)
+{
+	return lu == attendu / serie::RESOLUTION_MS * serie::RESOLUTION_MS;
+}
+
+// export complet dans une chaîne, en morceaux de 1 à 1500 octets
+template<uint8_t N>
+static std::string exporter(serie::Export<N> &e, std::mt19937 &alea)
+{
+	std::string sortie;
+	uint8_t tampon[1500];
+	size_t n;
+	while ((n = e.remplir(tampon, 1 + alea() % sizeof(tampon))) > 0)
+		sortie.append(reinterpret_cast<const char *>(tampon), n);
+	return sortie;
+}
+
+// lignes CSV comparées aux échantillons [premier, premier + attendus) ; colonnes : masque exporté
+template<uint8_t N>
+static size_t comparer_csv(const std::string &csv, const Echantillon *premier, size_t attendus, uint32_t colonnes,
+	const std::vector<Label> &labels)
+{
+	size_t ecarts = 0, lignes = 0;
+	std::string en_tete = "t_ms";
+	for (uint8_t c = 0; c < N; c++)
+		if ((colonnes >> c) & 1)
+			en_tete += std::string(",") + NOMS[static_cast<uint8_t>(labels[c])];
+	size_t fin = csv.find('\n');
+	if (fin == std::string::npos || csv.compare(0, fin, en_tete) != 0)
+		return 1;
+	for (size_t debut = fin + 1; debut < csv.size(); debut = fin + 1, lignes++)
+	{
+		fin = csv.find('\n', debut);
+		if (fin == std::string::npos || lignes == attendus)
+			return ecarts + 1;
+		const Echantillon &e = premier[lignes];
+		char *p;
+		ecarts += !meme_instant(strtoull(csv.c_str() + debut, &p, 10), e.instant_ms);
+		for (uint8_t c = 0; c < N; c++)
+			if ((colonnes >> c) & 1)
+				ecarts += *p != ',' || strtoul(p + 1, &p, 10) != e.valeurs[c];
+		ecarts += p != csv.c_str() + fin;
+	}
+	return ecarts + (lignes != attendus);
+}
+
+// débit du formateur seul (Mo/s), tampon d'envoi de 1460 octets
+template<uint8_t N>
+static double debit(const serie::Serie<N> &s, const char *const *noms, typename serie::Export<N>::Format format,
+	size_t &octets)
+{
+	serie::Export<N> e;
+	uint8_t tampon[1460];
+	uint64_t total = 0;
+	auto debut = std::chrono::steady_clock::now();
+	std::chrono::duration<double> duree{};
+	do
+	{
+		e.commencer(s, noms, (uint32_t(1) << N) - 1, 0, UINT64_MAX, format);
+		size_t n;
+		while ((n = e.remplir(tampon, sizeof(tampon))) > 0)
+			total += n;
+		octets = e.octets();
+		duree = std::chrono::steady_clock::now() - debut;
+	} while (duree.count() < 0.2);
+	return total / duree.count() / 1e6;
+}
+
+template<uint8_t N>
+static bool verifier(const Flux &f, size_t taille)
+{
+	std::vector<uint8_t> zone(taille);
+	uint32_t cumulatives = 0;
+	const char *noms[N];
+	for (uint8_t c = 0; c < N; c++)
+	{
+		noms[c] = NOMS[static_cast<uint8_t>(f.labels[c])];
+		if (INDEX & bit(f.labels[c]))
+			cumulatives |= uint32_t(1) << c;
+	}
+	serie::Serie<N> s;
+	s.attribuer(zone.data(), taille, cumulatives);
+	for (const Echantillon &e : f.echantillons)
+	{
+		uint32_t v[N];
+		memcpy(v, e.valeurs, sizeof(v));
+		s.ajouter(e.instant_ms, v);
+	}
+
+	// relecture
+	size_t presents = s.echantillons(), lus = 0, ecarts = 0;
+	const Echantillon *premier = f.echantillons.data() + f.echantillons.size() - presents;
+	typename serie::Serie<N>::Curseur c;
+	uint64_t t;
+	uint32_t v[N];
+	for (s.debut(c); s.suivant(c, t, v); lus++)
+	{
+		if (lus == presents)
+		{
+			ecarts++;
+			break;
+		}
+		ecarts += !meme_instant(t, premier[lus].instant_ms) || memcmp(v, premier[lus].valeurs, sizeof(v)) != 0;
+	}
+	ecarts += lus != presents;
+
+	// export complet, puis dernière colonne sur la seconde moitié
+	std::mt19937 alea(presents);
+	serie::Export<N> e;
+	e.commencer(s, noms, (uint32_t(1) << N) - 1, 0, UINT64_MAX, serie::Export<N>::CSV);
+	ecarts += comparer_csv<N>(exporter(e, alea), premier, presents, (uint32_t(1) << N) - 1, f.labels);
+	uint64_t milieu = premier[presents / 2].instant_ms / serie::RESOLUTION_MS * serie::RESOLUTION_MS;
+	size_t apres = presents / 2;
+	while (apres > 0 && premier[apres - 1].instant_ms / serie::RESOLUTION_MS * serie::RESOLUTION_MS >= milieu)
+		apres--;
+	e.commencer(s, noms, uint32_t(1) << (N - 1), milieu, UINT64_MAX, serie::Export<N>::CSV);
+	ecarts += comparer_csv<N>(exporter(e, alea), premier + apres, presents - apres, uint32_t(1) << (N - 1), f.labels);
+
+	size_t octets_csv, octets_json;
+	double csv = debit(s, noms, serie::Export<N>::CSV, octets_csv);
+	double json = debit(s, noms, serie::Export<N>::JSON, octets_json);
+	std::string liste;
+	for (uint8_t k = 0; k < N; k++)
+		liste += std::string(k == 0 ? "" : ",") + noms[k];
+	double heures = presents > 1 ? (premier[presents - 1].instant_ms - premier[0].instant_ms) / 3.6e6 : 0;
+	printf("%-18s %-26s %7zu %7.2f %7.1f %7zu %6.0f %7zu %6.0f %6zu\n", f.nom.c_str(), liste.c_str(), presents,
+		presents ? double(s.octets()) / presents : 0.0, heures, octets_csv, csv, octets_json, json, ecarts);
+	return ecarts == 0;
+}
+
+static bool verifier(const Flux &f, size_t taille)
+{
+	switch (f.labels.size())
+	{
+		case 1: return verifier<1>(f, taille);
+		case 2: return verifier<2>(f, taille);
+		case 3: return verifier<3>(f, taille);
+		default: return verifier<4>(f, taille);
+	}
+}
+
+static bool lire(const char *chemin, std::string &capture)
+{
+	FILE *f = fopen(chemin, "rb");
+	if (f == nullptr)
+		return false;
+	char buff[4096];
+	size_t n;
+	while ((n = fread(buff, 1, sizeof(buff), f)) > 0)
+		capture.append(buff, n);
+	fclose(f);
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	std::string mode = "historic";
+	const char *liste = nullptr;
+	uint32_t trames = 100000, intervalle = 1000;
+	size_t taille = 4096;
+	int c;
+	while ((c = getopt(argc, argv, "n:z:i:m:e:")) != -1)
+	{
+		switch (c)
+		{
+			case 'n': trames = atoi(optarg); break;
+			case 'z': taille = atoi(optarg); break;
+			case 'i': intervalle = atoi(optarg); break;
+			case 'm': mode = optarg; break;
+			case 'e': liste = optarg; break;
+			default:
+				fprintf(stderr, "usage : %s [-n trames] [-z octets] [-i ms] [-m historic|standard] [-e A,B...] [capture...]\n",
+					argv[0]);
+				return 2;
+		}
+	}
+	if (taille < 2 * serie::TAILLE_BLOC || intervalle == 0)
+	{
+		fprintf(stderr, "zone d'au moins %u octets, intervalle non nul\n", (unsigned) (2 * serie::TAILLE_BLOC));
+		return 2;
+	}
+
+	std::vector<Flux> flux;
+	if (optind < argc)
+	{
+		for (int i = optind; i < argc; i++)
+		{
+			Flux f;
+			f.nom = argv[i];
+			if (!etiquettes(liste != nullptr ? liste : mode == "standard" ? "SINSTS,IRMS1" : "PAPP,IINST", f.labels))
+			{
+				fprintf(stderr, "%s : étiquettes inconnues ou plus de %u\n", liste, COLONNES_MAX);
+				return 2;
+			}
+			std::string capture;
+			if (!lire(argv[i], capture))
+			{
+				perror(argv[i]);
+				return 2;
+			}
+			if (mode == "standard")
+				decoder<Standard<3>>(capture, 9600, intervalle, f);
+			else
+				decoder<Historique<3>>(capture, 1200, intervalle, f);
+			flux.push_back(std::move(f));
+		}
+	}
+	else
+	{
+		using synth::Option;
+		for (uint8_t n = 1; n <= 3; n++)
+			flux.push_back(marche(n, trames, intervalle));
+		flux.push_back(synthetique("historique BASE", {}, "PAPP", trames, intervalle));
+		flux.push_back(synthetique("historique BASE", {}, "PAPP,IINST", trames, intervalle));
+		flux.push_back(synthetique("historique BASE", {}, "PAPP,IINST,BASE", trames, intervalle));
+		flux.push_back(synthetique("historique HC", {Option::HC}, "PAPP,IINST,HCHC,HCHP", trames, intervalle));
+		flux.push_back(synthetique("historique Tempo", {Option::TEMPO}, "PAPP,BBRHCJB,BBRHPJB", trames, intervalle));
+		flux.push_back(synthetique("standard HC", {Option::HC, 1, true}, "SINSTS,IRMS1,EAST", trames, intervalle));
+		flux.push_back(synthetique("standard tri", {Option::BASE, 3, true, 30, 4500}, "SINSTS,IRMS1,IRMS2,IRMS3",
+			trames, intervalle));
+	}
+
+	printf("zone de %zu octets, update() toutes les %u ms\n", taille, intervalle);
+	printf("%-18s %-26s %7s %7s %7s %7s %6s %7s %6s %6s\n", "flux", "étiquettes", "échant.", "o/éch.", "heures",
+		"csv o", "Mo/s", "json o", "Mo/s", "écarts");
+	bool ok = true;
+	for (const Flux &f : flux)
+		ok &= verifier(f, taille);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+// Lecture de la mémoire partagée publiée par ticd -s : dernière trame de chaque compteur.
+//
+//   g++ -O2 -std=c++17 -I components/tic -I tools tools/tic_shm.cpp -o tic_shm -lrt
+//   ./tic_shm /tic            # une ligne JSON par compteur
+//   ./tic_shm -w /tic         # puis chaque nouvelle trame, sans solliciter le démon
+//   ./tic_shm -b /tic         # lectures par seconde et relectures (mesure)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_json.h"
+#include "tic_shm.h"
+
+static void afficher(const EmplacementTic &e, const TrameDatee &t)
+{
+	char ligne[2048];
+	int n = trame_json(ligne, sizeof(ligne), e.port, t.instant_ms, t.trame);
+	fwrite(ligne, 1, n, stdout);
+}
+
+int main(int argc, char **argv)
+{
+	bool suivre = false, mesurer = false;
+	int c;
+	while ((c = getopt(argc, argv, "wb")) != -1)
+	{
+		switch (c)
+		{
+			case 'w': suivre = true; break;
+			case 'b': mesurer = true; break;
+			default: return 2;
+		}
+	}
+	if (optind != argc - 1)
+	{
+		fprintf(stderr, "usage : %s [-w | -b] REGION\n", argv[0]);
+		return 2;
+	}
+	const RegionTic *r = ouvrir_region(argv[optind]);
+	if (r == nullptr)
+	{
+		fprintf(stderr, "%s : région absente ou incompatible\n", argv[optind]);
+		return 1;
+	}
+
+	TrameDatee t;
+	if (mesurer)
+	{
+		// lecture en boucle de tous les compteurs pendant une seconde
+		uint64_t lectures = 0;
+		auto debut = std::chrono::steady_clock::now();
+		while (std::chrono::steady_clock::now() - debut < std::chrono::seconds(1))
+			for (uint32_t i = 0; i < r->nb_compteurs; i++, lectures++)
+				r->compteurs[i].instantane.lire(t);
+		printf("%u compteurs, %llu lectures/s (%zu octets par instantané)\n", r->nb_compteurs,
+			(unsigned long long) lectures, sizeof(TrameDatee));
+		return 0;
+	}
+
+	std::vector<uint32_t> vues(r->nb_compteurs, 0);
+	do
+	{
+		for (uint32_t i = 0; i < r->nb_compteurs; i++)
+		{
+			const EmplacementTic &e = r->compteurs[i];
+			if (e.instantane.generation() == vues[i])
+				continue;
+			vues[i] = e.instantane.lire(t);
+			afficher(e, t);
+		}
+		fflush(stdout);
+		if (suivre)
+			usleep(50000);
+	} while (suivre);
+	return 0;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+// Région de mémoire partagée publiée par ticd (-s NOM) : la dernière trame complète de chaque
+// compteur, lisible par n'importe quel processus local (exporteur, journal, tableau de bord)
+// sans appel au démon. Chaque emplacement est un teleinfo::Instantane : ticd ne bloque jamais
+// sur un lecteur lent et un lecteur obtient toujours une trame entière.
+//
+// La disposition est fixe (pas de pointeur) et versionnée ; un lecteur vérifie magie, version
+// et taille des emplacements avant de lire.
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tic_parser.h"
+#include "tic_snapshot.h"
+
+// un atomique avec verrou garderait son verrou dans le processus qui l'a pris
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Instantane en mémoire partagée");
+
+struct TrameDatee {
+	uint64_t instant_ms = 0;	// réception de l'ETX (horloge temps réel)
+	uint32_t numero = 0;		// trames complètes reçues sur ce port
+	teleinfo::Trame trame;
+};
+
+struct EmplacementTic {
+	char port[64];
+	teleinfo::Instantane<TrameDatee> instantane;
+};
+
+struct RegionTic {
+	static constexpr uint32_t MAGIE = 0x54494331;	// "TIC1"
+	static constexpr uint32_t VERSION = 1;
+
+	uint32_t magie;
+	uint32_t version;
+	uint32_t nb_compteurs;
+	uint32_t taille_emplacement;
+	EmplacementTic compteurs[1];	// nb_compteurs emplacements
+
+	static size_t taille(uint32_t nb) { return sizeof(RegionTic) + (nb - 1) * sizeof(EmplacementTic); }
+};
+
+// création par le démon : la région existante de même nom est remplacée
+inline RegionTic *creer_region(const char *nom, uint32_t nb)
+{
+	shm_unlink(nom);
+	int fd = shm_open(nom, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0)
+		return nullptr;
+	size_t taille = RegionTic::taille(nb);
+	void *p = ftruncate(fd, taille) == 0 ? mmap(nullptr, taille, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (p == MAP_FAILED)
+		return nullptr;
+	RegionTic *r = static_cast<RegionTic *>(p);
+	r->nb_compteurs = nb;
+	r->taille_emplacement = sizeof(EmplacementTic);
+	for (uint32_t i = 0; i < nb; i++)
+		new (&r->compteurs[i]) EmplacementTic();
+	r->version = RegionTic::VERSION;
+	std::atomic_thread_fence(std::memory_order_release);
+	r->magie = RegionTic::MAGIE;
+	return r;
+}
+
+// ouverture en lecture seule par un consommateur ; nullptr si absente ou incompatible
+inline const RegionTic *ouvrir_region(const char *nom)
+{
+	int fd = shm_open(nom, O_RDONLY, 0);
+	if (fd < 0)
+		return nullptr;
+	struct stat st;
+	void *p = fstat(fd, &st) == 0 && st.st_size >= (off_t) sizeof(RegionTic)
+		? mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (p == MAP_FAILED)
+		return nullptr;
+	const RegionTic *r = static_cast<const RegionTic *>(p);
+	if (r->magie != RegionTic::MAGIE || r->version != RegionTic::VERSION
+		|| r->taille_emplacement != sizeof(EmplacementTic) || (size_t) st.st_size < RegionTic::taille(r->nb_compteurs))
+	{
+		munmap(p, st.st_size);
+		return nullptr;
+	}
+	return r;
+}
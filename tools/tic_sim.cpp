@@ -0,0 +1,230 @@
+// Simulation à horloge virtuelle de la réception TIC : arrivée des octets, tampon de l'UART,
+// boucle ESPhome, update() et blocages de la boucle.
+//
+//   g++ -O2 -std=c++17 -I components/tic -I tools tools/tic_sim.cpp -o tic_sim
+//   ./tic_sim -i 1000 -d 3600                # update() chaque seconde, une heure simulée
+//   ./tic_sim -s loop -k 800 -K 5            # lecture à chaque tour de boucle, blocages de 800 ms
+//
+// Les octets arrivent au bit près (10 bits par caractère en 7E1) dans un tampon de réception
+// de taille finie ; au-delà, ils sont perdus comme sur l'ESP. La boucle tourne toutes les L ms,
+// update() est appelé au premier tour suivant son échéance puis replanifié update_interval plus
+// tard, et un tour peut se bloquer (Wi-Fi, API, flash). Le tampon est vidé comme dans
+// TicMeter::update() et décodé par teleinfo::Lecteur, la chaîne du composant. Le tout est
+// déterministe (graine).
+//
+// Résultats :
+//  - latence : délai entre la réception du CR d'un groupe et son décodage ;
+//  - fraîcheur par étiquette : âge de la valeur publiée (instant de réception sur la liaison),
+//    échantillonné toutes les 100 ms ;
+//  - octets perdus par débordement et groupes rejetés.
+//
+// options :
+//   -m historic|standard  -p 1|3  -t base|hc|ejp|tempo   compteur simulé
+//   -s update|loop        lecture dans update() (défaut) ou à chaque tour de boucle
+//   -i MS                 update_interval (1000)
+//   -L MS                 durée d'un tour de boucle (16)
+//   -b OCTETS             taille du tampon de réception (256, rx_buffer_size d'ESPhome)
+//   -k MS -K POUR_MILLE   durée et probabilité par tour d'un blocage de la boucle (0)
+//   -d SECONDES           durée simulée (600)
+//   -g GRAINE
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_parser.h"
+#include "tic_synth.h"
+
+using namespace teleinfo;
+
+struct Options {
+	synth::Profil profil;
+	bool boucle = false;
+	uint32_t intervalle = 1000;
+	uint32_t tour = 16;
+	size_t tampon = 256;
+	uint32_t blocage = 0;
+	uint32_t blocages = 0;	// pour mille
+	double duree = 600;
+};
+
+// octet reçu et son instant d'arrivée en µs
+struct Octet {
+	uint8_t valeur;
+	uint64_t instant;
+};
+
+struct Distribution {
+	std::vector<uint32_t> valeurs;
+
+	void ajouter(uint64_t v) { valeurs.push_back(static_cast<uint32_t>(v)); }
+
+	// en ms
+	double centile(double c)
+	{
+		if (valeurs.empty())
+			return 0;
+		size_t i = std::min(valeurs.size() - 1, static_cast<size_t>(c / 100 * valeurs.size()));
+		std::nth_element(valeurs.begin(), valeurs.begin() + i, valeurs.end());
+		return valeurs[i] / 1000.0;
+	}
+
+	void afficher(const char *nom)
+	{
+		printf("%-10s %8zu %9.0f %9.0f %9.0f %9.0f\n", nom, valeurs.size(), centile(50), centile(90), centile(99),
+			centile(100));
+	}
+};
+
+static uint32_t alea = 0x9E3779B9;
+
+static uint32_t hasard()
+{
+	alea ^= alea << 13;
+	alea ^= alea >> 17;
+	alea ^= alea << 5;
+	return alea;
+}
+
+template<typename MODE>
+static int simuler(const Options &opt)
+{
+	// flux de la liaison sur toute la durée
+	synth::Generateur gen(opt.profil);
+	std::vector<Octet> liaison;
+	const double octet = 10.0 / gen.bauds();
+	while (gen.secondes() < opt.duree)
+	{
+		double debut = gen.secondes();
+		std::string t = gen.trame();
+		for (size_t k = 0; k < t.size(); k++)
+			liaison.push_back({static_cast<uint8_t>(t[k]), static_cast<uint64_t>((debut + (k + 1) * octet) * 1e6)});
+	}
+
+	Trame trame;
+	Lecteur<MODE> lecteur(trame);
+	std::deque<Octet> rx;
+	size_t suivant = 0;
+	uint64_t perdus = 0;
+	size_t occupation_max = 0;
+
+	Distribution latence;
+	Distribution fraicheur[NB_ETIQUETTES];
+	uint64_t recu[NB_ETIQUETTES] = {};	// instant de réception de la valeur publiée, 0 = aucune
+	uint64_t instant_cr = 0;
+
+	const uint64_t fin = static_cast<uint64_t>(opt.duree * 1e6);
+	uint64_t maintenant = 0;
+	uint64_t echeance = opt.intervalle * 1000ULL;
+	uint64_t echantillon = 0;
+
+	while (maintenant < fin)
+	{
+		// arrivées depuis le tour précédent
+		for (; suivant < liaison.size() && liaison[suivant].instant <= maintenant; suivant++)
+		{
+			if (rx.size() < opt.tampon)
+				rx.push_back(liaison[suivant]);
+			else
+				perdus++;
+		}
+		occupation_max = std::max(occupation_max, rx.size());
+
+		// fraîcheur échantillonnée toutes les 100 ms
+		for (; echantillon <= maintenant; echantillon += 100000)
+			for (uint8_t i = 0; i < NB_ETIQUETTES; i++)
+				if (recu[i] != 0)
+					fraicheur[i].ajouter(echantillon - recu[i]);
+
+		if (opt.boucle || maintenant >= echeance)
+		{
+			// comme TicMeter::update() : paquets de 64 octets jusqu'à vider le tampon
+			uint8_t buff[64];
+			while (!rx.empty())
+			{
+				size_t len = std::min(rx.size(), sizeof(buff));
+				for (size_t k = 0; k < len; k++)
+				{
+					buff[k] = rx.front().valeur;
+					// un seul appel à pousser() par octet pour dater le CR qui termine chaque groupe
+					if (buff[k] == CR)
+						instant_cr = rx.front().instant;
+					rx.pop_front();
+					lecteur.pousser(&buff[k], 1, [&](Evenement e, const Groupe &g, bool) {
+						if (e != Evenement::GROUPE)
+							return;
+						latence.ajouter(maintenant - instant_cr);
+						recu[static_cast<uint8_t>(g.etiquette)] = instant_cr;
+					});
+				}
+			}
+			if (!opt.boucle)
+				echeance = maintenant + opt.intervalle * 1000ULL;
+		}
+
+		maintenant += opt.tour * 1000ULL;
+		if (opt.blocages != 0 && hasard() % 1000 < opt.blocages)
+			maintenant += opt.blocage * 1000ULL;
+	}
+
+	const Statistiques &s = lecteur.stats;
+	printf("%.0f s simulées : %zu octets émis, %llu perdus (tampon plein, %zu octets au plus), "
+		"%u trames, %u checksum, %u format, %u débordements\n\n", opt.duree, liaison.size(),
+		(unsigned long long) perdus, occupation_max, s.trames, s.erreurs_checksum, s.erreurs_format, s.debordements);
+	printf("%-10s %8s %9s %9s %9s %9s\n", "ms", "n", "p50", "p90", "p99", "max");
+	latence.afficher("latence");
+	printf("fraîcheur :\n");
+	for (uint8_t i = 0; i < NB_ETIQUETTES; i++)
+		if (!fraicheur[i].valeurs.empty())
+			fraicheur[i].afficher(NOMS[i]);
+	return 0;
+}
+
+static synth::Option option(const char *nom)
+{
+	if (strcmp(nom, "hc") == 0)
+		return synth::Option::HC;
+	if (strcmp(nom, "ejp") == 0)
+		return synth::Option::EJP;
+	if (strcmp(nom, "tempo") == 0)
+		return synth::Option::TEMPO;
+	return synth::Option::BASE;
+}
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	int c;
+	while ((c = getopt(argc, argv, "m:p:t:s:i:L:b:k:K:d:g:")) != -1)
+	{
+		switch (c)
+		{
+			case 'm': opt.profil.standard = strcmp(optarg, "standard") == 0; break;
+			case 'p': opt.profil.phases = atoi(optarg); break;
+			case 't': opt.profil.option = option(optarg); break;
+			case 's': opt.boucle = strcmp(optarg, "loop") == 0; break;
+			case 'i': opt.intervalle = atoi(optarg); break;
+			case 'L': opt.tour = atoi(optarg); break;
+			case 'b': opt.tampon = atoi(optarg); break;
+			case 'k': opt.blocage = atoi(optarg); break;
+			case 'K': opt.blocages = atoi(optarg); break;
+			case 'd': opt.duree = atof(optarg); break;
+			case 'g': opt.profil.graine = atoi(optarg); alea ^= opt.profil.graine * 2654435761u; break;
+			default:
+				fprintf(stderr, "usage : %s [-m historic|standard] [-p 1|3] [-t option] [-s update|loop] [-i ms] "
+					"[-L ms] [-b octets] [-k ms -K pour_mille] [-d s] [-g graine]\n", argv[0]);
+				return 2;
+		}
+	}
+	if ((opt.profil.phases != 1 && opt.profil.phases != 3) || opt.tour == 0 || opt.tampon == 0)
+		return 2;
+
+	if (opt.profil.standard)
+		return opt.profil.phases == 3 ? simuler<Standard<3>>(opt) : simuler<Standard<1>>(opt);
+	return opt.profil.phases == 3 ? simuler<Historique<3>>(opt) : simuler<Historique<1>>(opt);
+}
@@ -0,0 +1,328 @@
+#pragma once
+
+// Générateur de trames TIC synthétiques pour les outils PC (tic_bench, tic_gen...).
+//
+// Les trames suivent la spécification Enedis (Enedis-NOI-CPT_02E pour le mode historique,
+// Enedis-NOI-CPT_54E pour le mode standard) : ordre et format des groupes, checksum, horodates,
+// étiquettes hors de la table du décodeur (VTIC, DATE, SMAXSN...) comprises. Les valeurs suivent
+// une courbe de charge journalière pseudo-aléatoire mais reproductible (graine).
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace synth {
+
+enum class Option : uint8_t { BASE, HC, EJP, TEMPO };
+
+struct Profil {
+	Option option = Option::BASE;
+	uint8_t phases = 1;
+	bool standard = false;
+	uint16_t isousc = 30;		// A, soit PREF = 6 kVA en mode standard
+	uint32_t puissance = 1500;	// puissance apparente moyenne en VA
+	uint32_t graine = 1;
+	uint16_t depassements = 0;	// probabilité de début d'un dépassement de la puissance souscrite, pour 10000 trames
+};
+
+// groupe complet (sans LF ni CR) avec son checksum ; horodate optionnelle (mode standard)
+inline std::string groupe(const char *etiquette, const std::string &valeur, bool standard, const char *horodate = nullptr)
+{
+	const char sep = standard ? '\t' : ' ';
+	std::string g = std::string(etiquette) + sep;
+	if (horodate != nullptr)
+		g += std::string(horodate) + sep;
+	g += valeur;
+	if (standard)
+		g += sep;
+	uint32_t somme = 0;
+	for (char c : g)
+		somme += static_cast<uint8_t>(c);
+	if (!standard)
+		g += sep;
+	g += static_cast<char>((somme & 0x3F) + 0x20);
+	return g;
+}
+
+class Generateur {
+ public:
+	explicit Generateur(const Profil &profil) : profil_(profil), alea_(profil.graine * 2654435761u + 1) {}
+
+	const Profil &profil() const { return profil_; }
+	uint32_t bauds() const { return profil_.standard ? 9600 : 1200; }
+	// horloge simulée en secondes, avancée de la durée d'émission de chaque trame
+	double secondes() const { return secondes_; }
+	uint32_t puissance() const { return papp_; }
+	bool depassement() const { return depassement_ != 0; }
+
+	// trame suivante, STX et ETX compris
+	std::string trame()
+	{
+		avancer();
+		groupes_.clear();
+		if (profil_.standard)
+			trame_standard();
+		else
+			trame_historique();
+		std::string t(1, '\x02');
+		for (const std::string &g : groupes_)
+			t += '\n' + g + '\r';
+		t += '\x03';
+		// 7E1 : 10 bits par caractère, plus l'intervalle entre trames (16,7 à 33,4 ms)
+		secondes_ += t.size() * 10.0 / bauds() + 0.025;
+		return t;
+	}
+
+ protected:
+	uint32_t hasard()
+	{
+		alea_ ^= alea_ << 13;
+		alea_ ^= alea_ >> 17;
+		alea_ ^= alea_ << 5;
+		return alea_;
+	}
+
+	uint32_t jour() const { return static_cast<uint32_t>(secondes_ / 86400); }
+	double heure() const { return std::fmod(secondes_ / 3600, 24); }
+
+	// période tarifaire en cours : indice du registre d'énergie et libellés
+	uint8_t periode() const
+	{
+		double h = heure();
+		bool creuse = h >= 22 || h < 6;
+		switch (profil_.option)
+		{
+			case Option::BASE:
+				return 0;
+			case Option::HC:
+				return creuse ? 0 : 1;
+			case Option::EJP:
+				return jour_ejp(jour()) && h >= 7 ? 1 : 0;
+			case Option::TEMPO:
+				return couleur(jour()) * 2 + (creuse ? 0 : 1);
+		}
+		return 0;
+	}
+
+	// 22 jours EJP et 22 jours rouges / 43 blancs Tempo répartis sur l'année
+	static bool jour_ejp(uint32_t j) { return j % 15 == 3; }
+	static uint8_t couleur(uint32_t j) { return j % 30 < 22 ? 0 : (j % 30 < 28 ? 1 : 2); }
+
+	void avancer()
+	{
+		// courbe journalière (creux la nuit, pointe le soir) et bruit de +/-20 %
+		double h = heure();
+		double forme = 0.6 + 0.4 * std::sin((h - 11) * M_PI / 12) + (h >= 18 && h < 21 ? 0.5 : 0);
+		double p = profil_.puissance * forme * (0.8 + (hasard() % 400) / 1000.0);
+		uint32_t pmax = profil_.isousc * 200 * (profil_.phases == 3 ? 3 : 1);
+		papp_ = p > pmax ? pmax : static_cast<uint32_t>(p);
+		// dépassement de 5 à 20 trames au-delà de l'intensité souscrite (ADPS, ADIR)
+		if (depassement_ != 0)
+			depassement_--;
+		else if (profil_.depassements != 0 && hasard() % 10000 < profil_.depassements)
+			depassement_ = 5 + hasard() % 16;
+		if (depassement_ != 0)
+			papp_ = profil_.isousc * 230 * (profil_.phases == 3 ? 3 : 1) * (110 + hasard() % 20) / 100;
+		index_[periode()] += papp_ * (secondes_ - derniere_) / 3600;
+		derniere_ = secondes_;
+	}
+
+	void ajouter(const char *etiquette, const std::string &valeur, const char *horodate = nullptr)
+	{
+		groupes_.push_back(groupe(etiquette, valeur, profil_.standard, horodate));
+	}
+
+	static std::string nombre(uint32_t v, int chiffres)
+	{
+		char s[16];
+		snprintf(s, sizeof(s), "%0*u", chiffres, v);
+		return s;
+	}
+
+	uint32_t wh(int i) const { return 10000000 + static_cast<uint32_t>(index_[i]); }
+
+	void trame_historique()
+	{
+		static const char *const OPTARIF[] = {"BASE", "HC..", "EJP.", "BBR("};
+		static const char *const PTEC_HC[] = {"HC..", "HP.."};
+		static const char *const PTEC_EJP[] = {"HN..", "PM.."};
+		static const char *const PTEC_TEMPO[] = {"HCJB", "HPJB", "HCJW", "HPJW", "HCJR", "HPJR"};
+		static const char *const INDEX_TEMPO[] = {"BBRHCJB", "BBRHPJB", "BBRHCJW", "BBRHPJW", "BBRHCJR", "BBRHPJR"};
+		static const char *const DEMAIN[] = {"BLEU", "BLAN", "ROUG"};
+		const uint8_t per = periode();
+		const uint32_t iinst = profil_.phases == 1 ? papp_ / 230 : papp_ / 3 / 230;
+
+		// triphasé : trames courtes pendant un dépassement
+		if (profil_.phases == 3 && depassement_ != 0)
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				char e[] = "ADIR1";
+				e[4] = '1' + i;
+				ajouter(e, nombre(iinst + i, 3));
+			}
+			ajouter("ADCO", "021861348497");
+			for (int i = 0; i < 3; i++)
+			{
+				char e[] = "IINST1";
+				e[5] = '1' + i;
+				ajouter(e, nombre(iinst + i, 3));
+			}
+			return;
+		}
+
+		ajouter("ADCO", "021861348497");
+		ajouter("OPTARIF", OPTARIF[static_cast<uint8_t>(profil_.option)]);
+		ajouter("ISOUSC", nombre(profil_.isousc, 2));
+		switch (profil_.option)
+		{
+			case Option::BASE:
+				ajouter("BASE", nombre(wh(0), 9));
+				ajouter("PTEC", "TH..");
+				break;
+			case Option::HC:
+				ajouter("HCHC", nombre(wh(0), 9));
+				ajouter("HCHP", nombre(wh(1), 9));
+				ajouter("PTEC", PTEC_HC[per]);
+				break;
+			case Option::EJP:
+				ajouter("EJPHN", nombre(wh(0), 9));
+				ajouter("EJPHPM", nombre(wh(1), 9));
+				// préavis d'une demi-heure avant le début de la période mobile
+				if (jour_ejp(jour()) && heure() >= 6.5 && heure() < 7)
+					ajouter("PEJP", "30");
+				ajouter("PTEC", PTEC_EJP[per]);
+				break;
+			case Option::TEMPO:
+				for (int i = 0; i < 6; i++)
+					ajouter(INDEX_TEMPO[i], nombre(wh(i), 9));
+				ajouter("PTEC", PTEC_TEMPO[per]);
+				ajouter("DEMAIN", heure() >= 20 ? DEMAIN[couleur(jour() + 1)] : "----");
+				break;
+		}
+		if (profil_.phases == 1)
+		{
+			ajouter("IINST", nombre(iinst, 3));
+			if (iinst > profil_.isousc)
+				ajouter("ADPS", nombre(iinst, 3));
+			ajouter("IMAX", "090");
+		}
+		else
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				char e[] = "IINST1";
+				e[5] = '1' + i;
+				ajouter(e, nombre(iinst + i, 3));
+			}
+			ajouter("IMAX1", "060");
+			ajouter("IMAX2", "060");
+			ajouter("IMAX3", "060");
+			ajouter("PMAX", nombre(profil_.isousc * 200 * 3, 5));
+		}
+		ajouter("PAPP", nombre(papp_, 5));
+		ajouter("HHPHC", "A");
+		ajouter("MOTDETAT", "000000");
+		if (profil_.phases == 3)
+			ajouter("PPOT", "00");
+	}
+
+	void trame_standard()
+	{
+		static const char *const NGTF[] = {"      BASE      ", " HEURE  CREUSE  ", "      EJP       ", "     TEMPO      "};
+		static const char *const LTARF_HC[] = {" HEURE  CREUSE  ", " HEURE  PLEINE  "};
+		static const char *const LTARF_EJP[] = {"HEURE  NORMALE  ", "  POINTE MOBILE "};
+		static const char *const LTARF_TEMPO[] = {"    HC  BLEU    ", "    HP  BLEU    ", "   HC  BLANC    ",
+			"   HP  BLANC    ", "    HC  ROUGE   ", "    HP  ROUGE   "};
+		static const uint8_t REGISTRES[] = {1, 2, 2, 6};
+		const uint8_t per = periode();
+		const uint8_t registres = REGISTRES[static_cast<uint8_t>(profil_.option)];
+		const char *ltarf = profil_.option == Option::HC ? LTARF_HC[per]
+			: profil_.option == Option::EJP ? LTARF_EJP[per]
+			: profil_.option == Option::TEMPO ? LTARF_TEMPO[per] : NGTF[0];
+
+		char date[14];
+		uint32_t s = static_cast<uint32_t>(secondes_) % 86400;
+		snprintf(date, sizeof(date), "H26%02u%02u%02u%02u%02u", 1 + jour() / 28 % 12, 1 + jour() % 28,
+			s / 3600, s / 60 % 60, s % 60);
+
+		ajouter("ADSC", "041876097364");
+		ajouter("VTIC", "02");
+		ajouter("DATE", "", date);
+		ajouter("NGTF", NGTF[static_cast<uint8_t>(profil_.option)]);
+		ajouter("LTARF", ltarf);
+		uint32_t total = 0;
+		for (int i = 0; i < registres; i++)
+			total += wh(i) - 10000000;
+		ajouter("EAST", nombre(10000000 * registres + total, 9));
+		for (int i = 0; i < 10; i++)
+		{
+			char e[] = "EASF01";
+			e[4] = '0' + (i + 1) / 10;
+			e[5] = '0' + (i + 1) % 10;
+			ajouter(e, nombre(i < registres ? wh(i) : 0, 9));
+		}
+		for (int i = 0; i < 4; i++)
+		{
+			char e[] = "EASD01";
+			e[5] = '1' + i;
+			ajouter(e, nombre(i == 0 ? 10000000 * registres + total : 0, 9));
+		}
+		const uint8_t phases = profil_.phases;
+		for (int i = 0; i < phases; i++)
+		{
+			char e[] = "IRMS1";
+			e[4] = '1' + i;
+			ajouter(e, nombre(papp_ / phases / 230, 3));
+		}
+		for (int i = 0; i < phases; i++)
+		{
+			char e[] = "URMS1";
+			e[4] = '1' + i;
+			ajouter(e, nombre(228 + hasard() % 5, 3));
+		}
+		ajouter("PREF", nombre(profil_.isousc / 5 * phases, 2));
+		ajouter("PCOUP", nombre(profil_.isousc / 5 * phases, 2));
+		ajouter("SINSTS", nombre(papp_, 5));
+		if (phases == 3)
+			for (int i = 0; i < 3; i++)
+			{
+				char e[] = "SINSTS1";
+				e[6] = '1' + i;
+				ajouter(e, nombre(papp_ / 3, 5));
+			}
+		ajouter("SMAXSN", nombre(papp_ + 1200, 5), date);
+		ajouter("SMAXSN-1", nombre(papp_ + 900, 5), date);
+		ajouter("CCASN", nombre(papp_, 5), date);
+		ajouter("CCASN-1", nombre(papp_, 5), date);
+		ajouter("UMOY1", "230", date);
+		// index en cours (bits 10 à 13), couleurs Tempo du jour et du lendemain annoncée à 20 h
+		// (bits 24-25 et 26-27 : 1 bleu, 2 blanc, 3 rouge)
+		uint32_t stge = 0x003A0001 | uint32_t(per) << 10;
+		if (profil_.option == Option::TEMPO)
+			stge |= uint32_t(couleur(jour()) + 1) << 24 | (heure() >= 20 ? uint32_t(couleur(jour() + 1) + 1) << 26 : 0);
+		char hex[9];
+		snprintf(hex, sizeof(hex), "%08X", static_cast<unsigned>(stge));
+		ajouter("STGE", hex);
+		ajouter("MSG1", "PAS DE          MESSAGE         ");
+		ajouter("PRM", "09876543210987");
+		ajouter("RELAIS", "000");
+		ajouter("NTARF", nombre(per + 1, 2));
+		ajouter("NJOURF", "00");
+		ajouter("NJOURF+1", "00");
+		ajouter("PJOURF+1", "00008001 NONUTILE NONUTILE NONUTILE NONUTILE NONUTILE NONUTILE NONUTILE NONUTILE NONUTILE NONUTILE");
+	}
+
+	Profil profil_;
+	uint32_t alea_;
+	double secondes_ = 0;
+	double derniere_ = 0;
+	double index_[6] = {};
+	uint32_t papp_ = 0;
+	uint8_t depassement_ = 0;	// trames restantes du dépassement en cours
+	std::vector<std::string> groupes_;
+};
+
+}  // namespace synth
@@ -0,0 +1,298 @@
+// Vérification de la prévision de dépassement (components/tic/tic_tendance.h, tic_overload), sur PC.
+//
+//   g++ -O2 -std=c++17 -I components/tic tools/tic_tendance.cpp -o tic_tendance
+//   ./tic_tendance               # fenêtre de 10 trames, 5 s d'avance, 30 A souscrits
+//   ./tic_tendance -a 3000 -l 45 -g 7
+//
+// Les trames arrivent au rythme de celles de tools/tic_synth.h (historique et standard, mono et
+// triphasé) et la décision est celle de tic_overload : signalement quand la prévision atteint la
+// limite, retombée quand elle repasse sous 95 %. Vérifié :
+//  - Droite : pente et prévision égales à celles des moindres carrés calculés en double, à l'arrondi
+//    Q8 près, sur des valeurs au hasard qui glissent dans la fenêtre (3, 10 et 64 trames) ;
+//  - horizon : une rampe exacte, trames à intervalle fixe, est prolongée jusqu'à sa valeur horizon
+//    plus tard ;
+//  - rampes de 0,5 à 5 A par trame depuis 10 A : dépassement signalé à une trame antérieure à celle
+//    où IINST dépasse l'intensité souscrite (ADPS), y compris quand millis() repasse par zéro ;
+//    intensité au signalement, avance, et intensité à la retombée quand la charge redescend au
+//    même rythme ;
+//  - charge stable bruitée (20 A, +/-3 A d'une trame à l'autre) pendant une journée : aucun
+//    signalement ;
+//  - trames espacées de plus de ECART_MAX : la fenêtre repart de zéro et il n'y a plus de
+//    prévision avant ECHANTILLONS_MIN trames ; à ECART_MAX tout juste, elle est gardée.
+// Code de sortie 1 au premier écart.
+//
+// options :
+//   -a MS       avance de la prévision (5000, horizon de tic_overload)
+//   -l A        intensité souscrite (30)
+//   -b A        bruit de la charge stable (3)
+//   -g GRAINE
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <unistd.h>
+
+#include "tic_synth.h"
+#include "tic_tendance.h"
+
+using namespace teleinfo;
+
+static constexpr uint8_t FENETRE = 10;	// window par défaut de tic_overload
+
+// décision de TicOverloadPredictor::trame, sur l'intensité
+struct Surveillance {
+	tendance::Predicteur<FENETRE> predicteur;
+	uint32_t horizon;
+	uint32_t limite;	// A
+	bool imminent = false;
+
+	// true au signalement
+	bool trame(uint32_t instant_ms, uint32_t intensite)
+	{
+		predicteur.ajouter(instant_ms, intensite, intensite * 230);
+		int64_t courant = 0, puissance = 0;
+		bool pret = predicteur.prevoir(horizon, courant, puissance);
+		int64_t lc = int64_t(limite) * 256;
+		if (!imminent && pret && courant >= lc)
+		{
+			imminent = true;
+			return true;
+		}
+		if (imminent && (!pret || courant * 100 < lc * 95))
+			imminent = false;
+		return false;
+	}
+};
+
+// instants des trames successives d'un profil de tic_synth.h, en ms depuis decalage
+class Horloge {
+ public:
+	Horloge(const synth::Profil &profil, uint32_t decalage) : gen_(profil), decalage_(decalage) {}
+
+	uint32_t suivante()
+	{
+		uint32_t instant = decalage_ + static_cast<uint32_t>(gen_.secondes() * 1000);
+		gen_.trame();
+		return instant;
+	}
+
+ protected:
+	synth::Generateur gen_;
+	uint32_t decalage_;
+};
+
+struct Cas {
+	const char *nom;
+	synth::Profil profil;
+};
+
+template<uint8_t N>
+static size_t verifier_droite(std::mt19937 &alea, double &rapport_max)
+{
+	tendance::Droite<N> droite;
+	std::deque<double> valeurs;
+	size_t ecarts = 0;
+	for (uint32_t i = 0; i < 100000; i++)
+	{
+		// intensités, puis puissances apparentes
+		int32_t y = i < 50000 ? alea() % 91 : alea() % 40001;
+		droite.ajouter(y);
+		valeurs.push_back(y);
+		if (valeurs.size() > N)
+			valeurs.pop_front();
+		size_t n = valeurs.size();
+		if (n < tendance::ECHANTILLONS_MIN)
+			continue;
+		double sx = 0, sy = 0, sxx = 0, sxy = 0;
+		for (size_t x = 0; x < n; x++)
+		{
+			sx += x;
+			sy += valeurs[x];
+			sxx += double(x) * x;
+			sxy += x * valeurs[x];
+		}
+		double b = (n * sxy - sx * sy) / (n * sxx - sx * sx), a = (sy - b * sx) / n;
+		int64_t k_q8 = alea() % 2049;	// jusqu'à 8 rangs
+		double k = k_q8 / 256.0;
+		double erreur_pente = std::fabs(droite.pente_q8() / 256.0 - b);
+		double erreur = std::fabs(droite.prevoir_q8(k_q8) / 256.0 - (a + b * (n - 1 + k)));
+		// pente tronquée à 1/256 près, prolongée sur n - 1 + k rangs ; divisions entières
+		double tolerance = (n + k + 2) / 256.0;
+		rapport_max = std::max(rapport_max, erreur / tolerance);
+		if ((erreur_pente >= 1 / 256.0 || erreur > tolerance) && ecarts++ < 10)
+			printf("droite de %u : pente %.4f au lieu de %.4f, prévision à %.2f rangs %.4f au lieu de %.4f\n", N,
+				droite.pente_q8() / 256.0, b, k, droite.prevoir_q8(k_q8) / 256.0, a + b * (n - 1 + k));
+	}
+	return ecarts;
+}
+
+// rampe de dixiemes / 10 A par trame depuis 10 A jusqu'au-delà de la limite, puis retour à 10 A
+struct Rampe {
+	bool signale = false;
+	uint32_t signal_a = 0, retombee_a = 0;
+	double avance = 0;	// s entre le signalement et la trame ADPS
+};
+
+static Rampe rampe(const synth::Profil &profil, uint32_t horizon, uint32_t limite, uint32_t dixiemes, uint32_t decalage)
+{
+	Horloge horloge(profil, decalage);
+	Surveillance s{{}, horizon, limite};
+	Rampe r;
+	uint32_t signal = 0, montee = (limite + 5 - 10) * 10 / dixiemes;
+	for (uint32_t k = 0; k <= 2 * montee; k++)
+	{
+		uint32_t i = 10 + (k <= montee ? k : 2 * montee - k) * dixiemes / 10;
+		uint32_t instant = horloge.suivante();
+		bool etait = s.imminent;
+		if (s.trame(instant, i) && !r.signale)
+		{
+			r.signale = true;
+			r.signal_a = i;
+			signal = instant;
+		}
+		if (etait && !s.imminent && r.retombee_a == 0)
+			r.retombee_a = i;
+		if (i > limite && r.avance == 0)
+			r.avance = r.signale ? (instant - signal) / 1000.0 : -1;
+	}
+	return r;
+}
+
+// droite exacte, trames à intervalle fixe : la prévision est la valeur horizon plus tard
+static size_t verifier_horizon(uint32_t horizon)
+{
+	size_t ecarts = 0;
+	for (uint32_t periode = 500; periode <= 2000; periode += 37)
+		for (int32_t pente = -3; pente <= 3; pente++)
+		{
+			tendance::Predicteur<FENETRE> p;
+			for (uint32_t k = 0; k < 2 * FENETRE; k++)
+				p.ajouter(k * periode, 40 + pente * k, 9200 + 230 * pente * k);
+			int64_t i = 0, w = 0;
+			bool pret = p.prevoir(horizon, i, w);
+			double attendu = 40 + pente * (2 * FENETRE - 1 + double(horizon) / periode);
+			// horizon tronqué à 1/256 de rang
+			if ((!pret || std::fabs(i / 256.0 - attendu) > (std::abs(pente) + 1) / 256.0) && ecarts++ < 10)
+				printf("rampe de %d A toutes les %u ms : %.3f A prévus, attendu %.3f A\n", pente, periode, i / 256.0,
+					attendu);
+		}
+	return ecarts;
+}
+
+static size_t verifier_ecart(uint32_t horizon)
+{
+	size_t ecarts = 0;
+	auto attendre = [&](bool ok, const char *quoi) {
+		if (!ok && ecarts++ < 10)
+			printf("écart : %s\n", quoi);
+	};
+	tendance::Predicteur<FENETRE> p;
+	int64_t i = 0, w = 0;
+	uint32_t t = 1000;
+	for (uint8_t k = 0; k < 5; k++, t += 1000)
+		p.ajouter(t, 10 + k, 2300);
+	t += tendance::ECART_MAX - 1000;
+	p.ajouter(t, 15, 2300);
+	attendre(p.intensite().echantillons() == 6 && p.prevoir(horizon, i, w), "fenêtre perdue après ECART_MAX");
+	t += tendance::ECART_MAX + 1;
+	p.ajouter(t, 15, 2300);
+	attendre(p.intensite().echantillons() == 1 && !p.prevoir(horizon, i, w), "fenêtre gardée au-delà de ECART_MAX");
+	for (uint8_t k = 2; k <= tendance::ECHANTILLONS_MIN; k++)
+	{
+		p.ajouter(t += 1000, 15, 2300);
+		attendre(p.prevoir(horizon, i, w) == (k == tendance::ECHANTILLONS_MIN), "prévision avant ECHANTILLONS_MIN");
+	}
+	// la droite repart des seules trames après l'écart : 15 A stables
+	attendre(i == 15 * 256 && w == 2300 * 256, "anciennes trames dans la prévision");
+	return ecarts;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned horizon = 5000, limite = 30, graine = 1;
+	double bruit = 3;
+	int c;
+	while ((c = getopt(argc, argv, "a:l:b:g:")) != -1)
+	{
+		switch (c)
+		{
+			case 'a': horizon = atoi(optarg); break;
+			case 'l': limite = atoi(optarg); break;
+			case 'b': bruit = atof(optarg); break;
+			case 'g': graine = atoi(optarg); break;
+			default:
+				fprintf(stderr, "usage : %s [-a avance ms] [-l intensité souscrite] [-b bruit] [-g graine]\n", argv[0]);
+				return 2;
+		}
+	}
+	if (limite <= 20 + bruit)
+	{
+		fprintf(stderr, "intensité souscrite au-dessus de 20 A + bruit attendue\n");
+		return 2;
+	}
+
+	std::mt19937 alea(graine);
+	size_t ecarts = 0;
+
+	double rapport_max = 0;
+	ecarts += verifier_droite<3>(alea, rapport_max);
+	ecarts += verifier_droite<FENETRE>(alea, rapport_max);
+	ecarts += verifier_droite<64>(alea, rapport_max);
+	printf("droite : 3 x 100000 valeurs, erreur de prévision au plus %.0f %% de l'arrondi Q8 permis\n", rapport_max * 100);
+
+	const Cas CAS[] = {
+		{"historique mono", {synth::Option::BASE, 1, false, uint16_t(limite)}},
+		{"historique tri", {synth::Option::BASE, 3, false, uint16_t(limite)}},
+		{"standard mono", {synth::Option::BASE, 1, true, uint16_t(limite)}},
+		{"standard tri", {synth::Option::BASE, 3, true, uint16_t(limite)}},
+	};
+	printf("fenêtre de %u trames, %u ms d'avance, %u A souscrits\n", FENETRE, horizon, limite);
+	printf("%-16s %8s %8s %10s %8s %10s %12s %14s\n", "trames", "période", "A/trame", "signalé à", "avance",
+		"retombée à", "bruit : max", "signalements");
+	for (const Cas &cas : CAS)
+	{
+		Horloge mesure(cas.profil, 0);
+		uint32_t debut = mesure.suivante(), fin = debut;
+		for (uint32_t k = 0; k < 100; k++)
+			fin = mesure.suivante();
+		double periode = (fin - debut) / 100000.0;
+
+		// charge stable bruitée pendant une journée
+		Horloge horloge(cas.profil, 0);
+		Surveillance s{{}, horizon, limite};
+		size_t signalements = 0;
+		double prevision_max = 0;
+		for (uint32_t instant = 0; instant < 86400000;)
+		{
+			instant = horloge.suivante();
+			uint32_t i = static_cast<uint32_t>(std::lround(20 + bruit * (int32_t(alea() % 2001) - 1000) / 1000));
+			signalements += s.trame(instant, i);
+			int64_t courant, puissance;
+			if (s.predicteur.prevoir(horizon, courant, puissance))
+				prevision_max = std::max(prevision_max, courant / 256.0);
+		}
+		ecarts += signalements;
+
+		for (uint32_t dixiemes : {5, 10, 20, 50})
+		{
+			Rampe r = rampe(cas.profil, horizon, limite, dixiemes, 0);
+			// même rampe quand millis() repasse par zéro pendant la fenêtre
+			Rampe r2 = rampe(cas.profil, horizon, limite, dixiemes, UINT32_MAX - 5000);
+			bool ok = r.signale && r.avance > 0 && r2.signal_a == r.signal_a && r2.retombee_a == r.retombee_a;
+			ecarts += !ok;
+			printf("%-16s %7.2fs %8.1f %8u A %7.1fs %8u A", dixiemes == 5 ? cas.nom : "", periode, dixiemes / 10.0,
+				r.signal_a, r.avance, r.retombee_a);
+			if (dixiemes == 5)
+				printf(" %10.1f A %14zu", prevision_max, signalements);
+			printf("%s\n", ok ? "" : "  <- écart");
+		}
+	}
+
+	ecarts += verifier_horizon(horizon);
+	ecarts += verifier_ecart(horizon);
+	printf("%zu écarts\n", ecarts);
+	return ecarts == 0 ? 0 : 1;
+}
@@ -0,0 +1,497 @@
+// Démon Linux de lecture TIC : un ou plusieurs compteurs sur adaptateurs USB-série
+// (cf. « diagnostiquer votre montage » du README), décodés par le cœur du composant ESPhome.
+//
+//   g++ -O2 -std=c++17 -I components/tic -I tools tools/ticd.cpp -o ticd -pthread -lrt
+//   ./ticd /dev/ttyUSB0                              # historique monophasé, 1200 7E1
+//   ./ticd /dev/ttyUSB0,standard,3 /dev/ttyUSB1      # un port par compteur
+//
+// Chaque port s'écrit CHEMIN[,MODE[,PHASES[,BAUDS]]] avec MODE = historic (défaut), standard ou
+// auto (BAUDS à préciser si 9600). Les ports sont ouverts en 7E1 non bloquant (termios) et lus
+// par une boucle epoll ; un port absent ou débranché est rouvert chaque seconde. Chaque trame
+// complète est écrite sur la sortie standard en une ligne JSON :
+//   {"port":"/dev/ttyUSB0","t":1760000000123,"ADCO":"021861348497","BASE":12345678,"PAPP":1200}
+// Les compteurs de réception et d'erreurs de chaque port sont écrits sur stderr à la réception
+// de SIGUSR1 et à l'arrêt. Pour un essai sans compteur : tools/tic_gen -o pty -l /tmp/tic puis
+// ./ticd /tmp/tic.
+//
+// Des centaines de compteurs (immeuble, serveur série multiport) tiennent sur une boucle : chaque
+// port n'a que son assembleur incrémental et sa trame, sans thread ni tampon par groupe. Avec -j,
+// les ports sont répartis entre plusieurs boucles, une par thread ; tools/ticd_bench mesure le
+// coût CPU par port jusqu'à 500 pseudo-terminaux.
+//
+// Avec -s, la dernière trame de chaque compteur est aussi publiée en mémoire partagée
+// (tools/tic_shm.h) pour les processus locaux ; « tic_shm NOM » l'affiche.
+//
+// Avec -c, les trames de chaque port sont ajoutées à un historique en colonnes
+// (tools/tic_colonnes.h) DOSSIER/<chemin du port>.tcol, lu par tic_col. Les blocs de 1024 trames
+// (environ 25 min) sont écrits quand ils sont pleins et à l'arrêt : un arrêt brutal perd au plus
+// le bloc en cours, et le bloc à moitié écrit qu'il a pu laisser est retiré à la réouverture.
+//
+// options :
+//   -q       n'écrit pas les trames (mesures)
+//   -j N     nombre de boucles epoll (1 par défaut)
+//   -s NOM   région de mémoire partagée (par exemple /tic)
+//   -c DOSSIER  historique en colonnes
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_colonnes.h"
+#include "tic_parser.h"
+#include "tic_termios.h"
+#include "tic_json.h"
+#include "tic_shm.h"
+
+using namespace teleinfo;
+
+static bool silencieux = false;
+
+static uint64_t horloge_ms()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+// écrit tout le tampon : write() peut écrire moins que demandé ou être interrompu
+static bool ecrire_tout(int fd, const char *data, size_t n)
+{
+	while (n > 0)
+	{
+		ssize_t k = write(fd, data, n);
+		if (k < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		data += k;
+		n -= k;
+	}
+	return true;
+}
+
+// Un compteur : liaison, chaîne de lecture et dernière trame complète.
+class Port {
+ public:
+	Port(std::string chemin, uint32_t bauds, uint64_t etiquettes)
+		: chemin(std::move(chemin)), bauds(bauds), etiquettes(etiquettes) {}
+	virtual ~Port() = default;
+
+	const std::string chemin;
+	const uint32_t bauds;
+	const uint64_t etiquettes;	// celles du mode, colonnes de l'historique
+	int fd = -1;
+	Trame trame;
+	Trame complete;
+	uint64_t instant_ms = 0;	// réception de l'ETX de la trame complète
+	uint32_t numero = 0;		// trames complètes reçues
+	EmplacementTic *emplacement = nullptr;	// publication en mémoire partagée (-s)
+	std::unique_ptr<colonnes::Ecrivain> historique;	// historique en colonnes (-c)
+	int fd_historique = -1;
+	off_t fin_historique = 0;	// fin du dernier bloc complet du fichier
+
+	virtual void pousser(const uint8_t *data, size_t len) = 0;
+	virtual const Statistiques &stats() const = 0;
+
+	// écrit les blocs terminés de l'historique
+	void ecrire_historique()
+	{
+		std::string &blocs = historique->sortie;
+		if (blocs.empty())
+			return;
+		if (ecrire_tout(fd_historique, blocs.data(), blocs.size()))
+			fin_historique += blocs.size();
+		else
+		{
+			perror(chemin.c_str());
+			// bloc écrit en partie : retiré, pour que les blocs suivants restent lisibles
+			if (ftruncate(fd_historique, fin_historique) != 0)
+				perror(chemin.c_str());
+		}
+		blocs.clear();
+	}
+
+ protected:
+	void fin_trame()
+	{
+		complete = trame;
+		instant_ms = horloge_ms();
+		numero++;
+		if (emplacement != nullptr)
+		{
+			TrameDatee t;
+			t.instant_ms = instant_ms;
+			t.numero = numero;
+			t.trame = complete;
+			emplacement->instantane.publier(t);
+		}
+		if (historique)
+		{
+			historique->ajouter(instant_ms, complete);
+			ecrire_historique();
+		}
+		if (!silencieux)
+			ecrire_json();
+	}
+
+	void ecrire_json()
+	{
+		char ligne[2048];
+		int n = trame_json(ligne, sizeof(ligne), chemin.c_str(), instant_ms, complete);
+		// une ligne par appel : fwrite() verrouille stdout, les boucles ne se mélangent pas
+		fwrite(ligne, 1, n, stdout);
+	}
+};
+
+template<typename MODE>
+class PortMode : public Port {
+ public:
+	PortMode(std::string chemin, uint32_t bauds) : Port(std::move(chemin), bauds, MODE::ETIQUETTES) {}
+
+	void pousser(const uint8_t *data, size_t len) override
+	{
+		lecteur_.pousser(data, len, [this](Evenement e, const Groupe &, bool) {
+			if (e == Evenement::FIN_TRAME)
+				fin_trame();
+		});
+	}
+
+	const Statistiques &stats() const override { return lecteur_.stats; }
+
+ protected:
+	Lecteur<MODE> lecteur_{trame};
+};
+
+static std::unique_ptr<Port> creer_port(const std::string &spec)
+{
+	std::vector<std::string> champs;
+	size_t debut = 0, fin;
+	while ((fin = spec.find(',', debut)) != std::string::npos)
+	{
+		champs.push_back(spec.substr(debut, fin - debut));
+		debut = fin + 1;
+	}
+	champs.push_back(spec.substr(debut));
+
+	const std::string &chemin = champs[0];
+	std::string mode = champs.size() > 1 ? champs[1] : "historic";
+	int phases = champs.size() > 2 ? atoi(champs[2].c_str()) : 1;
+	uint32_t bauds = champs.size() > 3 ? atoi(champs[3].c_str()) : (mode == "standard" ? 9600 : 1200);
+	if (chemin.empty() || (phases != 1 && phases != 3) || (bauds != 1200 && bauds != 9600))
+		return nullptr;
+
+	bool tri = phases == 3;
+	if (mode == "historic")
+		return tri ? std::unique_ptr<Port>(new PortMode<Historique<3>>(chemin, bauds))
+			: std::unique_ptr<Port>(new PortMode<Historique<1>>(chemin, bauds));
+	if (mode == "standard")
+		return tri ? std::unique_ptr<Port>(new PortMode<Standard<3>>(chemin, bauds))
+			: std::unique_ptr<Port>(new PortMode<Standard<1>>(chemin, bauds));
+	if (mode == "auto")
+		return tri ? std::unique_ptr<Port>(new PortMode<Auto<3>>(chemin, bauds))
+			: std::unique_ptr<Port>(new PortMode<Auto<1>>(chemin, bauds));
+	return nullptr;
+}
+
+// Une boucle epoll et ses ports ; le thread principal la réveille par eventfd pour l'arrêt
+// et l'affichage des compteurs.
+class Boucle {
+ public:
+	std::vector<std::unique_ptr<Port>> ports;
+	std::atomic<bool> arret{false};
+	std::atomic<bool> stats{false};
+
+	bool demarrer()
+	{
+		epoll_ = epoll_create1(EPOLL_CLOEXEC);
+		minuterie_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+		reveil_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (epoll_ < 0 || minuterie_ < 0 || reveil_ < 0)
+			return false;
+		struct itimerspec s = {{1, 0}, {0, 1}};
+		timerfd_settime(minuterie_, 0, &s, nullptr);
+		// les descripteurs internes sont repérés par un pointeur nul
+		ajouter(minuterie_, nullptr);
+		ajouter(reveil_, nullptr);
+		return true;
+	}
+
+	void reveiller()
+	{
+		uint64_t un = 1;
+		if (write(reveil_, &un, sizeof(un)) < 0)
+			perror("eventfd");
+	}
+
+	void tourner()
+	{
+		struct epoll_event evts[64];
+		while (!arret)
+		{
+			int n = epoll_wait(epoll_, evts, 64, -1);
+			if (n < 0 && errno != EINTR)
+				break;
+			bool interne = false;
+			for (int i = 0; i < n; i++)
+			{
+				Port *p = static_cast<Port *>(evts[i].data.ptr);
+				if (p == nullptr)
+					interne = true;
+				else
+					lire(p, evts[i].events);
+			}
+			if (!silencieux)
+				fflush(stdout);
+			if (interne)
+				traiter_interne();
+		}
+		afficher_stats();
+		for (auto &p : ports)
+			if (p->historique)
+			{
+				p->historique->terminer();
+				p->ecrire_historique();
+			}
+	}
+
+ protected:
+	void ajouter(int fd, Port *p)
+	{
+		struct epoll_event e = {};
+		e.events = EPOLLIN;
+		e.data.ptr = p;
+		epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &e);
+	}
+
+	void lire(Port *p, uint32_t evenements)
+	{
+		uint8_t buff[512];
+		ssize_t n;
+		while ((n = read(p->fd, buff, sizeof(buff))) > 0)
+			p->pousser(buff, n);
+		// pseudo-terminal sans écrivain ou adaptateur débranché : EIO ou EPOLLHUP
+		if ((n < 0 && errno != EAGAIN && errno != EINTR) || (n <= 0 && (evenements & (EPOLLHUP | EPOLLERR))))
+			fermer(p);
+	}
+
+	void fermer(Port *p)
+	{
+		fprintf(stderr, "%s fermé\n", p->chemin.c_str());
+		epoll_ctl(epoll_, EPOLL_CTL_DEL, p->fd, nullptr);
+		close(p->fd);
+		p->fd = -1;
+	}
+
+	void traiter_interne()
+	{
+		uint64_t v;
+		if (read(minuterie_, &v, sizeof(v)) == sizeof(v))
+			reouvrir();
+		if (read(reveil_, &v, sizeof(v)) == sizeof(v) && stats.exchange(false))
+			afficher_stats();
+	}
+
+	void reouvrir()
+	{
+		for (auto &p : ports)
+		{
+			if (p->fd >= 0)
+				continue;
+			p->fd = ouvrir_liaison(p->chemin.c_str(), p->bauds);
+			if (p->fd < 0)
+				continue;
+			fprintf(stderr, "%s ouvert à %u bauds\n", p->chemin.c_str(), p->bauds);
+			ajouter(p->fd, p.get());
+		}
+	}
+
+	void afficher_stats()
+	{
+		for (auto &p : ports)
+		{
+			const Statistiques &s = p->stats();
+			fprintf(stderr, "%s : %u octets, %u trames, %u groupes, %u checksum, %u format, %u débordements, "
+				"%u interruptions\n", p->chemin.c_str(), s.octets, s.trames, s.groupes, s.erreurs_checksum,
+				s.erreurs_format, s.debordements, s.interruptions);
+		}
+	}
+
+	int epoll_ = -1;
+	int minuterie_ = -1;
+	int reveil_ = -1;
+};
+
+// DOSSIER/dev_ttyUSB0.tcol pour /dev/ttyUSB0 ; un fichier existant est complété s'il a les
+// mêmes colonnes, après avoir retiré le bloc incomplet laissé par un arrêt brutal
+static bool ouvrir_historique(Port &p, const char *dossier)
+{
+	std::string nom = p.chemin.substr(p.chemin.find_first_not_of('/'));
+	std::replace(nom.begin(), nom.end(), '/', '_');
+	std::string fichier = std::string(dossier) + "/" + nom + ".tcol";
+	int fd = open(fichier.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+	if (fd < 0)
+	{
+		perror(fichier.c_str());
+		return false;
+	}
+	colonnes::EnteteFichier e;
+	ssize_t n = pread(fd, &e, sizeof(e), 0);
+	off_t fin = 0;
+	if (n == 0)
+	{
+		std::string entete;
+		colonnes::entete(entete, p.etiquettes);
+		if (!ecrire_tout(fd, entete.data(), entete.size()))
+		{
+			perror(fichier.c_str());
+			close(fd);
+			return false;
+		}
+		fin = entete.size();
+	}
+	else if (n != sizeof(e) || e.magie != colonnes::MAGIE || e.version != colonnes::VERSION
+		|| e.etiquettes != p.etiquettes)
+	{
+		fprintf(stderr, "%s : autre format ou autre mode de compteur\n", fichier.c_str());
+		close(fd);
+		return false;
+	}
+	else
+	{
+		// blocs complets : les ajouts suivants commencent juste après le dernier
+		colonnes::Fichier existant;
+		colonnes::Fichier::Bloc b;
+		if (existant.ouvrir(fichier.c_str()))
+			while (existant.suivant(b))
+				;
+		fin = existant.position();
+		if (fin < (off_t) sizeof(e))
+			fin = sizeof(e);
+		if ((size_t) fin < existant.taille())
+		{
+			fprintf(stderr, "%s : bloc incomplet retiré (%zu octets)\n", fichier.c_str(), existant.taille() - fin);
+			if (ftruncate(fd, fin) != 0)
+			{
+				perror(fichier.c_str());
+				close(fd);
+				return false;
+			}
+		}
+	}
+	p.fd_historique = fd;
+	p.fin_historique = fin;
+	p.historique.reset(new colonnes::Ecrivain(p.etiquettes, 1024));
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	int c;
+	int nb_boucles = 1;
+	const char *region = nullptr;
+	const char *dossier = nullptr;
+	while ((c = getopt(argc, argv, "qj:s:c:")) != -1)
+	{
+		switch (c)
+		{
+			case 'q': silencieux = true; break;
+			case 'j': nb_boucles = atoi(optarg); break;
+			case 's': region = optarg; break;
+			case 'c': dossier = optarg; break;
+			default: return 2;
+		}
+	}
+	if (optind == argc || nb_boucles < 1)
+	{
+		fprintf(stderr, "usage : %s [-q] [-j boucles] [-s region] [-c dossier] CHEMIN[,historic|standard|auto[,1|3[,1200|9600]]]...\n", argv[0]);
+		return 2;
+	}
+	nb_boucles = std::min(nb_boucles, argc - optind);
+
+	// ports répartis à tour de rôle entre les boucles
+	std::vector<std::unique_ptr<Boucle>> boucles;
+	for (int i = 0; i < nb_boucles; i++)
+		boucles.emplace_back(new Boucle);
+	for (int i = optind; i < argc; i++)
+	{
+		std::unique_ptr<Port> p = creer_port(argv[i]);
+		if (!p)
+		{
+			fprintf(stderr, "port invalide : %s\n", argv[i]);
+			return 2;
+		}
+		if (dossier != nullptr && !ouvrir_historique(*p, dossier))
+			return 1;
+		boucles[(i - optind) % nb_boucles]->ports.push_back(std::move(p));
+	}
+
+	if (region != nullptr)
+	{
+		RegionTic *r = creer_region(region, argc - optind);
+		if (r == nullptr)
+		{
+			perror(region);
+			return 1;
+		}
+		// emplacements dans l'ordre des ports de la ligne de commande
+		for (int i = 0; i < argc - optind; i++)
+		{
+			Port *p = boucles[i % nb_boucles]->ports[i / nb_boucles].get();
+			snprintf(r->compteurs[i].port, sizeof(r->compteurs[i].port), "%s", p->chemin.c_str());
+			p->emplacement = &r->compteurs[i];
+		}
+	}
+
+	// signaux bloqués avant de créer les threads : seul le thread principal les reçoit
+	sigset_t signaux;
+	sigemptyset(&signaux);
+	sigaddset(&signaux, SIGINT);
+	sigaddset(&signaux, SIGTERM);
+	sigaddset(&signaux, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &signaux, nullptr);
+
+	std::vector<std::thread> threads;
+	for (auto &b : boucles)
+	{
+		if (!b->demarrer())
+		{
+			perror("epoll");
+			return 1;
+		}
+		threads.emplace_back(&Boucle::tourner, b.get());
+	}
+
+	int signal;
+	while (sigwait(&signaux, &signal) == 0 && signal == SIGUSR1)
+		for (auto &b : boucles)
+		{
+			b->stats = true;
+			b->reveiller();
+		}
+	for (auto &b : boucles)
+	{
+		b->arret = true;
+		b->reveiller();
+	}
+	for (auto &t : threads)
+		t.join();
+	if (region != nullptr)
+		shm_unlink(region);
+	return 0;
+}
@@ -0,0 +1,223 @@
+// Montée en charge de ticd : N compteurs simulés sur N pseudo-terminaux.
+//
+//   g++ -O2 -std=c++17 -I components/tic -I tools tools/ticd_bench.cpp -o ticd_bench
+//   ./ticd_bench -t ./ticd 1 10 100 500
+//
+// Pour chaque N, le banc ouvre N pseudo-terminaux, lance « ticd -q » dessus et y écrit les trames
+// de tic_synth.h au débit de chaque liaison (un compteur sur quatre en standard triphasé à 9600
+// bauds, les autres en historique à 1200 bauds), éventuellement accéléré. À la fin de chaque
+// palier, il relève le temps CPU consommé par ticd (wait4) et les trames décodées (compteurs
+// affichés par ticd à l'arrêt), et affiche le coût par port : il doit rester constant quand N
+// augmente si la boucle passe à l'échelle linéairement.
+//
+// options :
+//   -t CHEMIN   exécutable ticd (./ticd)
+//   -j N        boucles epoll de ticd (1)
+//   -x FACTEUR  accélération des liaisons (1)
+//   -d SECONDES durée de chaque palier (10)
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <pty.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+#include "tic_synth.h"
+
+struct Compteur {
+	int maitre = -1;
+	std::string esclave;
+	bool standard = false;
+	synth::Generateur gen;
+	std::string flux;
+	size_t envoye = 0;		// octets de flux déjà écrits
+	double credit = 0;		// octets à écrire selon le débit
+	uint64_t trames = 0;	// ETX écrits
+	uint64_t perdus = 0;	// octets refusés (pseudo-terminal plein)
+
+	explicit Compteur(const synth::Profil &p) : standard(p.standard), gen(p) {}
+};
+
+static double maintenant()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void ecrire(Compteur &c, double secondes, double acceleration)
+{
+	c.credit += secondes * acceleration * c.gen.bauds() / 10;
+	size_t n = static_cast<size_t>(c.credit);
+	if (n == 0)
+		return;
+	c.credit -= n;
+	while (c.flux.size() - c.envoye < n)
+		c.flux += c.gen.trame();
+	ssize_t ecrits = write(c.maitre, c.flux.data() + c.envoye, n);
+	if (ecrits < 0)
+		ecrits = 0;
+	c.perdus += n - ecrits;
+	c.trames += std::count(c.flux.begin() + c.envoye, c.flux.begin() + c.envoye + ecrits, '\x03');
+	// les octets refusés sont perdus, comme sur une liaison série
+	c.envoye += n;
+	if (c.envoye > 65536)
+	{
+		c.flux.erase(0, c.envoye);
+		c.envoye = 0;
+	}
+}
+
+static bool palier(size_t nb, const char *ticd, int boucles, double acceleration, double duree)
+{
+	std::vector<Compteur> compteurs;
+	compteurs.reserve(nb);
+	for (size_t i = 0; i < nb; i++)
+	{
+		synth::Profil p;
+		p.graine = i + 1;
+		p.option = static_cast<synth::Option>(i % 4);
+		if (i % 4 == 3)
+		{
+			p.standard = true;
+			p.phases = 3;
+		}
+		compteurs.emplace_back(p);
+		Compteur &c = compteurs.back();
+		int esclave;
+		char nom[64];
+		if (openpty(&c.maitre, &esclave, nom, nullptr, nullptr) < 0)
+		{
+			perror("openpty");
+			return false;
+		}
+		struct termios t;
+		tcgetattr(esclave, &t);
+		cfmakeraw(&t);
+		tcsetattr(esclave, TCSANOW, &t);
+		close(esclave);
+		fcntl(c.maitre, F_SETFL, O_NONBLOCK);
+		c.esclave = std::string(nom) + (c.standard ? ",standard,3" : "");
+	}
+
+	int erreurs[2];
+	if (pipe(erreurs) < 0)
+		return false;
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		dup2(erreurs[1], STDERR_FILENO);
+		close(erreurs[0]);
+		std::vector<std::string> args = {ticd, "-q", "-j", std::to_string(boucles)};
+		for (Compteur &c : compteurs)
+			args.push_back(c.esclave);
+		std::vector<char *> argv;
+		for (std::string &a : args)
+			argv.push_back(&a[0]);
+		argv.push_back(nullptr);
+		execv(ticd, argv.data());
+		perror(ticd);
+		_exit(127);
+	}
+	close(erreurs[1]);
+
+	// ticd ouvre les ports à son démarrage
+	usleep(300000);
+	const double debut = maintenant();
+	double precedent = debut;
+	while (maintenant() - debut < duree)
+	{
+		usleep(10000);
+		double t = maintenant();
+		for (Compteur &c : compteurs)
+			ecrire(c, t - precedent, acceleration);
+		precedent = t;
+	}
+	// dernières trames en cours de décodage
+	usleep(200000);
+
+	kill(pid, SIGTERM);
+	std::string sortie;
+	char buff[4096];
+	ssize_t n;
+	while ((n = read(erreurs[0], buff, sizeof(buff))) > 0)
+		sortie.append(buff, n);
+	close(erreurs[0]);
+	int statut;
+	struct rusage usage;
+	wait4(pid, &statut, 0, &usage);
+	for (Compteur &c : compteurs)
+		close(c.maitre);
+
+	uint64_t envoyees = 0, perdus = 0, recues = 0, erreurs_checksum = 0;
+	for (Compteur &c : compteurs)
+	{
+		envoyees += c.trames;
+		perdus += c.perdus;
+	}
+	for (size_t pos = 0; (pos = sortie.find(" trames, ", pos)) != std::string::npos; pos++)
+	{
+		size_t d = sortie.rfind(", ", pos);
+		recues += strtoull(sortie.c_str() + d + 2, nullptr, 10);
+		size_t g = sortie.find(" groupes, ", pos);
+		erreurs_checksum += strtoull(sortie.c_str() + g + 10, nullptr, 10);
+	}
+
+	double cpu = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+	printf("%5zu %10llu %10llu %8llu %8llu %9.2f %12.1f\n", nb, (unsigned long long) envoyees,
+		(unsigned long long) recues, (unsigned long long) erreurs_checksum, (unsigned long long) perdus,
+		100 * cpu / duree, 1e6 * cpu / duree / nb);
+	fflush(stdout);
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	const char *ticd = "./ticd";
+	int boucles = 1;
+	double acceleration = 1;
+	double duree = 10;
+	int c;
+	while ((c = getopt(argc, argv, "t:j:x:d:")) != -1)
+	{
+		switch (c)
+		{
+			case 't': ticd = optarg; break;
+			case 'j': boucles = atoi(optarg); break;
+			case 'x': acceleration = atof(optarg); break;
+			case 'd': duree = atof(optarg); break;
+			default:
+				fprintf(stderr, "usage : %s [-t ticd] [-j boucles] [-x facteur] [-d s] N...\n", argv[0]);
+				return 2;
+		}
+	}
+	std::vector<size_t> paliers;
+	for (int i = optind; i < argc; i++)
+		paliers.push_back(atoi(argv[i]));
+	if (paliers.empty())
+		paliers = {1, 10, 50, 100, 200, 500};
+
+	// deux descripteurs par compteur (pseudo-terminal ici, port ouvert par ticd)
+	struct rlimit limite;
+	getrlimit(RLIMIT_NOFILE, &limite);
+	limite.rlim_cur = limite.rlim_max;
+	setrlimit(RLIMIT_NOFILE, &limite);
+	signal(SIGPIPE, SIG_IGN);
+
+	printf("%5s %10s %10s %8s %8s %9s %12s\n", "ports", "émises", "décodées", "checksum", "perdus", "CPU %",
+		"µs CPU/port/s");
+	for (size_t n : paliers)
+		if (!palier(n, ticd, boucles, acceleration, duree))
+			return 1;
+	return 0;
+}